@@ -8,8 +8,14 @@
 #define TSOM_CLIENTLIB_CLIENTCHUNKENTITIES_HPP
 
 #include <ClientLib/ClientBlockLibrary.hpp>
+#include <CommonLib/ChunkConnectivity.hpp>
+#include <CommonLib/ChunkDirectionBounds.hpp>
 #include <CommonLib/ChunkEntities.hpp>
+#include <CommonLib/ChunkLod.hpp>
+#include <CommonLib/ChunkMeshCache.hpp>
+#include <CommonLib/ChunkVisibility.hpp>
 #include <Nazara/Core/Color.hpp>
+#include <NazaraUtils/FunctionRef.hpp>
 #include <tsl/hopscotch_map.h>
 
 namespace Nz
@@ -18,44 +24,115 @@ namespace Nz
 	class EnttWorld;
 	class MaterialInstance;
 	class Mesh;
+	class Model;
 	class TaskScheduler;
 	class VertexDeclaration;
 }
 
 namespace tsom
 {
-	struct VertexStruct
-	{
-		Nz::Vector3f position;
-		Nz::Vector3f normal;
-		Nz::Vector3f uvw;
-		Nz::Vector3f tangent;
-	};
-
 	class TSOM_CLIENTLIB_API ClientChunkEntities final : public ChunkEntities
 	{
 		public:
+			struct LevelOfDetailSettings;
+
 			ClientChunkEntities(Nz::ApplicationBase& app, Nz::EnttWorld& world, ChunkContainer& chunkContainer, const ClientBlockLibrary& blockLibrary);
 			ClientChunkEntities(const ClientChunkEntities&) = delete;
 			ClientChunkEntities(ClientChunkEntities&&) = delete;
 			~ClientChunkEntities() = default;
 
+			void EnableDirectionCulling(bool enable);
+			void EnableGreedyMeshing(bool enable);
+			void EnableOcclusionCulling(bool enable);
+
+			inline const LevelOfDetailSettings& GetLevelOfDetailSettings() const;
+			inline std::size_t GetMeshCacheHitCount() const;
+			inline std::size_t GetMeshCacheMissCount() const;
+			inline std::size_t GetOccludedChunkCount() const;
+
+			inline bool IsDirectionCullingEnabled() const;
+			inline bool IsGreedyMeshingEnabled() const;
+			inline bool IsOcclusionCullingEnabled() const;
+
+			void SetLevelOfDetailSettings(const LevelOfDetailSettings& lodSettings);
+			inline void SetMeshCacheCapacity(std::size_t capacity);
+
+			void UpdateDirectionCulling(const Nz::Vector3f& viewerPosition);
+			void UpdateLevelsOfDetail(const Nz::Vector3f& viewerPosition);
+			void UpdateOcclusionCulling(const Nz::Vector3f& viewerPosition);
+
 			ClientChunkEntities& operator=(const ClientChunkEntities&) = delete;
 			ClientChunkEntities& operator=(ClientChunkEntities&&) = delete;
 
+			// Distant chunks are meshed from their downsampled content (see ChunkLod), level N using cells of 2^N blocks
+			struct LevelOfDetailSettings
+			{
+				float distance = 128.f; //< distance from the viewer after which chunks use the first level, doubling for each next level
+				float hysteresis = 8.f; //< distance chunks have to go past a level boundary to change level, so chunks along it aren't remeshed over and over
+				unsigned int maxLevel = ChunkLod::MaxLevel;
+				bool enabled = true;
+			};
+
+			static constexpr std::size_t DefaultMeshCacheCapacity = 256;
+
 		private:
-			struct ColliderModelUpdateJob : UpdateJob
+			// Chunk faces split by direction, so that directions facing away from the camera can be skipped as a whole
+			struct ChunkMesh
+			{
+				Nz::EnumArray<Direction, std::shared_ptr<Nz::Mesh>> directionMeshes; //< null for directions without faces
+				ChunkDirectionBounds directionBounds;
+			};
+
+			// Models of each direction of a chunk, those facing away from the camera are only kept for shadows
+			struct ChunkModels
+			{
+				Nz::EnumArray<Direction, std::shared_ptr<Nz::Model>> models;
+				Nz::EnumArray<Direction, bool> backFacing;
+				ChunkDirectionBounds directionBounds;
+			};
+
+			// CPU-side meshes of recently seen chunk contents (see ChunkEntities::CachedCollider)
+			struct CachedMesh
+			{
+				std::shared_ptr<ChunkMeshCache> meshCache;
+				std::shared_ptr<const ChunkMesh> mesh;
+				ChunkConnectivity connectivity;
+			};
+
+			struct ColliderModelUpdateJob : ColliderUpdateJob
 			{
-				std::shared_ptr<Nz::Collider3D> collider;
-				std::shared_ptr<Nz::Mesh> mesh;
+				std::shared_ptr<const ChunkMeshCache> previousMeshCache;
+				std::shared_ptr<ChunkMeshCache> meshCache;
+				std::shared_ptr<const ChunkMesh> mesh;
+				ChunkConnectivity connectivity;
+				Nz::UInt64 meshKey;
+				unsigned int lodLevel = 0; //< chunks meshed at a lower level of detail have no mesh cache
+				bool meshCacheHit = false;
 			};
 
-			std::shared_ptr<Nz::Mesh> BuildMesh(const Chunk* chunk);
+			std::shared_ptr<const ChunkMesh> BuildChunkMesh(const ChunkDirectionBounds& directionBounds, const Nz::FunctionRef<void(Direction direction, ChunkMeshVertex* vertices)>& copyVertices) const;
+			std::shared_ptr<const ChunkMesh> BuildLodMesh(const Chunk* chunk, const ChunkSnapshot& snapshot, unsigned int lodLevel) const;
+			std::shared_ptr<const ChunkMesh> BuildMesh(const Chunk* chunk, const ChunkSnapshot& snapshot, const ChunkMeshCache* previousMeshCache, ChunkMeshCache& meshCache, const std::atomic_bool& cancelled) const;
+			void DestroyChunkEntity(const ChunkIndices& chunkIndices) override;
 			void HandleChunkUpdate(const ChunkIndices& chunkIndices, const Chunk* chunk) override;
+			void RecycleJob(std::shared_ptr<UpdateJob>&& job) override;
 			void UpdateChunkDebugCollider(const ChunkIndices& chunkIndices);
 
+			tsl::hopscotch_map<ChunkIndices, ChunkConnectivity> m_chunkConnectivities;
+			tsl::hopscotch_map<ChunkIndices, std::shared_ptr<ChunkMeshCache>> m_chunkMeshCaches;
+			tsl::hopscotch_map<ChunkIndices, unsigned int> m_chunkLodLevels; //< chunks meshed at full resolution are not stored
+			tsl::hopscotch_map<ChunkIndices, ChunkModels> m_chunkModels;
+			LruCache<Nz::UInt64, CachedMesh> m_meshCache;
+			SharedObjectPool<ChunkMeshCache> m_meshCachePool;
+			SharedObjectPool<ColliderModelUpdateJob> m_modelJobPool;
 			std::shared_ptr<Nz::MaterialInstance> m_chunkMaterial;
 			std::shared_ptr<Nz::VertexDeclaration> m_chunkVertexDeclaration;
+			std::size_t m_occludedChunkCount;
+			ChunkVisibility m_chunkVisibility;
+			LevelOfDetailSettings m_lodSettings;
+			bool m_directionCulling;
+			bool m_greedyMeshing;
+			bool m_occlusionCulling;
 	};
 }
 
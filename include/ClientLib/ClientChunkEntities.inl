@@ -4,4 +4,43 @@
 
 namespace tsom
 {
+	inline auto ClientChunkEntities::GetLevelOfDetailSettings() const -> const LevelOfDetailSettings&
+	{
+		return m_lodSettings;
+	}
+
+	inline std::size_t ClientChunkEntities::GetMeshCacheHitCount() const
+	{
+		return m_meshCache.GetHitCount();
+	}
+
+	inline std::size_t ClientChunkEntities::GetMeshCacheMissCount() const
+	{
+		return m_meshCache.GetMissCount();
+	}
+
+	inline std::size_t ClientChunkEntities::GetOccludedChunkCount() const
+	{
+		return m_occludedChunkCount;
+	}
+
+	inline bool ClientChunkEntities::IsDirectionCullingEnabled() const
+	{
+		return m_directionCulling;
+	}
+
+	inline bool ClientChunkEntities::IsGreedyMeshingEnabled() const
+	{
+		return m_greedyMeshing;
+	}
+
+	inline bool ClientChunkEntities::IsOcclusionCullingEnabled() const
+	{
+		return m_occlusionCulling;
+	}
+
+	inline void ClientChunkEntities::SetMeshCacheCapacity(std::size_t capacity)
+	{
+		m_meshCache.SetCapacity(capacity);
+	}
 }
@@ -16,6 +16,7 @@ namespace tsom::Constants
 	constexpr Nz::UInt32 RenderMask3D = 0x0000FFFF;
 	constexpr Nz::UInt32 RenderMaskLocalPlayer = 0x00000001;
 	constexpr Nz::UInt32 RenderMaskOtherPlayer = 0x00000002;
+	constexpr Nz::UInt32 RenderMaskBackFacingChunk = 0x00000004; //< chunk faces facing away from the camera, only rendered by lights
 }
 
 #endif // TSOM_CLIENTLIB_RENDERCONSTANTS_HPP
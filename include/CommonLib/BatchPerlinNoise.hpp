@@ -0,0 +1,48 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com) (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_COMMONLIB_BATCHPERLINNOISE_HPP
+#define TSOM_COMMONLIB_BATCHPERLINNOISE_HPP
+
+#include <CommonLib/Export.hpp>
+#include <NazaraUtils/Prerequisites.hpp>
+#include <array>
+#include <span>
+
+namespace tsom
+{
+	// Evaluates siv::PerlinNoise octave noise over whole grids of points at once, giving the exact same results for a given seed
+	class TSOM_COMMONLIB_API BatchPerlinNoise
+	{
+		public:
+			using Permutation = std::array<Nz::UInt8, 256>;
+
+			BatchPerlinNoise();
+			explicit BatchPerlinNoise(Nz::UInt32 seed);
+			inline explicit BatchPerlinNoise(const Permutation& permutation);
+			BatchPerlinNoise(const BatchPerlinNoise&) = default;
+			BatchPerlinNoise(BatchPerlinNoise&&) noexcept = default;
+			~BatchPerlinNoise() = default;
+
+			void ComputeNormalizedOctave2D(std::span<const double> xValues, std::span<const double> yValues, Nz::UInt32 octaves, double* results, double persistence = 0.5) const;
+
+			inline const Permutation& GetPermutation() const;
+
+			void Reseed(Nz::UInt32 seed);
+
+			BatchPerlinNoise& operator=(const BatchPerlinNoise&) = default;
+			BatchPerlinNoise& operator=(BatchPerlinNoise&&) noexcept = default;
+
+			static constexpr std::size_t LaneCount = 8;
+
+		private:
+			Permutation m_permutation;
+	};
+}
+
+#include <CommonLib/BatchPerlinNoise.inl>
+
+#endif // TSOM_COMMONLIB_BATCHPERLINNOISE_HPP
@@ -0,0 +1,80 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_COMMONLIB_BLOCKSTORAGE_HPP
+#define TSOM_COMMONLIB_BLOCKSTORAGE_HPP
+
+#include <CommonLib/Export.hpp>
+#include <CommonLib/BlockIndex.hpp>
+#include <vector>
+
+namespace tsom
+{
+	// Palette-compressed block storage, each block is stored as an index in a palette of used block types
+	// using the smallest bit width (1/2/4/8/16 bits per block) able to address the palette
+	// uniform storages (a single block type) use 0 bits per block and don't allocate any block data until a different block is set
+	class TSOM_COMMONLIB_API BlockStorage
+	{
+		public:
+			struct PaletteEntry;
+
+			BlockStorage(std::size_t blockCount, BlockIndex initialBlock = EmptyBlockIndex);
+			BlockStorage(const BlockStorage&) = default;
+			BlockStorage(BlockStorage&&) noexcept = default;
+			~BlockStorage() = default;
+
+			Nz::UInt64 ComputeContentHash() const;
+
+			void Fill(BlockIndex blockIndex);
+
+			inline unsigned int GetBitsPerBlock() const;
+			inline BlockIndex GetBlock(std::size_t index) const;
+			inline std::size_t GetBlockCount() const;
+			inline std::size_t GetBlockTypeCount(BlockIndex blockIndex) const;
+			inline std::size_t GetMemoryUsage() const;
+			inline const std::vector<PaletteEntry>& GetPalette() const;
+			inline std::size_t GetUsedPaletteEntryCount() const;
+
+			inline bool IsUniform() const;
+
+			void Load(const BlockIndex* blocks);
+
+			void Store(BlockIndex* blocks) const;
+
+			BlockIndex UpdateBlock(std::size_t index, BlockIndex blockIndex);
+
+			BlockStorage& operator=(const BlockStorage&) = default;
+			BlockStorage& operator=(BlockStorage&&) noexcept = default;
+
+			struct PaletteEntry
+			{
+				BlockIndex blockIndex;
+				Nz::UInt32 count; //< unused entries (count == 0) can be reused
+			};
+
+			static constexpr unsigned int MaxBitsPerBlock = 16;
+
+		private:
+			Nz::UInt32 AcquirePaletteIndex(BlockIndex blockIndex);
+			inline Nz::UInt32 GetPaletteIndex(std::size_t index) const;
+			void Repack(unsigned int bitsPerBlock);
+			void ResetWords(unsigned int bitsPerBlock);
+			inline void SetPaletteIndex(std::size_t index, Nz::UInt32 paletteIndex);
+
+			static unsigned int ComputeBitsPerBlock(std::size_t paletteSize);
+
+			std::size_t m_blockCount;
+			std::size_t m_usedPaletteEntryCount;
+			std::vector<Nz::UInt64> m_words;
+			std::vector<PaletteEntry> m_palette;
+			unsigned int m_bitsPerBlock;
+			unsigned int m_bitsPerBlockLog2;
+	};
+}
+
+#include <CommonLib/BlockStorage.inl>
+
+#endif // TSOM_COMMONLIB_BLOCKSTORAGE_HPP
@@ -0,0 +1,82 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <cassert>
+
+namespace tsom
+{
+	inline unsigned int BlockStorage::GetBitsPerBlock() const
+	{
+		return m_bitsPerBlock;
+	}
+
+	inline BlockIndex BlockStorage::GetBlock(std::size_t index) const
+	{
+		return m_palette[GetPaletteIndex(index)].blockIndex;
+	}
+
+	inline std::size_t BlockStorage::GetBlockCount() const
+	{
+		return m_blockCount;
+	}
+
+	inline std::size_t BlockStorage::GetBlockTypeCount(BlockIndex blockIndex) const
+	{
+		for (const PaletteEntry& entry : m_palette)
+		{
+			if (entry.blockIndex == blockIndex)
+				return entry.count;
+		}
+
+		return 0;
+	}
+
+	inline std::size_t BlockStorage::GetMemoryUsage() const
+	{
+		return sizeof(*this) + m_words.capacity() * sizeof(Nz::UInt64) + m_palette.capacity() * sizeof(PaletteEntry);
+	}
+
+	inline auto BlockStorage::GetPalette() const -> const std::vector<PaletteEntry>&
+	{
+		return m_palette;
+	}
+
+	inline std::size_t BlockStorage::GetUsedPaletteEntryCount() const
+	{
+		return m_usedPaletteEntryCount;
+	}
+
+	inline bool BlockStorage::IsUniform() const
+	{
+		return m_bitsPerBlock == 0;
+	}
+
+	inline Nz::UInt32 BlockStorage::GetPaletteIndex(std::size_t index) const
+	{
+		assert(index < m_blockCount);
+		if (m_bitsPerBlock == 0)
+			return 0;
+
+		// bits per block is always a power of two dividing 64, so blocks never straddle two words
+		std::size_t wordIndex = index >> (6 - m_bitsPerBlockLog2);
+		unsigned int bitOffset = static_cast<unsigned int>(index & ((64 >> m_bitsPerBlockLog2) - 1)) << m_bitsPerBlockLog2;
+		Nz::UInt64 mask = (Nz::UInt64(1) << m_bitsPerBlock) - 1;
+
+		return static_cast<Nz::UInt32>((m_words[wordIndex] >> bitOffset) & mask);
+	}
+
+	inline void BlockStorage::SetPaletteIndex(std::size_t index, Nz::UInt32 paletteIndex)
+	{
+		assert(index < m_blockCount);
+		assert(m_bitsPerBlock > 0);
+		assert(paletteIndex < (Nz::UInt32(1) << m_bitsPerBlock));
+
+		std::size_t wordIndex = index >> (6 - m_bitsPerBlockLog2);
+		unsigned int bitOffset = static_cast<unsigned int>(index & ((64 >> m_bitsPerBlockLog2) - 1)) << m_bitsPerBlockLog2;
+		Nz::UInt64 mask = (Nz::UInt64(1) << m_bitsPerBlock) - 1;
+
+		Nz::UInt64& word = m_words[wordIndex];
+		word = (word & ~(mask << bitOffset)) | (Nz::UInt64(paletteIndex) << bitOffset);
+	}
+}
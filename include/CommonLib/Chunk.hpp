@@ -9,6 +9,8 @@
 
 #include <CommonLib/Export.hpp>
 #include <CommonLib/BlockIndex.hpp>
+#include <CommonLib/BlockStorage.hpp>
+#include <CommonLib/ChunkSnapshot.hpp>
 #include <CommonLib/Direction.hpp>
 #include <Nazara/Core/Color.hpp>
 #include <Nazara/Math/Matrix4.hpp>
@@ -17,9 +19,11 @@
 #include <NazaraUtils/FunctionRef.hpp>
 #include <NazaraUtils/Signal.hpp>
 #include <NazaraUtils/SparsePtr.hpp>
+#include <array>
 #include <memory>
 #include <optional>
 #include <shared_mutex>
+#include <span>
 #include <vector>
 
 namespace Nz
@@ -40,6 +44,8 @@ namespace tsom
 	class TSOM_COMMONLIB_API Chunk
 	{
 		public:
+			struct BlockUpdate;
+			struct ColliderSettings;
 			struct VertexAttributes;
 
 			inline Chunk(ChunkContainer& owner, const ChunkIndices& indices, const Nz::Vector3ui& size, float blockSize);
@@ -47,46 +53,103 @@ namespace tsom
 			Chunk(Chunk&&) = delete;
 			virtual ~Chunk();
 
-			virtual std::shared_ptr<Nz::Collider3D> BuildCollider(const BlockLibrary& blockManager) const = 0;
-			virtual void BuildMesh(const BlockLibrary& blockManager, std::vector<Nz::UInt32>& indices, const Nz::Vector3f& center, const Nz::FunctionRef<VertexAttributes(Nz::UInt32 count)>& addVertices) const;
+			inline std::shared_ptr<Nz::Collider3D> BuildCollider(const BlockLibrary& blockManager, const ChunkSnapshot& snapshot, const ColliderSettings& settings) const;
+			virtual std::shared_ptr<Nz::Collider3D> BuildCollider(const BlockLibrary& blockManager, const ChunkSnapshot& snapshot, const Nz::Boxui& blocks, const ColliderSettings& settings) const = 0;
+			virtual void BuildGreedyMesh(const BlockLibrary& blockManager, const ChunkSnapshot& snapshot, const Nz::Boxui& blocks, std::vector<Nz::UInt32>& indices, const Nz::Vector3f& center, const Nz::FunctionRef<VertexAttributes(Nz::UInt32 count)>& addVertices) const;
+			inline void BuildMesh(const BlockLibrary& blockManager, const ChunkSnapshot& snapshot, std::vector<Nz::UInt32>& indices, const Nz::Vector3f& center, const Nz::FunctionRef<VertexAttributes(Nz::UInt32 count)>& addVertices) const;
+			virtual void BuildMesh(const BlockLibrary& blockManager, const ChunkSnapshot& snapshot, const Nz::Boxui& blocks, std::vector<Nz::UInt32>& indices, const Nz::Vector3f& center, const Nz::FunctionRef<VertexAttributes(Nz::UInt32 count)>& addVertices) const;
 
 			virtual std::optional<Nz::Vector3ui> ComputeCoordinates(const Nz::Vector3f& position) const = 0;
+			virtual Nz::UInt64 ComputeGeometryHash() const;
 			virtual Nz::EnumArray<Nz::BoxCorner, Nz::Vector3f> ComputeVoxelCorners(const Nz::Vector3ui& indices) const = 0;
 
-			inline const Nz::Bitset<Nz::UInt64>& GetCollisionCellMask() const;
+			inline void CopyContent(BlockIndex* blocks) const;
+
+			void Fill(BlockIndex blockIndex);
+
 			inline unsigned int GetBlockLocalIndex(const Nz::Vector3ui& indices) const;
 			inline Nz::Vector3ui GetBlockLocalIndices(unsigned int blockIndex) const;
 			inline BlockIndex GetBlockContent(unsigned int blockIndex) const;
 			inline BlockIndex GetBlockContent(const Nz::Vector3ui& indices) const;
 			inline std::size_t GetBlockCount() const;
 			inline float GetBlockSize() const;
+			inline const BlockStorage& GetBlockStorage() const;
 			inline ChunkContainer& GetContainer();
 			inline const ChunkContainer& GetContainer() const;
-			inline const BlockIndex* GetContent() const;
+			inline Nz::UInt64 GetContentVersion() const;
 			inline const ChunkIndices& GetIndices() const;
 			inline std::optional<BlockIndex> GetNeighborBlock(Nz::Vector3ui indices, const Nz::Vector3i& offsets) const;
+			inline Chunk* GetNeighborChunk(Direction direction);
+			inline const Chunk* GetNeighborChunk(Direction direction) const;
+			inline const ChunkOccupancy& GetOccupancy() const;
 			inline const Nz::Vector3ui& GetSize() const;
 
+			inline bool IsEmpty() const;
+			inline bool IsUniform() const;
+
 			inline void LockRead() const;
 			inline void LockWrite();
 
 			template<typename F> void Reset(F&& func);
 
 			virtual void Serialize(const BlockLibrary& blockLibrary, Nz::ByteStream& byteStream);
+			inline void SetNeighborChunk(Direction direction, Chunk* neighbor);
+
+			ChunkSnapshot TakeSnapshot() const;
 
 			inline void UnlockRead() const;
 			inline void UnlockWrite();
 
 			inline void UpdateBlock(const Nz::Vector3ui& indices, BlockIndex cellType);
+			void UpdateBlocks(std::span<const BlockUpdate> updates);
 
 			virtual void Unserialize(const BlockLibrary& blockLibrary, Nz::ByteStream& byteStream);
 
 			Chunk& operator=(const Chunk&) = delete;
 			Chunk& operator=(Chunk&&) = delete;
 
-			NazaraSignal(OnBlockUpdated, Chunk* /*emitter*/, const Nz::Vector3ui& /*indices*/, BlockIndex /*newBlock*/);
+			NazaraSignal(OnBlocksUpdated, Chunk* /*emitter*/, std::span<const BlockUpdate> /*updates*/);
 			NazaraSignal(OnReset, Chunk* /*emitter*/);
 
+			// Whether blocks are axis-aligned cubes, which allows meshing them using constant tables
+			static constexpr bool HasAxisAlignedBlocks = false;
+
+			// Offset of each block corner in block indices (block (x, y, z) spans from (x, z, y) to (x + 1, z + 1, y + 1))
+			static constexpr Nz::EnumArray<Nz::BoxCorner, Nz::Vector3ui> s_cornerOffsets = {
+				Nz::Vector3ui(0, 0, 0), //< FarLeftBottom
+				Nz::Vector3ui(0, 0, 1), //< FarLeftTop
+				Nz::Vector3ui(1, 0, 0), //< FarRightBottom
+				Nz::Vector3ui(1, 0, 1), //< FarRightTop
+				Nz::Vector3ui(0, 1, 0), //< NearLeftBottom
+				Nz::Vector3ui(0, 1, 1), //< NearLeftTop
+				Nz::Vector3ui(1, 1, 0), //< NearRightBottom
+				Nz::Vector3ui(1, 1, 1), //< NearRightTop
+			};
+
+			// Block corners making up the face of each direction
+			static constexpr Nz::EnumArray<Direction, std::array<Nz::BoxCorner, 4>> s_faceCorners = {
+				std::array{ Nz::BoxCorner::NearLeftTop,    Nz::BoxCorner::NearRightTop,   Nz::BoxCorner::NearLeftBottom,  Nz::BoxCorner::NearRightBottom }, //< Back
+				std::array{ Nz::BoxCorner::FarRightBottom, Nz::BoxCorner::FarLeftBottom,  Nz::BoxCorner::NearRightBottom, Nz::BoxCorner::NearLeftBottom },  //< Down
+				std::array{ Nz::BoxCorner::FarRightTop,    Nz::BoxCorner::FarLeftTop,     Nz::BoxCorner::FarRightBottom,  Nz::BoxCorner::FarLeftBottom },   //< Front
+				std::array{ Nz::BoxCorner::FarLeftTop,     Nz::BoxCorner::NearLeftTop,    Nz::BoxCorner::FarLeftBottom,   Nz::BoxCorner::NearLeftBottom },  //< Left
+				std::array{ Nz::BoxCorner::NearRightTop,   Nz::BoxCorner::FarRightTop,    Nz::BoxCorner::NearRightBottom, Nz::BoxCorner::FarRightBottom },  //< Right
+				std::array{ Nz::BoxCorner::FarLeftTop,     Nz::BoxCorner::FarRightTop,    Nz::BoxCorner::NearLeftTop,     Nz::BoxCorner::NearRightTop },    //< Up
+			};
+
+			struct BlockUpdate
+			{
+				Nz::Vector3ui indices;
+				BlockIndex newBlock;
+			};
+
+			struct ColliderSettings
+			{
+				unsigned int shellThickness = 2; //< layers of solid blocks kept under exposed faces, when surfaceOnly is set
+				bool surfaceOnly = false; //< skip buried blocks no body can touch
+
+				bool operator==(const ColliderSettings&) const = default;
+			};
+
 			struct VertexAttributes
 			{
 				Nz::UInt32 firstIndex;
@@ -98,12 +161,15 @@ namespace tsom
 			};
 
 		protected:
+			ChunkContent& GetWritableContent();
 			void OnChunkReset();
 
+			static void DrawFace(const BlockLibrary& blockManager, std::vector<Nz::UInt32>& indices, const Nz::FunctionRef<VertexAttributes(Nz::UInt32 count)>& addVertices, BlockIndex blockIndex, Direction upDirection, const Nz::Vector3f& blockCenter, const std::array<Nz::Vector3f, 4>& pos);
+			static Nz::UInt64 GenerateContentVersion();
+
 			mutable std::shared_mutex m_mutex;
-			std::vector<BlockIndex> m_blocks;
-			std::vector<Nz::UInt16> m_blockTypeCount;
-			Nz::Bitset<Nz::UInt64> m_collisionCellMask;
+			std::shared_ptr<ChunkContent> m_content;
+			Nz::EnumArray<Direction, Chunk*> m_neighbors;
 			Nz::Vector3ui m_size;
 			ChunkContainer& m_owner;
 			ChunkIndices m_indices;
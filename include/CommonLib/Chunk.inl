@@ -8,20 +8,28 @@
 namespace tsom
 {
 	inline Chunk::Chunk(ChunkContainer& owner, const ChunkIndices& indices, const Nz::Vector3ui& size, float cellSize) :
-	m_blocks(size.x * size.y * size.z, EmptyBlockIndex),
-	m_collisionCellMask(m_blocks.size(), false),
+	m_content(std::make_shared<ChunkContent>(size, GenerateContentVersion())),
 	m_indices(indices),
 	m_size(size),
 	m_owner(owner),
 	m_blockSize(cellSize)
 	{
-		m_blockTypeCount.resize(EmptyBlockIndex + 1);
-		m_blockTypeCount[EmptyBlockIndex] = m_blocks.size();
+		m_neighbors.fill(nullptr);
 	}
 
-	inline const Nz::Bitset<Nz::UInt64>& Chunk::GetCollisionCellMask() const
+	inline std::shared_ptr<Nz::Collider3D> Chunk::BuildCollider(const BlockLibrary& blockManager, const ChunkSnapshot& snapshot, const ColliderSettings& settings) const
 	{
-		return m_collisionCellMask;
+		return BuildCollider(blockManager, snapshot, Nz::Boxui(Nz::Vector3ui::Zero(), m_size), settings);
+	}
+
+	inline void Chunk::BuildMesh(const BlockLibrary& blockManager, const ChunkSnapshot& snapshot, std::vector<Nz::UInt32>& indices, const Nz::Vector3f& center, const Nz::FunctionRef<VertexAttributes(Nz::UInt32 count)>& addVertices) const
+	{
+		BuildMesh(blockManager, snapshot, Nz::Boxui(Nz::Vector3ui::Zero(), m_size), indices, center, addVertices);
+	}
+
+	inline void Chunk::CopyContent(BlockIndex* blocks) const
+	{
+		m_content->blocks.Store(blocks);
 	}
 
 	inline unsigned int Chunk::GetBlockLocalIndex(const Nz::Vector3ui& indices) const
@@ -45,7 +53,7 @@ namespace tsom
 
 	inline BlockIndex Chunk::GetBlockContent(unsigned int blockIndex) const
 	{
-		return m_blocks[blockIndex];
+		return m_content->blocks.GetBlock(blockIndex);
 	}
 
 	inline BlockIndex Chunk::GetBlockContent(const Nz::Vector3ui& indices) const
@@ -55,7 +63,7 @@ namespace tsom
 
 	inline std::size_t Chunk::GetBlockCount() const
 	{
-		return m_blocks.size();
+		return m_content->blocks.GetBlockCount();
 	}
 
 	inline float Chunk::GetBlockSize() const
@@ -63,6 +71,11 @@ namespace tsom
 		return m_blockSize;
 	}
 
+	inline const BlockStorage& Chunk::GetBlockStorage() const
+	{
+		return m_content->blocks;
+	}
+
 	inline ChunkContainer& Chunk::GetContainer()
 	{
 		return m_owner;
@@ -73,90 +86,61 @@ namespace tsom
 		return m_owner;
 	}
 
-	inline const BlockIndex* Chunk::GetContent() const
+	inline Nz::UInt64 Chunk::GetContentVersion() const
 	{
-		return m_blocks.data();
+		return m_content->version;
 	}
 
 	inline std::optional<BlockIndex> Chunk::GetNeighborBlock(Nz::Vector3ui indices, const Nz::Vector3i& offsets) const
 	{
+		// Walk through neighbor chunks (which all have the same size) when going out of bounds
 		const Chunk* currentChunk = this;
-		if (offsets.x < 0)
-		{
-			unsigned int offset = std::abs(offsets.x);
-			if (offset > indices.x)
-				return {};
-
-			indices.x -= offset;
-		}
-		else
+		auto MoveAlongAxis = [&](unsigned int& index, int offset, unsigned int size, Direction negativeDir, Direction positiveDir)
 		{
-			indices.x += offsets.x;
-			if (indices.x >= m_size.x)
-				return {};
-		}
+			int newIndex = static_cast<int>(index) + offset;
+			while (newIndex < 0)
+			{
+				currentChunk = currentChunk->m_neighbors[negativeDir];
+				if (!currentChunk)
+					return false;
 
-		if (offsets.y < 0)
-		{
-			unsigned int offset = std::abs(offsets.y);
-			if (offset > indices.y)
-				return {};
+				newIndex += static_cast<int>(size);
+			}
 
-			indices.y -= offset;
-		}
-		else
-		{
-			indices.y += offsets.y;
-			if (indices.y >= m_size.y)
-				return {};
-		}
-
-		if (offsets.z < 0)
-		{
-			unsigned int offset = std::abs(offsets.z);
-			if (offset > indices.z)
-				return {};
+			while (newIndex >= static_cast<int>(size))
+			{
+				currentChunk = currentChunk->m_neighbors[positiveDir];
+				if (!currentChunk)
+					return false;
 
-			indices.z -= offset;
-		}
-		else
-		{
-			indices.z += offsets.z;
-			if (indices.z >= m_size.z)
-				return {};
-		}
+				newIndex -= static_cast<int>(size);
+			}
 
-		/*while (offsets.z > 0)
-		{
-			const NeighborGrid& neighborGrid = m_neighborGrids[Direction::Up];
-			if (!neighborGrid.grid)
-				return {};
+			index = static_cast<unsigned int>(newIndex);
+			return true;
+		};
 
-			currentChunk = neighborGrid.grid;
-			x += neighborGrid.offsets.x;
-			y += neighborGrid.offsets.y;
-			if (x >= currentChunk->GetWidth() || y >= currentChunk->GetHeight())
-				return {};
+		// Local Y and Z axis are swapped compared to chunk directions
+		if (!MoveAlongAxis(indices.x, offsets.x, m_size.x, Direction::Left, Direction::Right))
+			return {};
 
-			offsets.z--;
-		}
+		if (!MoveAlongAxis(indices.y, offsets.y, m_size.y, Direction::Front, Direction::Back))
+			return {};
 
-		while (offsets.z < 0)
-		{
-			const NeighborGrid& neighborGrid = m_neighborGrids[Direction::Down];
-			if (!neighborGrid.grid)
-				return {};
+		if (!MoveAlongAxis(indices.z, offsets.z, m_size.z, Direction::Down, Direction::Up))
+			return {};
 
-			currentChunk = neighborGrid.grid;
-			x += neighborGrid.offsets.x;
-			y += neighborGrid.offsets.y;
-			if (x >= currentChunk->GetWidth() || y >= currentChunk->GetHeight())
-				return {};
+		return currentChunk->GetBlockContent(indices);
+	}
 
-			offsets.z++;
-		}*/
+	inline Chunk* Chunk::GetNeighborChunk(Direction direction)
+	{
+		return m_neighbors[direction];
+	}
 
-		return currentChunk->GetBlockContent(indices);
+	inline const Chunk* Chunk::GetNeighborChunk(Direction direction) const
+	{
+		return m_neighbors[direction];
 	}
 
 	inline const ChunkIndices& Chunk::GetIndices() const
@@ -164,15 +148,36 @@ namespace tsom
 		return m_indices;
 	}
 
+	inline const ChunkOccupancy& Chunk::GetOccupancy() const
+	{
+		return m_content->occupancy;
+	}
+
 	inline const Nz::Vector3ui& Chunk::GetSize() const
 	{
 		return m_size;
 	}
 
+	inline bool Chunk::IsEmpty() const
+	{
+		return m_content->blocks.IsUniform() && m_content->blocks.GetBlock(0) == EmptyBlockIndex;
+	}
+
+	inline bool Chunk::IsUniform() const
+	{
+		return m_content->blocks.IsUniform();
+	}
+
 	template<typename F>
 	void Chunk::Reset(F&& func)
 	{
-		func(m_blocks.data());
+		// Blocks are palette-compressed, give the callback an unpacked copy and repack it afterwards
+		std::vector<BlockIndex> blocks(m_content->blocks.GetBlockCount());
+		m_content->blocks.Store(blocks.data());
+
+		func(blocks.data());
+
+		GetWritableContent().blocks.Load(blocks.data());
 		OnChunkReset();
 	}
 
@@ -188,18 +193,13 @@ namespace tsom
 
 	inline void Chunk::UpdateBlock(const Nz::Vector3ui& indices, BlockIndex newBlock)
 	{
-		unsigned int blockIndex = GetBlockLocalIndex(indices);
-		BlockIndex oldContent = m_blocks[blockIndex];
-		m_blocks[blockIndex] = newBlock;
-		m_collisionCellMask[blockIndex] = (newBlock != EmptyBlockIndex);
-
-		m_blockTypeCount[oldContent]--;
-		if (newBlock >= m_blockTypeCount.size())
-			m_blockTypeCount.resize(newBlock + 1);
-
-		m_blockTypeCount[newBlock]++;
+		BlockUpdate update{ indices, newBlock };
+		UpdateBlocks({ &update, 1 });
+	}
 
-		OnBlockUpdated(this, indices, newBlock);
+	inline void Chunk::SetNeighborChunk(Direction direction, Chunk* neighbor)
+	{
+		m_neighbors[direction] = neighbor;
 	}
 
 	inline void Chunk::UnlockRead() const
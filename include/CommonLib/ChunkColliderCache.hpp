@@ -0,0 +1,60 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com) (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_COMMONLIB_CHUNKCOLLIDERCACHE_HPP
+#define TSOM_COMMONLIB_CHUNKCOLLIDERCACHE_HPP
+
+#include <CommonLib/Export.hpp>
+#include <CommonLib/Chunk.hpp>
+#include <Nazara/Physics3D/Collider3D.hpp>
+#include <NazaraUtils/EnumArray.hpp>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace tsom
+{
+	// Collider shapes of each brick of a chunk, along with the brick versions they were built from
+	// building a chunk collider from the cache of its previous collider only rebuilds the bricks which changed
+	class TSOM_COMMONLIB_API ChunkColliderCache
+	{
+		public:
+			struct BrickCollider;
+
+			inline ChunkColliderCache(const Chunk::ColliderSettings& settings);
+			ChunkColliderCache(const ChunkColliderCache&) = delete;
+			ChunkColliderCache(ChunkColliderCache&&) = delete;
+			~ChunkColliderCache() = default;
+
+			std::shared_ptr<Nz::Collider3D> Build(const BlockLibrary& blockLibrary, const Chunk& chunk, const ChunkSnapshot& snapshot, const ChunkColliderCache* previousCache, const std::atomic_bool* cancelled = nullptr);
+
+			inline const std::vector<BrickCollider>& GetBricks() const;
+			inline std::size_t GetRebuiltBrickCount() const;
+			inline const Chunk::ColliderSettings& GetSettings() const;
+
+			inline bool IsEmpty() const;
+
+			ChunkColliderCache& operator=(const ChunkColliderCache&) = delete;
+			ChunkColliderCache& operator=(ChunkColliderCache&&) = delete;
+
+			struct BrickCollider
+			{
+				std::vector<Nz::CompoundCollider3D::ChildCollider> childColliders; //< expressed in chunk space
+				Nz::EnumArray<Direction, Nz::UInt64> neighborVersions;
+				Nz::UInt64 surroundingVersion = 0; //< latest version of the bricks a thick shell can reach
+				Nz::UInt64 version = 0;
+			};
+
+		private:
+			std::vector<BrickCollider> m_bricks;
+			std::size_t m_rebuiltBrickCount;
+			Chunk::ColliderSettings m_settings;
+	};
+}
+
+#include <CommonLib/ChunkColliderCache.inl>
+
+#endif // TSOM_COMMONLIB_CHUNKCOLLIDERCACHE_HPP
@@ -0,0 +1,32 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com) (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+namespace tsom
+{
+	inline ChunkColliderCache::ChunkColliderCache(const Chunk::ColliderSettings& settings) :
+	m_rebuiltBrickCount(0),
+	m_settings(settings)
+	{
+	}
+
+	inline auto ChunkColliderCache::GetBricks() const -> const std::vector<BrickCollider>&
+	{
+		return m_bricks;
+	}
+
+	inline std::size_t ChunkColliderCache::GetRebuiltBrickCount() const
+	{
+		return m_rebuiltBrickCount;
+	}
+
+	inline const Chunk::ColliderSettings& ChunkColliderCache::GetSettings() const
+	{
+		return m_settings;
+	}
+
+	inline bool ChunkColliderCache::IsEmpty() const
+	{
+		return m_bricks.empty();
+	}
+}
@@ -0,0 +1,67 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com) (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_COMMONLIB_CHUNKCOLLIDERRESIDENCY_HPP
+#define TSOM_COMMONLIB_CHUNKCOLLIDERRESIDENCY_HPP
+
+#include <CommonLib/Export.hpp>
+#include <CommonLib/Chunk.hpp>
+#include <Nazara/Core/Time.hpp>
+#include <Nazara/Math/Vector3.hpp>
+#include <NazaraUtils/FunctionRef.hpp>
+#include <tsl/hopscotch_map.h>
+
+namespace tsom
+{
+	class ChunkContainer;
+
+	// Tracks which chunks need a collider: chunks close to a non-static body (or to where it's heading) acquire their collider,
+	// they release it once no body came close for a while
+	class TSOM_COMMONLIB_API ChunkColliderResidency
+	{
+		public:
+			struct Settings;
+
+			using ChunkCallback = Nz::FunctionRef<void(const ChunkIndices& chunkIndices)>;
+
+			ChunkColliderResidency() = default;
+			ChunkColliderResidency(const ChunkColliderResidency&) = delete;
+			ChunkColliderResidency(ChunkColliderResidency&&) = delete;
+			~ChunkColliderResidency() = default;
+
+			inline std::size_t GetResidentChunkCount() const;
+			inline const Settings& GetSettings() const;
+
+			inline bool IsResident(const ChunkIndices& chunkIndices) const;
+
+			void ReleaseChunk(const ChunkIndices& chunkIndices);
+			void ReleaseExpiredChunks(Nz::Time now, const ChunkCallback& releaseCallback);
+			void RequestChunks(const ChunkContainer& chunkContainer, const Nz::Vector3f& position, const Nz::Vector3f& linearVelocity, Nz::Time now, const ChunkCallback& acquireCallback);
+
+			inline void SetSettings(const Settings& settings);
+
+			ChunkColliderResidency& operator=(const ChunkColliderResidency&) = delete;
+			ChunkColliderResidency& operator=(ChunkColliderResidency&&) = delete;
+
+			static void ForEachRequestedChunk(const ChunkContainer& chunkContainer, const Settings& settings, const Nz::Vector3f& position, const Nz::Vector3f& linearVelocity, const ChunkCallback& callback);
+
+			struct Settings
+			{
+				Nz::Time lookAhead = Nz::Time::Second(); //< colliders are also built around where bodies will be after this time, based on their velocity
+				Nz::Time releaseDelay = Nz::Time::Seconds(5); //< colliders are dropped after no body came close for this time
+				float radius = 48.f; //< distance from a body under which chunk colliders are built
+				bool enabled = false;
+			};
+
+		private:
+			tsl::hopscotch_map<ChunkIndices, Nz::Time /*lastRequestTime*/> m_residentChunks;
+			Settings m_settings;
+	};
+}
+
+#include <CommonLib/ChunkColliderResidency.inl>
+
+#endif // TSOM_COMMONLIB_CHUNKCOLLIDERRESIDENCY_HPP
@@ -0,0 +1,29 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com) (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+namespace tsom
+{
+	inline std::size_t ChunkColliderResidency::GetResidentChunkCount() const
+	{
+		return m_residentChunks.size();
+	}
+
+	inline auto ChunkColliderResidency::GetSettings() const -> const Settings&
+	{
+		return m_settings;
+	}
+
+	inline bool ChunkColliderResidency::IsResident(const ChunkIndices& chunkIndices) const
+	{
+		return !m_settings.enabled || m_residentChunks.contains(chunkIndices);
+	}
+
+	inline void ChunkColliderResidency::SetSettings(const Settings& settings)
+	{
+		m_settings = settings;
+
+		// Chunks will be requested again by the next update
+		m_residentChunks.clear();
+	}
+}
@@ -0,0 +1,55 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com) (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_COMMONLIB_CHUNKCONNECTIVITY_HPP
+#define TSOM_COMMONLIB_CHUNKCONNECTIVITY_HPP
+
+#include <CommonLib/Export.hpp>
+#include <CommonLib/Direction.hpp>
+#include <NazaraUtils/Prerequisites.hpp>
+
+namespace tsom
+{
+	class ChunkOccupancy;
+
+	// Pairs of chunk faces connected through empty blocks, sight can only cross a chunk between two connected faces
+	class TSOM_COMMONLIB_API ChunkConnectivity
+	{
+		public:
+			inline explicit ChunkConnectivity(bool fullyConnected = false);
+			ChunkConnectivity(const ChunkConnectivity&) = default;
+			ChunkConnectivity(ChunkConnectivity&&) noexcept = default;
+			~ChunkConnectivity() = default;
+
+			inline bool AreConnected(Direction first, Direction second) const;
+
+			inline void Connect(Direction first, Direction second);
+
+			inline bool IsFullyConnected() const;
+			inline bool IsSealed() const;
+
+			void Reset(const ChunkOccupancy& occupancy);
+
+			ChunkConnectivity& operator=(const ChunkConnectivity&) = default;
+			ChunkConnectivity& operator=(ChunkConnectivity&&) noexcept = default;
+
+			inline bool operator==(const ChunkConnectivity& connectivity) const;
+			inline bool operator!=(const ChunkConnectivity& connectivity) const;
+
+			static constexpr unsigned int FaceCount = static_cast<unsigned int>(Direction::Max) + 1;
+
+		private:
+			static constexpr Nz::UInt64 GetConnectionBit(Direction first, Direction second);
+
+			static constexpr Nz::UInt64 FullConnectionMask = (Nz::UInt64(1) << (FaceCount * FaceCount)) - 1;
+
+			Nz::UInt64 m_connections; //< bit (first * FaceCount + second), set in both orders
+	};
+}
+
+#include <CommonLib/ChunkConnectivity.inl>
+
+#endif // TSOM_COMMONLIB_CHUNKCONNECTIVITY_HPP
@@ -0,0 +1,46 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com) (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+namespace tsom
+{
+	inline ChunkConnectivity::ChunkConnectivity(bool fullyConnected) :
+	m_connections((fullyConnected) ? FullConnectionMask : 0)
+	{
+	}
+
+	inline bool ChunkConnectivity::AreConnected(Direction first, Direction second) const
+	{
+		return m_connections & GetConnectionBit(first, second);
+	}
+
+	inline void ChunkConnectivity::Connect(Direction first, Direction second)
+	{
+		m_connections |= GetConnectionBit(first, second) | GetConnectionBit(second, first);
+	}
+
+	inline bool ChunkConnectivity::IsFullyConnected() const
+	{
+		return m_connections == FullConnectionMask;
+	}
+
+	inline bool ChunkConnectivity::IsSealed() const
+	{
+		return m_connections == 0;
+	}
+
+	inline bool ChunkConnectivity::operator==(const ChunkConnectivity& connectivity) const
+	{
+		return m_connections == connectivity.m_connections;
+	}
+
+	inline bool ChunkConnectivity::operator!=(const ChunkConnectivity& connectivity) const
+	{
+		return !operator==(connectivity);
+	}
+
+	constexpr Nz::UInt64 ChunkConnectivity::GetConnectionBit(Direction first, Direction second)
+	{
+		return Nz::UInt64(1) << (static_cast<unsigned int>(first) * FaceCount + static_cast<unsigned int>(second));
+	}
+}
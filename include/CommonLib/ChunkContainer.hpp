@@ -47,6 +47,7 @@ namespace tsom
 			static constexpr unsigned int ChunkSize = 32;
 
 			NazaraSignal(OnChunkAdded, ChunkContainer* /*planet*/, Chunk* /*chunk*/);
+			NazaraSignal(OnChunkNeighborUpdated, ChunkContainer* /*planet*/, Chunk* /*chunk*/, Direction /*neighborDirection*/);
 			NazaraSignal(OnChunkRemove, ChunkContainer* /*planet*/, Chunk* /*chunk*/);
 			NazaraSignal(OnChunkUpdated, ChunkContainer* /*planet*/, Chunk* /*chunk*/);
 
@@ -0,0 +1,56 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com) (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_COMMONLIB_CHUNKDIRECTIONBOUNDS_HPP
+#define TSOM_COMMONLIB_CHUNKDIRECTIONBOUNDS_HPP
+
+#include <CommonLib/Export.hpp>
+#include <CommonLib/Direction.hpp>
+#include <Nazara/Math/Box.hpp>
+#include <Nazara/Math/Vector3.hpp>
+#include <NazaraUtils/EnumArray.hpp>
+#include <array>
+
+namespace tsom
+{
+	// Bounds of chunk mesh faces grouped by direction, to skip whole directions facing away from the viewer (CPU-side backface culling)
+	// each direction is bounded by a box and by a cone around the direction normal holding all its triangle normals
+	class TSOM_COMMONLIB_API ChunkDirectionBounds
+	{
+		public:
+			struct Bounds;
+
+			ChunkDirectionBounds() = default;
+			ChunkDirectionBounds(const ChunkDirectionBounds&) = default;
+			ChunkDirectionBounds(ChunkDirectionBounds&&) noexcept = default;
+			~ChunkDirectionBounds() = default;
+
+			void AddFace(Direction direction, const std::array<Nz::Vector3f, 4>& positions, const Nz::Vector3f& outsideNormal);
+
+			inline const Bounds& GetBounds(Direction direction) const;
+
+			bool IsBackFacing(Direction direction, const Nz::Vector3f& viewerPosition) const;
+
+			void Merge(const ChunkDirectionBounds& bounds);
+
+			ChunkDirectionBounds& operator=(const ChunkDirectionBounds&) = default;
+			ChunkDirectionBounds& operator=(ChunkDirectionBounds&&) noexcept = default;
+
+			struct Bounds
+			{
+				Nz::Boxf box = Nz::Boxf(0.f, 0.f, 0.f, 0.f, 0.f, 0.f);
+				float normalDeviation = 0.f; //< maximum distance between a (unit) triangle normal and the direction normal
+				Nz::UInt32 faceCount = 0;
+			};
+
+		private:
+			Nz::EnumArray<Direction, Bounds> m_bounds;
+	};
+}
+
+#include <CommonLib/ChunkDirectionBounds.inl>
+
+#endif // TSOM_COMMONLIB_CHUNKDIRECTIONBOUNDS_HPP
@@ -0,0 +1,11 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com) (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+namespace tsom
+{
+	inline auto ChunkDirectionBounds::GetBounds(Direction direction) const -> const Bounds&
+	{
+		return m_bounds[direction];
+	}
+}
@@ -7,11 +7,19 @@
 #ifndef TSOM_COMMONLIB_CHUNKENTITIES_HPP
 #define TSOM_COMMONLIB_CHUNKENTITIES_HPP
 
+#include <CommonLib/ChunkColliderCache.hpp>
+#include <CommonLib/ChunkColliderResidency.hpp>
 #include <CommonLib/ChunkContainer.hpp>
+#include <CommonLib/ChunkJobScheduler.hpp>
+#include <CommonLib/Utility/LruCache.hpp>
+#include <CommonLib/Utility/SharedObjectPool.hpp>
+#include <Nazara/Core/Clock.hpp>
+#include <Nazara/Core/Time.hpp>
 #include <entt/entt.hpp>
 #include <tsl/hopscotch_map.h>
 #include <tsl/hopscotch_set.h>
 #include <atomic>
+#include <span>
 #include <vector>
 
 namespace Nz
@@ -27,25 +35,86 @@ namespace tsom
 	class TSOM_COMMONLIB_API ChunkEntities
 	{
 		public:
+			struct JobApplySettings;
+			struct JobApplyStats;
+
+			// Chunk colliders are only built around non-static bodies (characters and dynamic/kinematic bodies), when enabled
+			using ColliderResidencySettings = ChunkColliderResidency::Settings;
+
 			ChunkEntities(Nz::ApplicationBase& app, Nz::EnttWorld& world, const ChunkContainer& chunkContainer, const BlockLibrary& blockLibrary);
 			ChunkEntities(const ChunkEntities&) = delete;
 			ChunkEntities(ChunkEntities&&) = delete;
 			~ChunkEntities();
 
-			void Update();
+			inline std::size_t GetColliderCacheHitCount() const;
+			inline std::size_t GetColliderCacheMissCount() const;
+			inline const ColliderResidencySettings& GetColliderResidencySettings() const;
+			inline const Chunk::ColliderSettings& GetColliderSettings() const;
+			inline const JobApplySettings& GetJobApplySettings() const;
+			inline const JobApplyStats& GetJobApplyStats() const;
+
+			inline bool HasColliderResidency(const ChunkIndices& chunkIndices) const;
+
+			inline void SetColliderCacheCapacity(std::size_t capacity);
+			void SetColliderResidencySettings(const ColliderResidencySettings& residencySettings);
+			void SetColliderSettings(const Chunk::ColliderSettings& colliderSettings);
+			inline void SetJobApplySettings(const JobApplySettings& applySettings);
+
+			void Update(std::span<const Nz::Vector3f> viewerPositions = {});
 
 			ChunkEntities& operator=(const ChunkEntities&) = delete;
 			ChunkEntities& operator=(ChunkEntities&&) = delete;
 
+			// Finished jobs are applied on the main thread closest to the viewers first, until the time budget is spent (remaining jobs are applied on the next updates)
+			struct JobApplySettings
+			{
+				Nz::Time budget = Nz::Time::Milliseconds(4); //< at least one job is applied each update, whatever its cost
+				bool enabled = true;
+			};
+
+			struct JobApplyStats
+			{
+				Nz::Time applyTime = Nz::Time::Zero(); //< time spent applying jobs during the last update
+				std::size_t appliedJobCount = 0; //< jobs applied during the last update
+				std::size_t pendingJobCount = 0; //< finished jobs waiting to be applied
+				std::size_t queuedTaskCount = 0; //< tasks waiting in the chunk job scheduler
+				std::size_t runningJobCount = 0; //< jobs whose tasks are queued or running
+			};
+
+			static constexpr std::size_t DefaultColliderCacheCapacity = 512;
+
 		protected:
 			struct NoInit {};
 			ChunkEntities(Nz::ApplicationBase& app, Nz::EnttWorld& world, const ChunkContainer& chunkContainer, const BlockLibrary& blockLibrary, NoInit);
 
+			struct ColliderUpdateJob;
+			struct UpdateJob;
+
+			void ApplyColliderUpdate(const ChunkIndices& chunkIndices, ColliderUpdateJob& job);
+			void CancelUpdateJob(const ChunkIndices& chunkIndices);
+			Nz::UInt64 ComputeContentKey(const ChunkIndices& chunkIndices, const Chunk& chunk, const ChunkSnapshot& snapshot);
 			void CreateChunkEntity(const ChunkIndices& chunkIndices, const Chunk* chunk);
-			void DestroyChunkEntity(const ChunkIndices& chunkIndices);
+			virtual void DestroyChunkEntity(const ChunkIndices& chunkIndices);
 			void FillChunks();
 			virtual void HandleChunkUpdate(const ChunkIndices& chunkIndices, const Chunk* chunk);
+			void PrepareColliderUpdate(const ChunkIndices& chunkIndices, const Chunk& chunk, ColliderUpdateJob& job);
+			virtual void RecycleJob(std::shared_ptr<UpdateJob>&& job);
+			void ReleaseChunkCollider(const ChunkIndices& chunkIndices);
 			void UpdateChunkEntity(const ChunkIndices& chunkIndices);
+			void UpdateColliderResidency();
+
+			// Colliders of recently seen chunk contents, chunks sharing the same content, borders and geometry reuse them without rebuilding anything
+			struct CachedCollider
+			{
+				std::shared_ptr<ChunkColliderCache> colliderCache;
+				std::shared_ptr<Nz::Collider3D> collider;
+			};
+
+			struct ContentHash
+			{
+				Nz::UInt64 hash;
+				Nz::UInt64 version = 0;
+			};
 
 			struct UpdateJob
 			{
@@ -53,20 +122,40 @@ namespace tsom
 				std::atomic_bool cancelled = false;
 				std::atomic_uint executionCounter = 0;
 				unsigned int taskCount;
+				ChunkSnapshot snapshot;
 			};
 
 			struct ColliderUpdateJob : UpdateJob
 			{
+				std::shared_ptr<const ChunkColliderCache> previousColliderCache;
+				std::shared_ptr<ChunkColliderCache> colliderCache;
 				std::shared_ptr<Nz::Collider3D> collider;
+				Nz::UInt64 colliderKey;
+				bool buildCollider;
+				bool colliderCacheHit = false;
 			};
 
+			static constexpr std::size_t JobPoolCapacity = 64;
+
 			NazaraSlot(ChunkContainer, OnChunkAdded, m_onChunkAdded);
+			NazaraSlot(ChunkContainer, OnChunkNeighborUpdated, m_onChunkNeighborUpdated);
 			NazaraSlot(ChunkContainer, OnChunkRemove, m_onChunkRemove);
 			NazaraSlot(ChunkContainer, OnChunkUpdated, m_onChunkUpdated);
 
 			tsl::hopscotch_set<ChunkIndices> m_invalidatedChunks;
 			tsl::hopscotch_map<ChunkIndices, std::shared_ptr<UpdateJob>> m_updateJobs;
+			ChunkJobScheduler m_jobScheduler;
+			SharedObjectPool<ColliderUpdateJob> m_colliderJobPool;
 			tsl::hopscotch_map<ChunkIndices, entt::handle> m_chunkEntities;
+			tsl::hopscotch_map<ChunkIndices, std::shared_ptr<const ChunkColliderCache>> m_chunkColliderCaches;
+			tsl::hopscotch_map<ChunkIndices, ContentHash> m_contentHashes;
+			std::vector<std::pair<float /*viewerDistanceSq*/, ChunkIndices>> m_finishedJobs;
+			LruCache<Nz::UInt64, CachedCollider> m_colliderCache;
+			Chunk::ColliderSettings m_colliderSettings;
+			ChunkColliderResidency m_colliderResidency;
+			JobApplySettings m_jobApplySettings;
+			JobApplyStats m_jobApplyStats;
+			Nz::MillisecondClock m_residencyClock;
 			Nz::ApplicationBase& m_application;
 			Nz::EnttWorld& m_world;
 			const BlockLibrary& m_blockLibrary;
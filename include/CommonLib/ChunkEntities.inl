@@ -4,4 +4,48 @@
 
 namespace tsom
 {
+	inline std::size_t ChunkEntities::GetColliderCacheHitCount() const
+	{
+		return m_colliderCache.GetHitCount();
+	}
+
+	inline std::size_t ChunkEntities::GetColliderCacheMissCount() const
+	{
+		return m_colliderCache.GetMissCount();
+	}
+
+	inline auto ChunkEntities::GetColliderResidencySettings() const -> const ColliderResidencySettings&
+	{
+		return m_colliderResidency.GetSettings();
+	}
+
+	inline const Chunk::ColliderSettings& ChunkEntities::GetColliderSettings() const
+	{
+		return m_colliderSettings;
+	}
+
+	inline auto ChunkEntities::GetJobApplySettings() const -> const JobApplySettings&
+	{
+		return m_jobApplySettings;
+	}
+
+	inline auto ChunkEntities::GetJobApplyStats() const -> const JobApplyStats&
+	{
+		return m_jobApplyStats;
+	}
+
+	inline bool ChunkEntities::HasColliderResidency(const ChunkIndices& chunkIndices) const
+	{
+		return m_colliderResidency.IsResident(chunkIndices);
+	}
+
+	inline void ChunkEntities::SetColliderCacheCapacity(std::size_t capacity)
+	{
+		m_colliderCache.SetCapacity(capacity);
+	}
+
+	inline void ChunkEntities::SetJobApplySettings(const JobApplySettings& applySettings)
+	{
+		m_jobApplySettings = applySettings;
+	}
 }
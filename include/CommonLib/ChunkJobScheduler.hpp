@@ -0,0 +1,63 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com) (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_COMMONLIB_CHUNKJOBSCHEDULER_HPP
+#define TSOM_COMMONLIB_CHUNKJOBSCHEDULER_HPP
+
+#include <CommonLib/Export.hpp>
+#include <CommonLib/Chunk.hpp>
+#include <Nazara/Math/Vector3.hpp>
+#include <NazaraUtils/FunctionRef.hpp>
+#include <tsl/hopscotch_map.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace tsom
+{
+	// Hands chunk tasks to worker threads closest to the viewers first
+	// only a few tasks are submitted at once, the others wait here where they can still be dropped (when their chunk changes again) and get reprioritized as viewers move
+	class TSOM_COMMONLIB_API ChunkJobScheduler
+	{
+		public:
+			using Task = std::function<void()>;
+
+			ChunkJobScheduler(float chunkSize, unsigned int maxRunningTasks);
+			ChunkJobScheduler(const ChunkJobScheduler&) = delete;
+			ChunkJobScheduler(ChunkJobScheduler&&) = delete;
+			~ChunkJobScheduler() = default;
+
+			void Cancel(const ChunkIndices& chunkIndices);
+			void Clear();
+
+			void Dispatch(std::span<const Nz::Vector3f> viewerPositions, const Nz::FunctionRef<void(Task&& task)>& submitTask);
+
+			inline unsigned int GetMaxRunningTasks() const;
+			inline std::size_t GetPendingTaskCount() const;
+			inline unsigned int GetRunningTaskCount() const;
+
+			void Schedule(const ChunkIndices& chunkIndices, Task&& task);
+
+			inline void SetMaxRunningTasks(unsigned int maxRunningTasks);
+
+			ChunkJobScheduler& operator=(const ChunkJobScheduler&) = delete;
+			ChunkJobScheduler& operator=(ChunkJobScheduler&&) = delete;
+
+		private:
+			std::shared_ptr<std::atomic_uint> m_runningTaskCount; //< shared with submitted tasks, which may outlive the scheduler
+			std::vector<std::pair<float /*viewerDistanceSq*/, ChunkIndices>> m_dispatchOrder;
+			tsl::hopscotch_map<ChunkIndices, std::vector<Task>> m_pendingTasks;
+			std::size_t m_pendingTaskCount;
+			float m_chunkSize;
+			unsigned int m_maxRunningTasks;
+	};
+}
+
+#include <CommonLib/ChunkJobScheduler.inl>
+
+#endif // TSOM_COMMONLIB_CHUNKJOBSCHEDULER_HPP
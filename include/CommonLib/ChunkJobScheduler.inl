@@ -0,0 +1,26 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com) (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+namespace tsom
+{
+	inline unsigned int ChunkJobScheduler::GetMaxRunningTasks() const
+	{
+		return m_maxRunningTasks;
+	}
+
+	inline std::size_t ChunkJobScheduler::GetPendingTaskCount() const
+	{
+		return m_pendingTaskCount;
+	}
+
+	inline unsigned int ChunkJobScheduler::GetRunningTaskCount() const
+	{
+		return *m_runningTaskCount;
+	}
+
+	inline void ChunkJobScheduler::SetMaxRunningTasks(unsigned int maxRunningTasks)
+	{
+		m_maxRunningTasks = maxRunningTasks;
+	}
+}
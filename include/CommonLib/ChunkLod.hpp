@@ -0,0 +1,71 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com) (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_COMMONLIB_CHUNKLOD_HPP
+#define TSOM_COMMONLIB_CHUNKLOD_HPP
+
+#include <CommonLib/Export.hpp>
+#include <CommonLib/BlockIndex.hpp>
+#include <CommonLib/ChunkSnapshot.hpp>
+#include <CommonLib/Direction.hpp>
+#include <Nazara/Math/Vector3.hpp>
+#include <NazaraUtils/FunctionRef.hpp>
+#include <utility>
+#include <vector>
+
+namespace tsom
+{
+	class BlockLibrary;
+	class Chunk;
+	struct ChunkMeshFace;
+
+	// Chunk content downsampled into cells of lodFactor^3 blocks, to mesh distant chunks with fewer (and bigger) faces
+	// a cell is solid as soon as one of its blocks is (so a coarse surface never sits below the full resolution one) and takes its most common block
+	// surface cells along chunk borders hang a skirt one cell deep below them, covering the gap down to a finer neighbor surface
+	class TSOM_COMMONLIB_API ChunkLod
+	{
+		public:
+			inline ChunkLod();
+			ChunkLod(ChunkSnapshot snapshot, unsigned int lodFactor);
+			ChunkLod(const ChunkLod&) = delete;
+			ChunkLod(ChunkLod&&) noexcept = default;
+			~ChunkLod() = default;
+
+			void BuildMesh(const Chunk& chunk, const BlockLibrary& blockLibrary, const Nz::Vector3f& gravityCenter, const Nz::FunctionRef<void(const ChunkMeshFace& face)>& vertexSink) const;
+
+			void Clear();
+
+			inline BlockIndex GetCellContent(const Nz::Vector3ui& cellIndices) const;
+			inline const Nz::Vector3ui& GetCellGridSize() const;
+			inline unsigned int GetCellLocalIndex(const Nz::Vector3ui& cellIndices) const;
+			inline unsigned int GetLodFactor() const;
+
+			inline bool IsEmpty() const;
+
+			void Reset(ChunkSnapshot snapshot, unsigned int lodFactor);
+
+			ChunkLod& operator=(const ChunkLod&) = delete;
+			ChunkLod& operator=(ChunkLod&&) noexcept = default;
+
+			static constexpr unsigned int MaxLevel = 3; //< 2x, 4x and 8x cells
+
+		private:
+			bool IsBorderFace(const Nz::Vector3ui& cellIndices, Direction direction) const;
+			bool IsCellEmpty(const Nz::Vector3ui& cellIndices, unsigned int axis, int offset) const;
+			bool IsFaceVisible(const Nz::Vector3ui& cellIndices, Direction direction) const;
+
+			std::vector<std::pair<BlockIndex, unsigned int>> m_blockCounts;
+			std::vector<BlockIndex> m_cells;
+			ChunkSnapshot m_snapshot;
+			Nz::Vector3ui m_cellGridSize;
+			unsigned int m_lodFactor;
+			bool m_isEmpty;
+	};
+}
+
+#include <CommonLib/ChunkLod.inl>
+
+#endif // TSOM_COMMONLIB_CHUNKLOD_HPP
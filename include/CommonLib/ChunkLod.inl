@@ -0,0 +1,44 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com) (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <cassert>
+
+namespace tsom
+{
+	inline ChunkLod::ChunkLod() :
+	m_cellGridSize(0, 0, 0),
+	m_lodFactor(1),
+	m_isEmpty(true)
+	{
+	}
+
+	inline BlockIndex ChunkLod::GetCellContent(const Nz::Vector3ui& cellIndices) const
+	{
+		return m_cells[GetCellLocalIndex(cellIndices)];
+	}
+
+	inline const Nz::Vector3ui& ChunkLod::GetCellGridSize() const
+	{
+		return m_cellGridSize;
+	}
+
+	inline unsigned int ChunkLod::GetCellLocalIndex(const Nz::Vector3ui& cellIndices) const
+	{
+		assert(cellIndices.x < m_cellGridSize.x);
+		assert(cellIndices.y < m_cellGridSize.y);
+		assert(cellIndices.z < m_cellGridSize.z);
+
+		return (cellIndices.z * m_cellGridSize.y + cellIndices.y) * m_cellGridSize.x + cellIndices.x;
+	}
+
+	inline unsigned int ChunkLod::GetLodFactor() const
+	{
+		return m_lodFactor;
+	}
+
+	inline bool ChunkLod::IsEmpty() const
+	{
+		return m_isEmpty;
+	}
+}
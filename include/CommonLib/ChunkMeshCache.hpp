@@ -0,0 +1,83 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com) (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_COMMONLIB_CHUNKMESHCACHE_HPP
+#define TSOM_COMMONLIB_CHUNKMESHCACHE_HPP
+
+#include <CommonLib/Export.hpp>
+#include <CommonLib/ChunkDirectionBounds.hpp>
+#include <CommonLib/Direction.hpp>
+#include <Nazara/Math/Vector3.hpp>
+#include <NazaraUtils/EnumArray.hpp>
+#include <atomic>
+#include <vector>
+
+namespace tsom
+{
+	class BlockLibrary;
+	class Chunk;
+	class ChunkSnapshot;
+
+	struct ChunkMeshVertex
+	{
+		Nz::Vector3f position;
+		Nz::Vector3f normal;
+		Nz::Vector3f uvw;
+		Nz::Vector3f tangent;
+	};
+
+	// Vertices of a chunk mesh by direction, each brick owning a contiguous range of them along with the brick versions it was built from
+	// building a chunk mesh from the cache of its previous mesh only meshes the bricks which changed, the others are copied range by range
+	class TSOM_COMMONLIB_API ChunkMeshCache
+	{
+		public:
+			struct Brick;
+
+			inline ChunkMeshCache(bool greedyMeshing = true);
+			ChunkMeshCache(const ChunkMeshCache&) = delete;
+			ChunkMeshCache(ChunkMeshCache&&) = delete;
+			~ChunkMeshCache() = default;
+
+			bool Build(const BlockLibrary& blockLibrary, const Chunk& chunk, const ChunkSnapshot& snapshot, const Nz::Vector3f& gravityCenter, const ChunkMeshCache* previousCache, const std::atomic_bool* cancelled = nullptr);
+
+			inline const std::vector<Brick>& GetBricks() const;
+			inline const ChunkDirectionBounds& GetDirectionBounds() const;
+			inline std::size_t GetRebuiltBrickCount() const;
+			inline std::size_t GetStorageGrowthCount() const;
+			inline const std::vector<ChunkMeshVertex>& GetVertices(Direction direction) const;
+
+			inline bool IsEmpty() const;
+			inline bool IsGreedyMeshing() const;
+
+			void Reset(bool greedyMeshing);
+
+			ChunkMeshCache& operator=(const ChunkMeshCache&) = delete;
+			ChunkMeshCache& operator=(ChunkMeshCache&&) = delete;
+
+			struct Brick
+			{
+				Nz::EnumArray<Direction, Nz::UInt64> neighborVersions;
+				Nz::EnumArray<Direction, Nz::UInt32> firstVertex;
+				Nz::EnumArray<Direction, Nz::UInt32> vertexCount; //< four vertices per face, triangulated as ChunkMesherBase::s_faceIndices
+				ChunkDirectionBounds directionBounds;
+				Nz::UInt64 version = 0;
+			};
+
+		private:
+			template<typename ChunkType> bool BuildBricks(const BlockLibrary& blockLibrary, const ChunkType& chunk, const ChunkSnapshot& snapshot, const Nz::Vector3f& gravityCenter, const ChunkMeshCache* previousCache, const std::atomic_bool* cancelled);
+
+			Nz::EnumArray<Direction, std::vector<ChunkMeshVertex>> m_vertices; //< in brick order
+			std::vector<Brick> m_bricks;
+			std::size_t m_rebuiltBrickCount;
+			std::size_t m_storageGrowthCount; //< buffers which had to grow during the last build
+			ChunkDirectionBounds m_directionBounds;
+			bool m_greedyMeshing;
+	};
+}
+
+#include <CommonLib/ChunkMeshCache.inl>
+
+#endif // TSOM_COMMONLIB_CHUNKMESHCACHE_HPP
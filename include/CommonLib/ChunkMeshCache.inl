@@ -0,0 +1,48 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com) (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+namespace tsom
+{
+	inline ChunkMeshCache::ChunkMeshCache(bool greedyMeshing) :
+	m_rebuiltBrickCount(0),
+	m_storageGrowthCount(0),
+	m_greedyMeshing(greedyMeshing)
+	{
+	}
+
+	inline auto ChunkMeshCache::GetBricks() const -> const std::vector<Brick>&
+	{
+		return m_bricks;
+	}
+
+	inline const ChunkDirectionBounds& ChunkMeshCache::GetDirectionBounds() const
+	{
+		return m_directionBounds;
+	}
+
+	inline std::size_t ChunkMeshCache::GetRebuiltBrickCount() const
+	{
+		return m_rebuiltBrickCount;
+	}
+
+	inline std::size_t ChunkMeshCache::GetStorageGrowthCount() const
+	{
+		return m_storageGrowthCount;
+	}
+
+	inline const std::vector<ChunkMeshVertex>& ChunkMeshCache::GetVertices(Direction direction) const
+	{
+		return m_vertices[direction];
+	}
+
+	inline bool ChunkMeshCache::IsEmpty() const
+	{
+		return m_bricks.empty();
+	}
+
+	inline bool ChunkMeshCache::IsGreedyMeshing() const
+	{
+		return m_greedyMeshing;
+	}
+}
@@ -0,0 +1,95 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com) (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_COMMONLIB_CHUNKMESHER_HPP
+#define TSOM_COMMONLIB_CHUNKMESHER_HPP
+
+#include <CommonLib/Export.hpp>
+#include <CommonLib/BlockIndex.hpp>
+#include <CommonLib/BlockLibrary.hpp>
+#include <CommonLib/Chunk.hpp>
+#include <CommonLib/ChunkSnapshot.hpp>
+#include <CommonLib/Direction.hpp>
+#include <Nazara/Math/Box.hpp>
+#include <Nazara/Math/Vector2.hpp>
+#include <Nazara/Math/Vector3.hpp>
+#include <NazaraUtils/EnumArray.hpp>
+#include <array>
+#include <vector>
+
+namespace tsom
+{
+	// Quad handed to the vertex sink, vertices are ordered as Chunk::s_faceCorners
+	struct ChunkMeshFace
+	{
+		std::array<Nz::Vector3f, 4> positions;
+		std::array<Nz::Vector2f, 4> uvs;
+		Nz::Vector3f normal;
+		Nz::Vector3f tangent;
+		Direction direction; //< block face it was built from (normal may differ on deformed chunks)
+		float textureIndex;
+	};
+
+	class TSOM_COMMONLIB_API ChunkMesherBase
+	{
+		public:
+			struct FaceTexturing;
+
+			static FaceTexturing ComputeFaceTexturing(const std::array<Nz::Vector3f, 4>& positions, const Nz::Vector3f& normal, const Nz::Vector3f& blockCenter, Direction upDirection);
+			static std::size_t CountVisibleFaces(const ChunkSnapshot& snapshot, const Nz::Boxui& blocks);
+			static std::size_t CountVisibleFaces(const ChunkSnapshot& snapshot, const Nz::Boxui& blocks, Direction direction);
+			template<typename F> static void ForEachVisibleFace(const ChunkSnapshot& snapshot, const Nz::Boxui& blocks, F&& callback);
+
+			// Triangles of a face, two per quad
+			static constexpr std::array<Nz::UInt32, 6> s_faceIndices = { 0, 2, 1, 1, 2, 3 };
+
+			// UV, tangent and texture direction of a block face
+			struct FaceTexturing
+			{
+				std::array<Nz::Vector2f, 4> uvs;
+				Nz::Vector3f tangent;
+				Direction texDirection;
+			};
+
+		protected:
+			// Built once from the generic path, so both paths output the same faces
+			static const Nz::EnumArray<Direction, std::array<Nz::Vector3f, 4>> s_axisAlignedFaceCorners; //< corners of a unit block face, relative to the block minimum
+			static const Nz::EnumArray<Direction, Nz::EnumArray<Direction, FaceTexturing>> s_axisAlignedFaceTexturings; //< [upDirection][faceDirection], only depends on them for axis-aligned faces
+	};
+
+	// Mesher specialized at compile time for a chunk type (to avoid virtual calls per block) and a vertex sink (to avoid a callback per face)
+	// VertexSink must be callable with a const ChunkMeshFace&
+	template<typename ChunkType, typename VertexSink>
+	class ChunkMesher : public ChunkMesherBase
+	{
+		public:
+			inline ChunkMesher(const ChunkType& chunk, const BlockLibrary& blockLibrary, VertexSink& vertexSink);
+			ChunkMesher(const ChunkMesher&) = delete;
+			ChunkMesher(ChunkMesher&&) = delete;
+			~ChunkMesher() = default;
+
+			void BuildGreedyMesh(const ChunkSnapshot& snapshot, const Nz::Boxui& blocks, const Nz::Vector3f& gravityCenter);
+			void BuildMesh(const ChunkSnapshot& snapshot, const Nz::Boxui& blocks, const Nz::Vector3f& gravityCenter);
+
+			ChunkMesher& operator=(const ChunkMesher&) = delete;
+			ChunkMesher& operator=(ChunkMesher&&) = delete;
+
+			// FlatChunk blocks are axis-aligned cubes, whose faces can be taken from constant tables
+			static constexpr bool IsAxisAligned = ChunkType::HasAxisAlignedBlocks;
+
+		private:
+			void DrawAxisAlignedFace(const ChunkSnapshot& snapshot, Direction direction, const Nz::Vector3ui& blockIndices, const Nz::Vector3f& gravityCenter);
+			void DrawFace(const ChunkSnapshot& snapshot, Direction direction, const Nz::Vector3ui& blockIndices, const Nz::Vector3f& gravityCenter);
+
+			const BlockLibrary& m_blockLibrary;
+			const ChunkType& m_chunk;
+			VertexSink& m_vertexSink;
+	};
+}
+
+#include <CommonLib/ChunkMesher.inl>
+
+#endif // TSOM_COMMONLIB_CHUNKMESHER_HPP
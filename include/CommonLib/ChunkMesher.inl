@@ -0,0 +1,289 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com) (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <numeric>
+#include <utility>
+
+namespace tsom
+{
+	template<typename F>
+	void ChunkMesherBase::ForEachVisibleFace(const ChunkSnapshot& snapshot, const Nz::Boxui& blocks, F&& callback)
+	{
+		if (snapshot.IsEmpty())
+			return;
+
+		Nz::Vector3ui firstBlock(blocks.x, blocks.y, blocks.z);
+		Nz::Vector3ui blockCount(blocks.width, blocks.height, blocks.depth);
+
+		for (auto&& [direction, offset] : s_blockDirOffsets.iter_kv())
+		{
+			// Visible faces are computed for a whole column along the face normal axis at once
+			unsigned int axis = (offset.x != 0) ? 0 : (offset.y != 0) ? 1 : 2;
+			unsigned int uAxis = (axis + 1) % 3;
+			unsigned int vAxis = (axis + 2) % 3;
+
+			Nz::UInt32 rangeMask = ((blockCount[axis] >= 32) ? 0xFFFFFFFF : (Nz::UInt32(1) << blockCount[axis]) - 1) << firstBlock[axis];
+
+			Nz::Vector3ui blockIndices;
+			for (unsigned int v = firstBlock[vAxis]; v < firstBlock[vAxis] + blockCount[vAxis]; ++v)
+			{
+				blockIndices[vAxis] = v;
+				for (unsigned int u = firstBlock[uAxis]; u < firstBlock[uAxis] + blockCount[uAxis]; ++u)
+				{
+					blockIndices[uAxis] = u;
+
+					Nz::UInt32 visibleFaces = snapshot.ComputeVisibleFaces(direction, blockIndices) & rangeMask;
+					while (visibleFaces != 0)
+					{
+						blockIndices[axis] = std::countr_zero(visibleFaces);
+						visibleFaces &= visibleFaces - 1;
+
+						callback(direction, std::as_const(blockIndices));
+					}
+				}
+			}
+		}
+	}
+
+	template<typename ChunkType, typename VertexSink>
+	ChunkMesher<ChunkType, VertexSink>::ChunkMesher(const ChunkType& chunk, const BlockLibrary& blockLibrary, VertexSink& vertexSink) :
+	m_blockLibrary(blockLibrary),
+	m_chunk(chunk),
+	m_vertexSink(vertexSink)
+	{
+	}
+
+	template<typename ChunkType, typename VertexSink>
+	void ChunkMesher<ChunkType, VertexSink>::BuildGreedyMesh(const ChunkSnapshot& snapshot, const Nz::Boxui& blocks, const Nz::Vector3f& gravityCenter)
+	{
+		// Faces can't be merged in the general case, fallback to one quad per face
+		if constexpr (!IsAxisAligned)
+			return BuildMesh(snapshot, blocks, gravityCenter);
+		else
+		{
+			if (snapshot.IsEmpty())
+				return;
+
+			assert(blocks.x + blocks.width <= m_chunk.GetSize().x);
+			assert(blocks.y + blocks.height <= m_chunk.GetSize().y);
+			assert(blocks.z + blocks.depth <= m_chunk.GetSize().z);
+
+			const Nz::Vector3ui& chunkSize = m_chunk.GetSize();
+			float blockSize = m_chunk.GetBlockSize();
+
+			Nz::Vector3ui firstBlock(blocks.x, blocks.y, blocks.z);
+			Nz::Vector3ui blockCount(blocks.width, blocks.height, blocks.depth);
+			Nz::Vector3f halfSize = Nz::Vector3f(chunkSize.x, chunkSize.z, chunkSize.y) * 0.5f;
+
+			// Visible faces of each column along the face normal (scratch buffers are reused by each worker thread across calls)
+			thread_local std::vector<Nz::UInt32> columnFaces;
+
+			// Visible faces of a slice, faces sharing the same key (block index and texture orientation) can be merged, 0 means no face
+			thread_local std::vector<Nz::UInt32> faceKeys;
+
+			for (auto&& [direction, offset] : s_blockDirOffsets.iter_kv())
+			{
+				unsigned int normalAxis = (offset.x != 0) ? 0 : (offset.y != 0) ? 1 : 2;
+				unsigned int uAxis = (normalAxis + 1) % 3;
+				unsigned int vAxis = (normalAxis + 2) % 3;
+
+				unsigned int uCount = blockCount[uAxis];
+				unsigned int vCount = blockCount[vAxis];
+				columnFaces.resize(uCount * vCount);
+				faceKeys.resize(uCount * vCount);
+
+				const auto& faceCorners = Chunk::s_faceCorners[direction];
+				Nz::Vector3f faceOffset = s_dirNormals[direction] * 0.5f;
+
+				Nz::UInt32 rangeMask = ((blockCount[normalAxis] >= 32) ? 0xFFFFFFFF : (Nz::UInt32(1) << blockCount[normalAxis]) - 1) << firstBlock[normalAxis];
+
+				Nz::Vector3ui blockIndices;
+				Nz::UInt32 sliceFaces = 0;
+				for (unsigned int v = 0; v < vCount; ++v)
+				{
+					blockIndices[vAxis] = firstBlock[vAxis] + v;
+					for (unsigned int u = 0; u < uCount; ++u)
+					{
+						blockIndices[uAxis] = firstBlock[uAxis] + u;
+
+						Nz::UInt32 visibleFaces = snapshot.ComputeVisibleFaces(direction, blockIndices) & rangeMask;
+						columnFaces[v * uCount + u] = visibleFaces;
+						sliceFaces |= visibleFaces;
+					}
+				}
+
+				// Only visit slices having at least one visible face
+				while (sliceFaces != 0)
+				{
+					unsigned int slice = std::countr_zero(sliceFaces);
+					sliceFaces &= sliceFaces - 1;
+
+					blockIndices[normalAxis] = slice;
+
+					Nz::UInt32 sliceBit = Nz::UInt32(1) << slice;
+					for (unsigned int v = 0; v < vCount; ++v)
+					{
+						blockIndices[vAxis] = firstBlock[vAxis] + v;
+						for (unsigned int u = 0; u < uCount; ++u)
+						{
+							blockIndices[uAxis] = firstBlock[uAxis] + u;
+
+							Nz::UInt32& faceKey = faceKeys[v * uCount + u];
+							if ((columnFaces[v * uCount + u] & sliceBit) == 0)
+							{
+								faceKey = 0;
+								continue;
+							}
+
+							BlockIndex blockIndex = snapshot.GetBlockContent(blockIndices);
+
+							Nz::Vector3f faceCenter = (Nz::Vector3f(blockIndices.x, blockIndices.z, blockIndices.y) + Nz::Vector3f(0.5f) - halfSize + faceOffset) * blockSize;
+							Direction upDirection = DirectionFromNormal(Nz::Vector3f::Normalize(faceCenter - gravityCenter));
+
+							faceKey = ((Nz::UInt32(blockIndex) << 3) | Nz::UInt32(upDirection)) + 1;
+						}
+					}
+
+					// Grow each face as much as possible along U, then along V
+					for (unsigned int v = 0; v < vCount; ++v)
+					{
+						for (unsigned int u = 0; u < uCount;)
+						{
+							Nz::UInt32 faceKey = faceKeys[v * uCount + u];
+							if (faceKey == 0)
+							{
+								++u;
+								continue;
+							}
+
+							unsigned int width = 1;
+							while (u + width < uCount && faceKeys[v * uCount + u + width] == faceKey)
+								width++;
+
+							unsigned int height = 1;
+							for (; v + height < vCount; ++height)
+							{
+								auto rowBegin = faceKeys.begin() + (v + height) * uCount + u;
+								if (std::any_of(rowBegin, rowBegin + width, [&](Nz::UInt32 key) { return key != faceKey; }))
+									break;
+							}
+
+							for (unsigned int y = 0; y < height; ++y)
+							{
+								auto rowBegin = faceKeys.begin() + (v + y) * uCount + u;
+								std::fill(rowBegin, rowBegin + width, 0);
+							}
+
+							Nz::Vector3ui quadFirstBlock = blockIndices;
+							quadFirstBlock[uAxis] = firstBlock[uAxis] + u;
+							quadFirstBlock[vAxis] = firstBlock[vAxis] + v;
+
+							Nz::Vector3ui quadBlockCount(1);
+							quadBlockCount[uAxis] = width;
+							quadBlockCount[vAxis] = height;
+
+							Nz::Vector3f quadPos = (Nz::Vector3f(quadFirstBlock.x, quadFirstBlock.z, quadFirstBlock.y) - halfSize) * blockSize;
+							Nz::Vector3f quadSize = Nz::Vector3f(quadBlockCount.x, quadBlockCount.z, quadBlockCount.y) * blockSize;
+
+							// Quad is the face of the box made of all merged blocks, texture repeats once per block
+							Nz::Boxf box(quadPos, quadSize);
+							Nz::EnumArray<Nz::BoxCorner, Nz::Vector3f> corners = box.GetCorners();
+
+							BlockIndex blockIndex = Nz::SafeCast<BlockIndex>((faceKey - 1) >> 3);
+							Direction upDirection = static_cast<Direction>((faceKey - 1) & 0x7);
+
+							ChunkMeshFace face;
+							for (std::size_t i = 0; i < face.positions.size(); ++i)
+								face.positions[i] = corners[faceCorners[i]];
+
+							face.normal = s_dirNormals[direction];
+							face.direction = direction;
+
+							FaceTexturing texturing = ComputeFaceTexturing(face.positions, face.normal, box.GetCenter(), upDirection);
+							face.uvs = texturing.uvs;
+							face.tangent = texturing.tangent;
+							face.textureIndex = m_blockLibrary.GetBlockData(blockIndex).texIndices[texturing.texDirection];
+
+							m_vertexSink(face);
+
+							u += width;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	template<typename ChunkType, typename VertexSink>
+	void ChunkMesher<ChunkType, VertexSink>::BuildMesh(const ChunkSnapshot& snapshot, const Nz::Boxui& blocks, const Nz::Vector3f& gravityCenter)
+	{
+		assert(blocks.x + blocks.width <= m_chunk.GetSize().x);
+		assert(blocks.y + blocks.height <= m_chunk.GetSize().y);
+		assert(blocks.z + blocks.depth <= m_chunk.GetSize().z);
+
+		ForEachVisibleFace(snapshot, blocks, [&](Direction direction, const Nz::Vector3ui& blockIndices)
+		{
+			if constexpr (IsAxisAligned)
+				DrawAxisAlignedFace(snapshot, direction, blockIndices, gravityCenter);
+			else
+				DrawFace(snapshot, direction, blockIndices, gravityCenter);
+		});
+	}
+
+	template<typename ChunkType, typename VertexSink>
+	void ChunkMesher<ChunkType, VertexSink>::DrawAxisAlignedFace(const ChunkSnapshot& snapshot, Direction direction, const Nz::Vector3ui& blockIndices, const Nz::Vector3f& gravityCenter)
+	{
+		float blockSize = m_chunk.GetBlockSize();
+
+		// Same block position as FlatChunk::ComputeVoxelCorners
+		Nz::Vector3f blockPos = (Nz::Vector3f(blockIndices) - Nz::Vector3f(m_chunk.GetSize()) * 0.5f) * blockSize;
+		Nz::Vector3f blockMin(blockPos.x, blockPos.z, blockPos.y);
+
+		ChunkMeshFace face;
+		for (std::size_t i = 0; i < face.positions.size(); ++i)
+			face.positions[i] = blockMin + s_axisAlignedFaceCorners[direction][i] * blockSize;
+
+		face.normal = s_dirNormals[direction];
+		face.direction = direction;
+
+		Nz::Vector3f faceCenter = std::accumulate(face.positions.begin(), face.positions.end(), Nz::Vector3f::Zero()) / face.positions.size();
+		Direction upDirection = DirectionFromNormal(Nz::Vector3f::Normalize(faceCenter - gravityCenter));
+
+		const FaceTexturing& texturing = s_axisAlignedFaceTexturings[upDirection][direction];
+		face.uvs = texturing.uvs;
+		face.tangent = texturing.tangent;
+		face.textureIndex = m_blockLibrary.GetBlockData(snapshot.GetBlockContent(blockIndices)).texIndices[texturing.texDirection];
+
+		m_vertexSink(face);
+	}
+
+	template<typename ChunkType, typename VertexSink>
+	void ChunkMesher<ChunkType, VertexSink>::DrawFace(const ChunkSnapshot& snapshot, Direction direction, const Nz::Vector3ui& blockIndices, const Nz::Vector3f& gravityCenter)
+	{
+		Nz::EnumArray<Nz::BoxCorner, Nz::Vector3f> corners = m_chunk.ComputeVoxelCorners(blockIndices);
+		Nz::Vector3f blockCenter = std::accumulate(corners.begin(), corners.end(), Nz::Vector3f::Zero()) / corners.size();
+
+		const auto& faceCorners = Chunk::s_faceCorners[direction];
+
+		ChunkMeshFace face;
+		for (std::size_t i = 0; i < face.positions.size(); ++i)
+			face.positions[i] = corners[faceCorners[i]];
+
+		Nz::Vector3f faceCenter = std::accumulate(face.positions.begin(), face.positions.end(), Nz::Vector3f::Zero()) / face.positions.size();
+		face.normal = Nz::Vector3f::Normalize(faceCenter - blockCenter);
+		face.direction = direction;
+
+		Direction upDirection = DirectionFromNormal(Nz::Vector3f::Normalize(faceCenter - gravityCenter));
+
+		FaceTexturing texturing = ComputeFaceTexturing(face.positions, face.normal, blockCenter, upDirection);
+		face.uvs = texturing.uvs;
+		face.tangent = texturing.tangent;
+		face.textureIndex = m_blockLibrary.GetBlockData(snapshot.GetBlockContent(blockIndices)).texIndices[texturing.texDirection];
+
+		m_vertexSink(face);
+	}
+}
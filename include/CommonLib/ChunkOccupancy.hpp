@@ -0,0 +1,65 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_COMMONLIB_CHUNKOCCUPANCY_HPP
+#define TSOM_COMMONLIB_CHUNKOCCUPANCY_HPP
+
+#include <CommonLib/Export.hpp>
+#include <Nazara/Math/Box.hpp>
+#include <Nazara/Math/Vector3.hpp>
+#include <NazaraUtils/FunctionRef.hpp>
+#include <NazaraUtils/Prerequisites.hpp>
+#include <array>
+#include <span>
+#include <vector>
+
+namespace tsom
+{
+	class BlockStorage;
+
+	// Block occupancy (non-empty blocks) stored as 32-bit columns along each axis, bit N of a column is the block at coordinate N on that axis
+	// this allows to find exposed faces of a whole column with a few bitwise operations
+	// uniform chunks don't allocate any column
+	class TSOM_COMMONLIB_API ChunkOccupancy
+	{
+		public:
+			ChunkOccupancy(const Nz::Vector3ui& size);
+			ChunkOccupancy(const ChunkOccupancy&) = default;
+			ChunkOccupancy(ChunkOccupancy&&) noexcept = default;
+			~ChunkOccupancy() = default;
+
+			void ComputeBoxes(const Nz::FunctionRef<void(const Nz::Boxui& blocks)>& callback) const;
+			void ComputeBoxes(const Nz::Boxui& blocks, const ChunkOccupancy& mergeableOccupancy, const Nz::FunctionRef<void(const Nz::Boxui& blocks)>& callback) const;
+
+			inline Nz::UInt32 GetColumn(unsigned int axis, const Nz::Vector3ui& blockIndices) const;
+			inline Nz::UInt32 GetColumnMask(unsigned int axis) const;
+			inline const Nz::Vector3ui& GetSize() const;
+
+			inline bool IsOccupied(const Nz::Vector3ui& blockIndices) const;
+			inline bool IsUniform() const;
+
+			void Reset(const BlockStorage& blocks);
+			void Reset(std::span<const Nz::UInt32> xColumns);
+
+			void Set(const Nz::Vector3ui& blockIndices, bool isOccupied);
+
+			ChunkOccupancy& operator=(const ChunkOccupancy&) = default;
+			ChunkOccupancy& operator=(ChunkOccupancy&&) noexcept = default;
+
+			static constexpr unsigned int MaxSize = 32;
+
+		private:
+			inline std::size_t GetColumnIndex(unsigned int axis, const Nz::Vector3ui& blockIndices) const;
+
+			std::array<std::vector<Nz::UInt32>, 3> m_columns;
+			Nz::Vector3ui m_size;
+			bool m_uniformValue;
+	};
+}
+
+#include <CommonLib/ChunkOccupancy.inl>
+
+#endif // TSOM_COMMONLIB_CHUNKOCCUPANCY_HPP
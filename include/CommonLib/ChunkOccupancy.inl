@@ -0,0 +1,48 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <cassert>
+
+namespace tsom
+{
+	// Returns the column along an axis going through a block (block coordinate along the axis is ignored)
+	inline Nz::UInt32 ChunkOccupancy::GetColumn(unsigned int axis, const Nz::Vector3ui& blockIndices) const
+	{
+		assert(axis < 3);
+		if (IsUniform())
+			return (m_uniformValue) ? GetColumnMask(axis) : 0;
+
+		return m_columns[axis][GetColumnIndex(axis, blockIndices)];
+	}
+
+	inline Nz::UInt32 ChunkOccupancy::GetColumnMask(unsigned int axis) const
+	{
+		return (m_size[axis] >= 32) ? 0xFFFFFFFF : (Nz::UInt32(1) << m_size[axis]) - 1;
+	}
+
+	inline const Nz::Vector3ui& ChunkOccupancy::GetSize() const
+	{
+		return m_size;
+	}
+
+	inline bool ChunkOccupancy::IsOccupied(const Nz::Vector3ui& blockIndices) const
+	{
+		return GetColumn(0, blockIndices) & (Nz::UInt32(1) << blockIndices.x);
+	}
+
+	inline bool ChunkOccupancy::IsUniform() const
+	{
+		return m_columns[0].empty();
+	}
+
+	inline std::size_t ChunkOccupancy::GetColumnIndex(unsigned int axis, const Nz::Vector3ui& blockIndices) const
+	{
+		unsigned int firstAxis = (axis + 1) % 3;
+		unsigned int secondAxis = (axis + 2) % 3;
+		assert(blockIndices[firstAxis] < m_size[firstAxis]);
+		assert(blockIndices[secondAxis] < m_size[secondAxis]);
+
+		return std::size_t(blockIndices[secondAxis]) * m_size[firstAxis] + blockIndices[firstAxis];
+	}
+}
@@ -0,0 +1,95 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_COMMONLIB_CHUNKSNAPSHOT_HPP
+#define TSOM_COMMONLIB_CHUNKSNAPSHOT_HPP
+
+#include <CommonLib/Export.hpp>
+#include <CommonLib/BlockIndex.hpp>
+#include <CommonLib/BlockStorage.hpp>
+#include <CommonLib/ChunkOccupancy.hpp>
+#include <CommonLib/Direction.hpp>
+#include <Nazara/Math/Box.hpp>
+#include <Nazara/Math/Vector3.hpp>
+#include <NazaraUtils/EnumArray.hpp>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace tsom
+{
+	class Chunk;
+
+	// Chunk content is never modified once shared, writers clone it (copy-on-write) and publish a new version
+	struct ChunkContent
+	{
+		inline ChunkContent(const Nz::Vector3ui& size, Nz::UInt64 contentVersion);
+
+		inline unsigned int GetBrickLocalIndex(const Nz::Vector3ui& blockIndices) const;
+
+		inline void InvalidateBrick(const Nz::Vector3ui& blockIndices);
+		inline void InvalidateBricks();
+
+		static inline Nz::Vector3ui ComputeBrickGridSize(const Nz::Vector3ui& size);
+
+		static constexpr unsigned int BrickSize = 8;
+
+		BlockStorage blocks;
+		ChunkOccupancy occupancy;
+		Nz::Vector3ui brickGridSize;
+		std::vector<Nz::UInt64> brickVersions; //< content version of the last change of each brick
+		Nz::UInt64 version;
+	};
+
+	// Immutable view of a chunk content and of its direct neighbors content, safe to use without locking the chunk
+	class TSOM_COMMONLIB_API ChunkSnapshot
+	{
+		public:
+			ChunkSnapshot() = default;
+			inline ChunkSnapshot(const Nz::Vector3ui& size, std::shared_ptr<const ChunkContent> content, Nz::EnumArray<Direction, std::shared_ptr<const ChunkContent>> neighborContents);
+			ChunkSnapshot(const ChunkSnapshot&) = default;
+			ChunkSnapshot(ChunkSnapshot&&) noexcept = default;
+			~ChunkSnapshot() = default;
+
+			Nz::UInt64 ComputeNeighborBorderHash() const;
+			inline ChunkOccupancy ComputeSurfaceOccupancy(unsigned int shellThickness) const;
+			ChunkOccupancy ComputeSurfaceOccupancy(const Nz::Boxui& blocks, unsigned int shellThickness) const;
+			Nz::UInt64 ComputeSurroundingBrickVersion(const Nz::Vector3ui& brickIndices, unsigned int brickRadius) const;
+			Nz::UInt32 ComputeVisibleFaces(Direction direction, const Nz::Vector3ui& blockIndices) const;
+
+			inline BlockIndex GetBlockContent(unsigned int blockIndex) const;
+			inline BlockIndex GetBlockContent(const Nz::Vector3ui& indices) const;
+			inline unsigned int GetBlockLocalIndex(const Nz::Vector3ui& indices) const;
+			inline const BlockStorage& GetBlockStorage() const;
+			inline Nz::Boxui GetBrickBlocks(const Nz::Vector3ui& brickIndices) const;
+			inline const Nz::Vector3ui& GetBrickGridSize() const;
+			inline unsigned int GetBrickLocalIndex(const Nz::Vector3ui& brickIndices) const;
+			inline Nz::UInt64 GetBrickVersion(const Nz::Vector3ui& brickIndices) const;
+			inline std::optional<BlockIndex> GetNeighborBlock(Nz::Vector3ui indices, const Nz::Vector3i& offsets) const;
+			Nz::UInt64 GetNeighborBrickVersion(const Nz::Vector3ui& brickIndices, Direction direction) const;
+			inline const ChunkOccupancy& GetOccupancy() const;
+			inline const Nz::Vector3ui& GetSize() const;
+			inline Nz::UInt64 GetVersion() const;
+
+			inline bool IsEmpty() const;
+			inline bool IsUniform() const;
+			bool IsUpToDate(const Chunk& chunk) const;
+
+			ChunkSnapshot& operator=(const ChunkSnapshot&) = default;
+			ChunkSnapshot& operator=(ChunkSnapshot&&) noexcept = default;
+
+		private:
+			Nz::UInt64 FindBrickVersion(const Nz::Vector3i& brickIndices) const;
+
+			std::shared_ptr<const ChunkContent> m_content;
+			Nz::EnumArray<Direction, std::shared_ptr<const ChunkContent>> m_neighborContents;
+			Nz::Vector3ui m_size;
+	};
+}
+
+#include <CommonLib/ChunkSnapshot.inl>
+
+#endif // TSOM_COMMONLIB_CHUNKSNAPSHOT_HPP
@@ -0,0 +1,173 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <algorithm>
+#include <cassert>
+
+namespace tsom
+{
+	inline ChunkContent::ChunkContent(const Nz::Vector3ui& size, Nz::UInt64 contentVersion) :
+	blocks(size.x * size.y * size.z, EmptyBlockIndex),
+	occupancy(size),
+	brickGridSize(ComputeBrickGridSize(size)),
+	brickVersions(brickGridSize.x * brickGridSize.y * brickGridSize.z, contentVersion),
+	version(contentVersion)
+	{
+	}
+
+	inline unsigned int ChunkContent::GetBrickLocalIndex(const Nz::Vector3ui& blockIndices) const
+	{
+		Nz::Vector3ui brickIndices = blockIndices / BrickSize;
+		return brickGridSize.x * (brickGridSize.y * brickIndices.z + brickIndices.y) + brickIndices.x;
+	}
+
+	inline void ChunkContent::InvalidateBrick(const Nz::Vector3ui& blockIndices)
+	{
+		brickVersions[GetBrickLocalIndex(blockIndices)] = version;
+	}
+
+	inline void ChunkContent::InvalidateBricks()
+	{
+		std::fill(brickVersions.begin(), brickVersions.end(), version);
+	}
+
+	inline Nz::Vector3ui ChunkContent::ComputeBrickGridSize(const Nz::Vector3ui& size)
+	{
+		return (size + Nz::Vector3ui(BrickSize - 1)) / BrickSize;
+	}
+
+	inline ChunkSnapshot::ChunkSnapshot(const Nz::Vector3ui& size, std::shared_ptr<const ChunkContent> content, Nz::EnumArray<Direction, std::shared_ptr<const ChunkContent>> neighborContents) :
+	m_content(std::move(content)),
+	m_neighborContents(std::move(neighborContents)),
+	m_size(size)
+	{
+	}
+
+	inline ChunkOccupancy ChunkSnapshot::ComputeSurfaceOccupancy(unsigned int shellThickness) const
+	{
+		return ComputeSurfaceOccupancy(Nz::Boxui(Nz::Vector3ui::Zero(), m_size), shellThickness);
+	}
+
+	inline BlockIndex ChunkSnapshot::GetBlockContent(unsigned int blockIndex) const
+	{
+		return m_content->blocks.GetBlock(blockIndex);
+	}
+
+	inline BlockIndex ChunkSnapshot::GetBlockContent(const Nz::Vector3ui& indices) const
+	{
+		return GetBlockContent(GetBlockLocalIndex(indices));
+	}
+
+	inline unsigned int ChunkSnapshot::GetBlockLocalIndex(const Nz::Vector3ui& indices) const
+	{
+		assert(indices.x < m_size.x);
+		assert(indices.y < m_size.y);
+		assert(indices.z < m_size.z);
+
+		return m_size.x * (m_size.y * indices.z + indices.y) + indices.x;
+	}
+
+	inline const BlockStorage& ChunkSnapshot::GetBlockStorage() const
+	{
+		return m_content->blocks;
+	}
+
+	inline Nz::Boxui ChunkSnapshot::GetBrickBlocks(const Nz::Vector3ui& brickIndices) const
+	{
+		Nz::Vector3ui firstBlock = brickIndices * ChunkContent::BrickSize;
+		Nz::Vector3ui lastBlock = firstBlock + Nz::Vector3ui(ChunkContent::BrickSize);
+		lastBlock.Minimize(m_size);
+
+		return Nz::Boxui(firstBlock, lastBlock - firstBlock);
+	}
+
+	inline const Nz::Vector3ui& ChunkSnapshot::GetBrickGridSize() const
+	{
+		return m_content->brickGridSize;
+	}
+
+	inline unsigned int ChunkSnapshot::GetBrickLocalIndex(const Nz::Vector3ui& brickIndices) const
+	{
+		const Nz::Vector3ui& brickGridSize = m_content->brickGridSize;
+		assert(brickIndices.x < brickGridSize.x);
+		assert(brickIndices.y < brickGridSize.y);
+		assert(brickIndices.z < brickGridSize.z);
+
+		return brickGridSize.x * (brickGridSize.y * brickIndices.z + brickIndices.y) + brickIndices.x;
+	}
+
+	inline Nz::UInt64 ChunkSnapshot::GetBrickVersion(const Nz::Vector3ui& brickIndices) const
+	{
+		return m_content->brickVersions[GetBrickLocalIndex(brickIndices)];
+	}
+
+	inline std::optional<BlockIndex> ChunkSnapshot::GetNeighborBlock(Nz::Vector3ui indices, const Nz::Vector3i& offsets) const
+	{
+		// Only direct neighbors are part of the snapshot, lookups can cross at most one chunk border
+		const ChunkContent* content = m_content.get();
+		auto MoveAlongAxis = [&](unsigned int& index, int offset, unsigned int size, Direction negativeDir, Direction positiveDir)
+		{
+			int newIndex = static_cast<int>(index) + offset;
+			if (newIndex < 0 || newIndex >= static_cast<int>(size))
+			{
+				if (content != m_content.get())
+					return false;
+
+				if (newIndex < 0)
+				{
+					content = m_neighborContents[negativeDir].get();
+					newIndex += static_cast<int>(size);
+				}
+				else
+				{
+					content = m_neighborContents[positiveDir].get();
+					newIndex -= static_cast<int>(size);
+				}
+
+				if (!content || newIndex < 0 || newIndex >= static_cast<int>(size))
+					return false;
+			}
+
+			index = static_cast<unsigned int>(newIndex);
+			return true;
+		};
+
+		// Local Y and Z axis are swapped compared to chunk directions
+		if (!MoveAlongAxis(indices.x, offsets.x, m_size.x, Direction::Left, Direction::Right))
+			return {};
+
+		if (!MoveAlongAxis(indices.y, offsets.y, m_size.y, Direction::Front, Direction::Back))
+			return {};
+
+		if (!MoveAlongAxis(indices.z, offsets.z, m_size.z, Direction::Down, Direction::Up))
+			return {};
+
+		return content->blocks.GetBlock(GetBlockLocalIndex(indices));
+	}
+
+	inline const ChunkOccupancy& ChunkSnapshot::GetOccupancy() const
+	{
+		return m_content->occupancy;
+	}
+
+	inline const Nz::Vector3ui& ChunkSnapshot::GetSize() const
+	{
+		return m_size;
+	}
+
+	inline Nz::UInt64 ChunkSnapshot::GetVersion() const
+	{
+		return m_content->version;
+	}
+
+	inline bool ChunkSnapshot::IsEmpty() const
+	{
+		return m_content->blocks.IsUniform() && m_content->blocks.GetBlock(0) == EmptyBlockIndex;
+	}
+
+	inline bool ChunkSnapshot::IsUniform() const
+	{
+		return m_content->blocks.IsUniform();
+	}
+}
@@ -0,0 +1,100 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com) (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_COMMONLIB_CHUNKSTREAMER_HPP
+#define TSOM_COMMONLIB_CHUNKSTREAMER_HPP
+
+#include <CommonLib/Export.hpp>
+#include <CommonLib/Chunk.hpp>
+#include <Nazara/Math/Vector3.hpp>
+#include <tsl/hopscotch_set.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+namespace Nz
+{
+	class TaskScheduler;
+}
+
+namespace tsom
+{
+	class BlockLibrary;
+	class Planet;
+
+	// Generates planet chunks on worker threads once a viewer comes close to them, instead of generating the whole planet up front
+	// chunks are built outside of the planet and only added to it (on the calling thread) once complete, they are never unloaded
+	class TSOM_COMMONLIB_API ChunkStreamer
+	{
+		public:
+			struct Settings;
+
+			using LoadCallback = std::function<bool(Chunk& chunk)>;
+
+			ChunkStreamer(Planet& planet, const BlockLibrary& blockLibrary, Nz::TaskScheduler& taskScheduler, Nz::UInt32 seed, const Nz::Vector3ui& chunkCount);
+			ChunkStreamer(const ChunkStreamer&) = delete;
+			ChunkStreamer(ChunkStreamer&&) = delete;
+			~ChunkStreamer();
+
+			void GenerateChunks(std::span<const ChunkIndices> chunkIndices);
+
+			inline std::size_t GetRequestedChunkCount() const;
+			inline unsigned int GetRunningChunkCount() const;
+			inline const Settings& GetSettings() const;
+
+			bool IsInViewRadius(const ChunkIndices& chunkIndices, const Nz::Vector3f& viewerPosition, float margin = 0.f) const;
+			inline bool IsInsidePlanet(const ChunkIndices& chunkIndices) const;
+
+			inline void SetLoadCallback(LoadCallback loadCallback);
+			inline void SetSettings(const Settings& settings);
+
+			void Update(std::span<const Nz::Vector3f> viewerPositions);
+
+			ChunkStreamer& operator=(const ChunkStreamer&) = delete;
+			ChunkStreamer& operator=(ChunkStreamer&&) = delete;
+
+			struct Settings
+			{
+				float viewRadius = 160.f; //< chunks are generated once a viewer gets closer than this distance to their center
+				unsigned int maxRunningChunks = 8; //< chunks being generated at the same time
+				unsigned int maxStartedChunks = 4; //< chunks starting their generation each update
+			};
+
+		private:
+			struct StreamingState;
+
+			void PublishChunks();
+			void StartChunk(const ChunkIndices& chunkIndices);
+			void WaitForRunningChunks();
+
+			struct StreamingState
+			{
+				std::atomic_bool cancelled = false;
+				std::atomic_uint runningChunkCount = 0;
+				std::mutex finishedChunkMutex;
+				std::vector<std::unique_ptr<Chunk>> finishedChunks;
+			};
+
+			std::shared_ptr<StreamingState> m_state; //< shared with generation tasks, which still notify it once the streamer may be gone
+			std::vector<std::pair<float /*viewerDistanceSq*/, ChunkIndices>> m_candidates;
+			std::vector<std::unique_ptr<Chunk>> m_publishQueue;
+			tsl::hopscotch_set<ChunkIndices> m_requestedChunks; //< chunks being generated or waiting to be published
+			LoadCallback m_loadCallback;
+			Settings m_settings;
+			Nz::TaskScheduler& m_taskScheduler;
+			Nz::UInt32 m_seed;
+			Nz::Vector3ui m_chunkCount;
+			const BlockLibrary& m_blockLibrary;
+			Planet& m_planet;
+	};
+}
+
+#include <CommonLib/ChunkStreamer.inl>
+
+#endif // TSOM_COMMONLIB_CHUNKSTREAMER_HPP
@@ -0,0 +1,44 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com) (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+namespace tsom
+{
+	inline std::size_t ChunkStreamer::GetRequestedChunkCount() const
+	{
+		return m_requestedChunks.size();
+	}
+
+	inline unsigned int ChunkStreamer::GetRunningChunkCount() const
+	{
+		return m_state->runningChunkCount;
+	}
+
+	inline auto ChunkStreamer::GetSettings() const -> const Settings&
+	{
+		return m_settings;
+	}
+
+	inline bool ChunkStreamer::IsInsidePlanet(const ChunkIndices& chunkIndices) const
+	{
+		// Planet chunks go from -(count / 2) to count - count / 2 - 1 on each axis
+		for (std::size_t i = 0; i < 3; ++i)
+		{
+			int halfCount = int(m_chunkCount[i] / 2);
+			if (chunkIndices[i] < -halfCount || chunkIndices[i] >= int(m_chunkCount[i]) - halfCount)
+				return false;
+		}
+
+		return true;
+	}
+
+	inline void ChunkStreamer::SetLoadCallback(LoadCallback loadCallback)
+	{
+		m_loadCallback = std::move(loadCallback);
+	}
+
+	inline void ChunkStreamer::SetSettings(const Settings& settings)
+	{
+		m_settings = settings;
+	}
+}
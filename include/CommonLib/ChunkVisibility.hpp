@@ -0,0 +1,55 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com) (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_COMMONLIB_CHUNKVISIBILITY_HPP
+#define TSOM_COMMONLIB_CHUNKVISIBILITY_HPP
+
+#include <CommonLib/Export.hpp>
+#include <CommonLib/Chunk.hpp>
+#include <CommonLib/ChunkConnectivity.hpp>
+#include <Nazara/Math/Box.hpp>
+#include <NazaraUtils/FunctionRef.hpp>
+#include <tsl/hopscotch_map.h>
+#include <vector>
+
+namespace tsom
+{
+	// Potentially visible chunks from a viewer (cave culling), found by flood filling chunks from the viewer chunk
+	// sight only crosses a chunk between connected faces, and never goes back toward the viewer
+	class TSOM_COMMONLIB_API ChunkVisibility
+	{
+		public:
+			ChunkVisibility() = default;
+			ChunkVisibility(const ChunkVisibility&) = delete;
+			ChunkVisibility(ChunkVisibility&&) = delete;
+			~ChunkVisibility() = default;
+
+			void Compute(const ChunkIndices& viewerChunk, const Nz::Boxi& chunkBounds, const Nz::FunctionRef<const ChunkConnectivity*(const ChunkIndices& chunkIndices)>& connectivityCallback);
+
+			inline std::size_t GetVisibleChunkCount() const;
+
+			inline bool IsVisible(const ChunkIndices& chunkIndices) const;
+
+			ChunkVisibility& operator=(const ChunkVisibility&) = delete;
+			ChunkVisibility& operator=(ChunkVisibility&&) = delete;
+
+		private:
+			struct PendingChunk
+			{
+				ChunkIndices indices;
+				Direction entryFace;
+				Nz::UInt8 directions; //< directions followed from the viewer chunk
+				bool isViewerChunk;
+			};
+
+			std::vector<PendingChunk> m_pendingChunks;
+			tsl::hopscotch_map<ChunkIndices, Nz::UInt8> m_visitedChunks; //< faces sight entered each visible chunk from
+	};
+}
+
+#include <CommonLib/ChunkVisibility.inl>
+
+#endif // TSOM_COMMONLIB_CHUNKVISIBILITY_HPP
@@ -0,0 +1,16 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com) (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+namespace tsom
+{
+	inline std::size_t ChunkVisibility::GetVisibleChunkCount() const
+	{
+		return m_visitedChunks.size();
+	}
+
+	inline bool ChunkVisibility::IsVisible(const ChunkIndices& chunkIndices) const
+	{
+		return m_visitedChunks.contains(chunkIndices);
+	}
+}
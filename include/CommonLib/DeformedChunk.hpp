@@ -8,10 +8,11 @@
 #define TSOM_COMMONLIB_DEFORMEDCHUNK_HPP
 
 #include <CommonLib/Chunk.hpp>
+#include <vector>
 
 namespace tsom
 {
-	class DeformedChunk : public Chunk
+	class DeformedChunk final : public Chunk
 	{
 		public:
 			inline DeformedChunk(ChunkContainer& owner, const ChunkIndices& indices, const Nz::Vector3ui& size, float cellSize, const Nz::Vector3f& deformationCenter, float deformationRadius);
@@ -19,19 +20,27 @@ namespace tsom
 			DeformedChunk(DeformedChunk&&) = delete;
 			~DeformedChunk() = default;
 
-			std::shared_ptr<Nz::Collider3D> BuildCollider(const BlockLibrary& blockManager) const override;
+			using Chunk::BuildCollider;
+			std::shared_ptr<Nz::Collider3D> BuildCollider(const BlockLibrary& blockManager, const ChunkSnapshot& snapshot, const Nz::Boxui& blocks, const ColliderSettings& settings) const override;
 
 			std::optional<Nz::Vector3ui> ComputeCoordinates(const Nz::Vector3f& position) const override;
+			Nz::UInt64 ComputeGeometryHash() const override;
 			Nz::EnumArray<Nz::BoxCorner, Nz::Vector3f> ComputeVoxelCorners(const Nz::Vector3ui& indices) const override;
 
 			Nz::Vector3f DeformPosition(const Nz::Vector3f& position) const;
 
+			inline const Nz::Vector3f& GetLatticePosition(const Nz::Vector3ui& latticeIndices) const;
+
 			inline void UpdateDeformationRadius(float deformationRadius);
 
 			DeformedChunk& operator=(const DeformedChunk&) = delete;
 			DeformedChunk& operator=(DeformedChunk&&) = delete;
 
 		private:
+			inline std::size_t GetLatticeIndex(const Nz::Vector3ui& latticeIndices) const;
+			void UpdateLattice();
+
+			std::vector<Nz::Vector3f> m_lattice; //< deformed block corners, (size + 1)^3 positions indexed by block indices
 			Nz::Vector3f m_deformationCenter;
 			float m_deformationRadius;
 	};
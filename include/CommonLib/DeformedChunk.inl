@@ -2,6 +2,8 @@
 // This file is part of the "This Space Of Mine" project
 // For conditions of distribution and use, see copyright notice in LICENSE
 
+#include <cassert>
+
 namespace tsom
 {
 	inline DeformedChunk::DeformedChunk(ChunkContainer& owner, const ChunkIndices& indices, const Nz::Vector3ui& size, float cellSize, const Nz::Vector3f& deformationCenter, float deformationRadius) :
@@ -9,10 +11,26 @@ namespace tsom
 	m_deformationCenter(deformationCenter),
 	m_deformationRadius(deformationRadius)
 	{
+		UpdateLattice();
+	}
+
+	inline const Nz::Vector3f& DeformedChunk::GetLatticePosition(const Nz::Vector3ui& latticeIndices) const
+	{
+		return m_lattice[GetLatticeIndex(latticeIndices)];
 	}
 
 	inline void DeformedChunk::UpdateDeformationRadius(float deformationRadius)
 	{
+		if (m_deformationRadius == deformationRadius)
+			return;
+
 		m_deformationRadius = deformationRadius;
+		UpdateLattice();
+	}
+
+	inline std::size_t DeformedChunk::GetLatticeIndex(const Nz::Vector3ui& latticeIndices) const
+	{
+		assert(latticeIndices.x <= m_size.x && latticeIndices.y <= m_size.y && latticeIndices.z <= m_size.z);
+		return (std::size_t(latticeIndices.z) * (m_size.y + 1) + latticeIndices.y) * (m_size.x + 1) + latticeIndices.x;
 	}
 }
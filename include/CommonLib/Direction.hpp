@@ -34,6 +34,16 @@ namespace tsom
 		Nz::Vector3f::Up()
 	};
 
+	// Local block offset of each direction (local Y and Z axis are swapped compared to directions)
+	constexpr Nz::EnumArray<Direction, Nz::Vector3i> s_blockDirOffsets = {
+		Nz::Vector3i( 0,  1,  0), //< Back
+		Nz::Vector3i( 0,  0, -1), //< Down
+		Nz::Vector3i( 0, -1,  0), //< Front
+		Nz::Vector3i(-1,  0,  0), //< Left
+		Nz::Vector3i( 1,  0,  0), //< Right
+		Nz::Vector3i( 0,  0,  1), //< Up
+	};
+
 	// Debug colors
 	constexpr Nz::EnumArray<Direction, Nz::Color> s_dirColors = {
 		Nz::Color::Green(), //< Back
@@ -64,6 +74,7 @@ namespace tsom
 	};
 
 	constexpr Direction DirectionFromNormal(const Nz::Vector3f& outsideNormal);
+	constexpr Direction OppositeDirection(Direction direction);
 }
 
 #include <CommonLib/Direction.inl>
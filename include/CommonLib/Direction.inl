@@ -19,4 +19,19 @@ namespace tsom
 
 		return closestDir;
 	}
+
+	constexpr Direction OppositeDirection(Direction direction)
+	{
+		switch (direction)
+		{
+			case Direction::Back:  return Direction::Front;
+			case Direction::Down:  return Direction::Up;
+			case Direction::Front: return Direction::Back;
+			case Direction::Left:  return Direction::Right;
+			case Direction::Right: return Direction::Left;
+			case Direction::Up:    return Direction::Down;
+		}
+
+		NAZARA_UNREACHABLE();
+	}
 }
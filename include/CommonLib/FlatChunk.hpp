@@ -11,7 +11,7 @@
 
 namespace tsom
 {
-	class FlatChunk : public Chunk
+	class FlatChunk final : public Chunk
 	{
 		public:
 			using Chunk::Chunk;
@@ -19,12 +19,16 @@ namespace tsom
 			FlatChunk(FlatChunk&&) = delete;
 			~FlatChunk() = default;
 
-			std::shared_ptr<Nz::Collider3D> BuildCollider(const BlockLibrary& blockManager) const override;
+			using Chunk::BuildCollider;
+			std::shared_ptr<Nz::Collider3D> BuildCollider(const BlockLibrary& blockManager, const ChunkSnapshot& snapshot, const Nz::Boxui& blocks, const ColliderSettings& settings) const override;
+			void BuildGreedyMesh(const BlockLibrary& blockManager, const ChunkSnapshot& snapshot, const Nz::Boxui& blocks, std::vector<Nz::UInt32>& indices, const Nz::Vector3f& center, const Nz::FunctionRef<VertexAttributes(Nz::UInt32 count)>& addVertices) const override;
 			std::optional<Nz::Vector3ui> ComputeCoordinates(const Nz::Vector3f& position) const override;
 			Nz::EnumArray<Nz::BoxCorner, Nz::Vector3f> ComputeVoxelCorners(const Nz::Vector3ui& indices) const override;
 
 			FlatChunk& operator=(const FlatChunk&) = delete;
 			FlatChunk& operator=(FlatChunk&&) = delete;
+
+			static constexpr bool HasAxisAlignedBlocks = true;
 	};
 }
 
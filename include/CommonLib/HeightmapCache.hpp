@@ -0,0 +1,74 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com) (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_COMMONLIB_HEIGHTMAPCACHE_HPP
+#define TSOM_COMMONLIB_HEIGHTMAPCACHE_HPP
+
+#include <CommonLib/Export.hpp>
+#include <CommonLib/Direction.hpp>
+#include <CommonLib/Utility/LruCache.hpp>
+#include <Nazara/Math/Vector2.hpp>
+#include <NazaraUtils/FunctionRef.hpp>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace tsom
+{
+	// Heightmap tiles of planet face columns, computed once and shared by all the chunks stacked along the face normal
+	// tiles are evicted once all the chunks of their column acquired them, or when too many columns are partially generated
+	// (streamed chunks may never complete their columns), in which case the next chunks of the column compute the tile again
+	class TSOM_COMMONLIB_API HeightmapCache
+	{
+		public:
+			using ComputeCallback = Nz::FunctionRef<void(std::vector<double>& heights)>;
+
+			explicit HeightmapCache(std::size_t capacity = DefaultCapacity);
+			HeightmapCache(const HeightmapCache&) = delete;
+			HeightmapCache(HeightmapCache&&) = delete;
+			~HeightmapCache() = default;
+
+			std::shared_ptr<const std::vector<double>> Acquire(Direction face, const Nz::Vector2i& column, unsigned int columnChunkCount, const ComputeCallback& computeHeights);
+
+			void Clear();
+
+			std::size_t GetCapacity() const;
+			std::size_t GetTileCount() const;
+
+			HeightmapCache& operator=(const HeightmapCache&) = delete;
+			HeightmapCache& operator=(HeightmapCache&&) = delete;
+
+			static constexpr std::size_t DefaultCapacity = 1024; //< tiles of 32x32 heights, 8MiB
+
+		private:
+			struct Tile
+			{
+				std::once_flag computeFlag;
+				std::vector<double> heights;
+				unsigned int remainingUses; //< protected by the cache mutex
+			};
+
+			struct TileKey
+			{
+				Direction face;
+				Nz::Vector2i column;
+
+				inline bool operator==(const TileKey& other) const;
+			};
+
+			struct TileKeyHasher
+			{
+				inline std::size_t operator()(const TileKey& key) const;
+			};
+
+			mutable std::mutex m_mutex;
+			LruCache<TileKey, std::shared_ptr<Tile>, TileKeyHasher> m_tiles;
+	};
+}
+
+#include <CommonLib/HeightmapCache.inl>
+
+#endif // TSOM_COMMONLIB_HEIGHTMAPCACHE_HPP
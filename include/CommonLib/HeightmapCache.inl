@@ -0,0 +1,21 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com) (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <NazaraUtils/Algorithm.hpp>
+
+namespace tsom
+{
+	inline bool HeightmapCache::TileKey::operator==(const TileKey& other) const
+	{
+		return face == other.face && column == other.column;
+	}
+
+	inline std::size_t HeightmapCache::TileKeyHasher::operator()(const TileKey& key) const
+	{
+		std::size_t seed = std::hash<int>{}(static_cast<int>(key.face));
+		Nz::HashCombine(seed, key.column.x);
+		Nz::HashCombine(seed, key.column.y);
+		return seed;
+	}
+}
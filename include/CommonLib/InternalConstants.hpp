@@ -20,7 +20,7 @@ namespace tsom::Constants
 	constexpr Nz::Time TickDuration = Nz::Time::TickDuration(60);
 
 	// Serialization constants
-	constexpr Nz::UInt32 ChunkBinaryVersion = 1;
+	constexpr Nz::UInt32 ChunkBinaryVersion = 2;
 }
 
 #endif // TSOM_COMMONLIB_INTERNALCONSTANTS_HPP
@@ -8,11 +8,14 @@
 #define TSOM_COMMONLIB_PLANET_HPP
 
 #include <CommonLib/Export.hpp>
+#include <CommonLib/BatchPerlinNoise.hpp>
 #include <CommonLib/ChunkContainer.hpp>
 #include <CommonLib/Direction.hpp>
+#include <CommonLib/HeightmapCache.hpp>
 #include <NazaraUtils/FunctionRef.hpp>
 #include <tsl/hopscotch_map.h>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 namespace Nz
@@ -25,20 +28,24 @@ namespace tsom
 	class TSOM_COMMONLIB_API Planet : public ChunkContainer
 	{
 		public:
+			enum class GenerationPath;
+			struct GenerationStats;
+
 			Planet(float tileSize, float cornerRadius, float gravityFactor);
 			Planet(const Planet&) = delete;
 			Planet(Planet&&) = delete;
 			~Planet() = default;
 
 			Chunk& AddChunk(const ChunkIndices& indices, const Nz::FunctionRef<void(BlockIndex* blocks)>& initCallback = nullptr);
+			Chunk& AddChunk(std::unique_ptr<Chunk> chunk);
 
 			Nz::Vector3f ComputeUpDirection(const Nz::Vector3f& position) const;
 
 			void ForEachChunk(Nz::FunctionRef<void(const ChunkIndices& chunkIndices, Chunk& chunk)> callback) override;
 			void ForEachChunk(Nz::FunctionRef<void(const ChunkIndices& chunkIndices, const Chunk& chunk)> callback) const override;
 
-			void GenerateChunk(const BlockLibrary& blockLibrary, Chunk& chunk, Nz::UInt32 seed, const Nz::Vector3ui& chunkCount);
-			void GenerateChunks(const BlockLibrary& blockLibrary, Nz::TaskScheduler& taskScheduler, Nz::UInt32 seed, const Nz::Vector3ui& chunkCount);
+			GenerationPath GenerateChunk(const BlockLibrary& blockLibrary, Chunk& chunk, Nz::UInt32 seed, const Nz::Vector3ui& chunkCount, bool classifyChunk = true);
+			GenerationStats GenerateChunks(const BlockLibrary& blockLibrary, Nz::TaskScheduler& taskScheduler, Nz::UInt32 seed, const Nz::Vector3ui& chunkCount);
 			void GeneratePlatform(const BlockLibrary& blockLibrary, Direction upDirection, const BlockIndices& platformCenter);
 
 			inline Nz::Vector3f GetCenter() const override;
@@ -46,29 +53,77 @@ namespace tsom
 			inline const Chunk* GetChunk(const ChunkIndices& chunkIndices) const override;
 			inline std::size_t GetChunkCount() const override;
 			inline float GetCornerRadius() const;
+			inline unsigned int GetGeneratorVersion() const;
 			inline float GetGravityFactor(const Nz::Vector3f& position) const;
 
 			void RemoveChunk(const ChunkIndices& indices);
 
+			inline void SetGeneratorVersion(unsigned int generatorVersion);
+
 			inline void UpdateCornerRadius(float cornerRadius);
 
 			Planet& operator=(const Planet&) = delete;
 			Planet& operator=(Planet&&) = delete;
 
+			// Chunks above the terrain are filled at once, chunks out of reach of the surface skip the noise and surface passes
+			enum class GenerationPath
+			{
+				Empty,      //< above the terrain, filled at once
+				Surface,    //< terrain layers carved by the surface noise
+				LayersOnly  //< terrain layers only (still block by block), out of reach of the surface
+			};
+
+			struct GenerationStats
+			{
+				std::size_t emptyChunkCount = 0;
+				std::size_t layersOnlyChunkCount = 0;
+				std::size_t surfaceChunkCount = 0;
+			};
+
 			static constexpr unsigned int ChunkSize = 32;
+			static constexpr unsigned int GeneratorVersion = 2; //< 1: blocks past the planet height were filled as deep layers
 
 		protected:
+			struct ChunkGenerationBounds;
+			struct TerrainNoise;
+
+			ChunkGenerationBounds ComputeGenerationBounds(const ChunkIndices& chunkIndices, const Nz::Vector3ui& chunkCount) const;
+			unsigned int CountSurfaceChunks(const ChunkIndices& chunkIndices, Direction face, const Nz::Vector3ui& chunkCount) const;
+			std::shared_ptr<const TerrainNoise> GetTerrainNoise(Nz::UInt32 seed);
+			void NotifyNeighborUpdate(Chunk* chunk, Direction direction);
+
 			struct ChunkData
 			{
 				std::unique_ptr<Chunk> chunk;
 
-				NazaraSlot(Chunk, OnBlockUpdated, onUpdated);
+				NazaraSlot(Chunk, OnBlocksUpdated, onUpdated);
 				NazaraSlot(Chunk, OnReset, onReset);
 			};
 
+			struct ChunkGenerationBounds
+			{
+				Nz::EnumArray<Direction, bool> surfaceFaces; //< faces whose surface pass can carve the chunk
+				bool empty; //< whole chunk is above the terrain layers
+			};
+
+			struct TerrainNoise
+			{
+				Nz::EnumArray<Direction, BatchPerlinNoise> faceNoises;
+				Nz::UInt32 seed;
+			};
+
+			static int ComputeTerrainDepth(double noise, int maxHeight);
+
+			static constexpr double TerrainHeightScale = 1.5;
+			static constexpr std::size_t TerrainFreeSpace = 30;
+
+			std::shared_ptr<const TerrainNoise> m_terrainNoise;
 			tsl::hopscotch_map<ChunkIndices, ChunkData> m_chunks;
+			std::mutex m_terrainNoiseMutex;
+			HeightmapCache m_heightmapCache;
 			float m_cornerRadius;
 			float m_gravityFactor;
+			unsigned int m_generatorVersion;
 	};
 }
 
@@ -2,6 +2,8 @@
 // This file is part of the "This Space Of Mine" project
 // For conditions of distribution and use, see copyright notice in LICENSE
 
+#include <cassert>
+
 namespace tsom
 {
 	inline Nz::Vector3f Planet::GetCenter() const
@@ -37,6 +39,11 @@ namespace tsom
 		return m_cornerRadius;
 	}
 
+	inline unsigned int Planet::GetGeneratorVersion() const
+	{
+		return m_generatorVersion;
+	}
+
 	inline float Planet::GetGravityFactor(const Nz::Vector3f& position) const
 	{
 		if (position.SquaredDistance(GetCenter()) < Nz::IntegralPow(10.f, 2))
@@ -45,6 +52,13 @@ namespace tsom
 		return m_gravityFactor;
 	}
 
+	// Worlds keep the generator version they were created with, so that chunks which were never saved generate the same
+	inline void Planet::SetGeneratorVersion(unsigned int generatorVersion)
+	{
+		assert(generatorVersion >= 1 && generatorVersion <= GeneratorVersion);
+		m_generatorVersion = generatorVersion;
+	}
+
 	inline void Planet::UpdateCornerRadius(float cornerRadius)
 	{
 		m_cornerRadius = cornerRadius;
@@ -0,0 +1,31 @@
+// Copyright (C) 2024 Jérôme Leclercq
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_COMMONLIB_UTILITY_CONTENTHASHER_HPP
+#define TSOM_COMMONLIB_UTILITY_CONTENTHASHER_HPP
+
+#include <NazaraUtils/Prerequisites.hpp>
+
+namespace tsom
+{
+	// Fast 64-bit hash of a sequence of words, to recognize identical contents (not meant to resist crafted collisions)
+	class ContentHasher
+	{
+		public:
+			ContentHasher() = default;
+
+			inline void Append(Nz::UInt64 value);
+
+			inline Nz::UInt64 GetHash() const;
+
+		private:
+			Nz::UInt64 m_state = 0x9E3779B97F4A7C15;
+	};
+}
+
+#include <CommonLib/Utility/ContentHasher.inl>
+
+#endif // TSOM_COMMONLIB_UTILITY_CONTENTHASHER_HPP
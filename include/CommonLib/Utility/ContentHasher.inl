@@ -0,0 +1,27 @@
+// Copyright (C) 2024 Jérôme Leclercq
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <bit>
+
+namespace tsom
+{
+	inline void ContentHasher::Append(Nz::UInt64 value)
+	{
+		// Each step is a bijection of the state, so that a single word difference always changes the hash
+		m_state = std::rotl(m_state ^ (value * 0x87C37B91114253D5), 31) * 0x4CF5AD432745937F;
+	}
+
+	inline Nz::UInt64 ContentHasher::GetHash() const
+	{
+		// MurmurHash3 finalizer, spreads the last words over all bits
+		Nz::UInt64 hash = m_state;
+		hash ^= hash >> 33;
+		hash *= 0xFF51AFD7ED558CCD;
+		hash ^= hash >> 33;
+		hash *= 0xC4CEB9FE1A85EC53;
+		hash ^= hash >> 33;
+
+		return hash;
+	}
+}
@@ -0,0 +1,60 @@
+// Copyright (C) 2024 Jérôme Leclercq
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_COMMONLIB_UTILITY_LRUCACHE_HPP
+#define TSOM_COMMONLIB_UTILITY_LRUCACHE_HPP
+
+#include <tsl/hopscotch_map.h>
+#include <functional>
+#include <list>
+#include <utility>
+
+namespace tsom
+{
+	// Bounded key/value cache, evicting the least recently used entries first
+	template<typename K, typename V, typename Hash = std::hash<K>>
+	class LruCache
+	{
+		public:
+			explicit LruCache(std::size_t capacity);
+			LruCache(const LruCache&) = delete;
+			LruCache(LruCache&&) noexcept = default;
+			~LruCache() = default;
+
+			void Clear();
+
+			void Erase(const K& key);
+
+			const V* Find(const K& key);
+
+			std::size_t GetCapacity() const;
+			std::size_t GetHitCount() const;
+			std::size_t GetMissCount() const;
+			std::size_t GetSize() const;
+
+			void Insert(K key, V value);
+
+			void SetCapacity(std::size_t capacity);
+
+			LruCache& operator=(const LruCache&) = delete;
+			LruCache& operator=(LruCache&&) noexcept = default;
+
+		private:
+			void Evict();
+
+			using EntryList = std::list<std::pair<K, V>>;
+
+			EntryList m_entries; //< most recently used first
+			tsl::hopscotch_map<K, typename EntryList::iterator, Hash> m_entryByKey;
+			std::size_t m_capacity;
+			std::size_t m_hitCount;
+			std::size_t m_missCount;
+	};
+}
+
+#include <CommonLib/Utility/LruCache.inl>
+
+#endif // TSOM_COMMONLIB_UTILITY_LRUCACHE_HPP
@@ -0,0 +1,111 @@
+// Copyright (C) 2024 Jérôme Leclercq
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CommonLib/Utility/LruCache.hpp>
+
+namespace tsom
+{
+	template<typename K, typename V, typename Hash>
+	LruCache<K, V, Hash>::LruCache(std::size_t capacity) :
+	m_capacity(capacity),
+	m_hitCount(0),
+	m_missCount(0)
+	{
+	}
+
+	template<typename K, typename V, typename Hash>
+	void LruCache<K, V, Hash>::Clear()
+	{
+		m_entries.clear();
+		m_entryByKey.clear();
+	}
+
+	template<typename K, typename V, typename Hash>
+	void LruCache<K, V, Hash>::Erase(const K& key)
+	{
+		auto it = m_entryByKey.find(key);
+		if (it == m_entryByKey.end())
+			return;
+
+		m_entries.erase(it->second);
+		m_entryByKey.erase(it);
+	}
+
+	template<typename K, typename V, typename Hash>
+	const V* LruCache<K, V, Hash>::Find(const K& key)
+	{
+		auto it = m_entryByKey.find(key);
+		if (it == m_entryByKey.end())
+		{
+			m_missCount++;
+			return nullptr;
+		}
+
+		m_hitCount++;
+
+		// List nodes are stable, moving the entry to the front doesn't invalidate the iterator
+		m_entries.splice(m_entries.begin(), m_entries, it->second);
+		return &it->second->second;
+	}
+
+	template<typename K, typename V, typename Hash>
+	std::size_t LruCache<K, V, Hash>::GetCapacity() const
+	{
+		return m_capacity;
+	}
+
+	template<typename K, typename V, typename Hash>
+	std::size_t LruCache<K, V, Hash>::GetHitCount() const
+	{
+		return m_hitCount;
+	}
+
+	template<typename K, typename V, typename Hash>
+	std::size_t LruCache<K, V, Hash>::GetMissCount() const
+	{
+		return m_missCount;
+	}
+
+	template<typename K, typename V, typename Hash>
+	std::size_t LruCache<K, V, Hash>::GetSize() const
+	{
+		return m_entries.size();
+	}
+
+	template<typename K, typename V, typename Hash>
+	void LruCache<K, V, Hash>::Insert(K key, V value)
+	{
+		if (m_capacity == 0)
+			return;
+
+		if (auto it = m_entryByKey.find(key); it != m_entryByKey.end())
+		{
+			it->second->second = std::move(value);
+			m_entries.splice(m_entries.begin(), m_entries, it->second);
+			return;
+		}
+
+		m_entries.emplace_front(key, std::move(value));
+		m_entryByKey.emplace(std::move(key), m_entries.begin());
+
+		Evict();
+	}
+
+	template<typename K, typename V, typename Hash>
+	void LruCache<K, V, Hash>::SetCapacity(std::size_t capacity)
+	{
+		m_capacity = capacity;
+		Evict();
+	}
+
+	template<typename K, typename V, typename Hash>
+	void LruCache<K, V, Hash>::Evict()
+	{
+		while (m_entries.size() > m_capacity)
+		{
+			m_entryByKey.erase(m_entries.back().first);
+			m_entries.pop_back();
+		}
+	}
+}
@@ -0,0 +1,46 @@
+// Copyright (C) 2024 Jérôme Leclercq
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef TSOM_COMMONLIB_UTILITY_SHAREDOBJECTPOOL_HPP
+#define TSOM_COMMONLIB_UTILITY_SHAREDOBJECTPOOL_HPP
+
+#include <memory>
+#include <vector>
+
+namespace tsom
+{
+	// Recycles objects shared with worker tasks instead of allocating new ones, released objects are only reused once nobody else holds them
+	// recycled objects are destroyed and constructed again in place, keeping their storage and shared pointer control block
+	// (or handed to a recycle callback instead, to keep the storage they own as well)
+	template<typename T>
+	class SharedObjectPool
+	{
+		public:
+			explicit SharedObjectPool(std::size_t capacity);
+			SharedObjectPool(const SharedObjectPool&) = delete;
+			SharedObjectPool(SharedObjectPool&&) noexcept = default;
+			~SharedObjectPool() = default;
+
+			std::shared_ptr<T> Acquire();
+			template<typename F> std::shared_ptr<T> Acquire(F&& recycle);
+
+			std::size_t GetCapacity() const;
+			std::size_t GetFreeCount() const;
+
+			void Release(std::shared_ptr<T> object);
+
+			SharedObjectPool& operator=(const SharedObjectPool&) = delete;
+			SharedObjectPool& operator=(SharedObjectPool&&) noexcept = default;
+
+		private:
+			std::vector<std::shared_ptr<T>> m_freeObjects;
+			std::size_t m_capacity;
+	};
+}
+
+#include <CommonLib/Utility/SharedObjectPool.inl>
+
+#endif // TSOM_COMMONLIB_UTILITY_SHAREDOBJECTPOOL_HPP
@@ -0,0 +1,75 @@
+// Copyright (C) 2024 Jérôme Leclercq
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CommonLib/Utility/SharedObjectPool.hpp>
+#include <algorithm>
+#include <atomic>
+
+namespace tsom
+{
+	template<typename T>
+	SharedObjectPool<T>::SharedObjectPool(std::size_t capacity) :
+	m_capacity(capacity)
+	{
+	}
+
+	template<typename T>
+	std::shared_ptr<T> SharedObjectPool<T>::Acquire()
+	{
+		return Acquire([](T& object)
+		{
+			std::destroy_at(&object);
+			std::construct_at(&object);
+		});
+	}
+
+	template<typename T>
+	template<typename F>
+	std::shared_ptr<T> SharedObjectPool<T>::Acquire(F&& recycle)
+	{
+		// Oldest released objects first, the most recently released ones are the most likely to still be held by a task
+		for (auto it = m_freeObjects.begin(); it != m_freeObjects.end(); ++it)
+		{
+			if (it->use_count() != 1)
+				continue;
+
+			// Pairs with the release of the last other owner, so its writes to the object happen before it gets recycled
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+			std::shared_ptr<T> object = std::move(*it);
+			m_freeObjects.erase(it);
+
+			recycle(*object);
+
+			return object;
+		}
+
+		return std::make_shared<T>();
+	}
+
+	template<typename T>
+	std::size_t SharedObjectPool<T>::GetCapacity() const
+	{
+		return m_capacity;
+	}
+
+	template<typename T>
+	std::size_t SharedObjectPool<T>::GetFreeCount() const
+	{
+		return m_freeObjects.size();
+	}
+
+	template<typename T>
+	void SharedObjectPool<T>::Release(std::shared_ptr<T> object)
+	{
+		if (!object || m_freeObjects.size() >= m_capacity)
+			return;
+
+		// Objects shared by several owners may be released by each of them
+		if (std::find(m_freeObjects.begin(), m_freeObjects.end(), object) != m_freeObjects.end())
+			return;
+
+		m_freeObjects.push_back(std::move(object));
+	}
+}
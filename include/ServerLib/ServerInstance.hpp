@@ -9,6 +9,7 @@
 
 #include <CommonLib/BlockLibrary.hpp>
 #include <CommonLib/ChunkEntities.hpp>
+#include <CommonLib/ChunkStreamer.hpp>
 #include <CommonLib/NetworkSessionManager.hpp>
 #include <CommonLib/Planet.hpp>
 #include <ServerLib/ServerPlayer.hpp>
@@ -60,23 +61,33 @@ namespace tsom
 
 			struct Config
 			{
+				Chunk::ColliderSettings chunkColliderSettings;
+				ChunkEntities::ColliderResidencySettings chunkColliderResidency;
+				ChunkEntities::JobApplySettings chunkJobApply;
+				ChunkStreamer::Settings chunkStreaming;
 				std::filesystem::path saveDirectory = Nz::Utf8Path("save/chunks");
 				Nz::Time saveInterval = Nz::Time::Seconds(30);
 				Nz::UInt32 planetSeed = 42;
 				Nz::Vector3ui planetChunkCount = Nz::Vector3ui(5);
 				bool pauseWhenEmpty = true;
+				bool streamChunks = false; //< generate chunks as players get close instead of generating the whole planet on startup
 			};
 
 		private:
+			bool LoadChunk(Chunk& chunk);
 			void LoadChunks();
 			void OnNetworkTick();
 			void OnTick(Nz::Time elapsedTime);
 			void OnSave();
+			void UpdateChunkVisibility();
+			bool UpgradeSave();
 
 			Nz::UInt16 m_tickIndex;
+			unsigned int m_saveVersion;
 			std::filesystem::path m_saveDirectory;
 			std::unique_ptr<Planet> m_planet;
 			std::unique_ptr<ChunkEntities> m_planetEntities;
+			std::unique_ptr<ChunkStreamer> m_chunkStreamer;
 			std::unordered_set<ChunkIndices /*chunkIndex*/> m_dirtyChunks;
 			std::vector<std::unique_ptr<NetworkSessionManager>> m_sessionManagers;
 			Nz::Bitset<> m_disconnectedPlayers;
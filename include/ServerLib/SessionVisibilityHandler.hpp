@@ -42,6 +42,8 @@ namespace tsom
 
 			const Chunk* GetChunkByIndex(std::size_t chunkIndex) const;
 
+			bool IsChunkVisible(const Chunk& chunk) const;
+
 			inline void UpdateControlledEntity(entt::handle entity, CharacterController* controller);
 			inline void UpdateLastInputIndex(InputIndex inputIndex);
 
@@ -79,7 +81,7 @@ namespace tsom
 
 			struct VisibleChunk
 			{
-				NazaraSlot(Chunk, OnBlockUpdated, onBlockUpdatedSlot);
+				NazaraSlot(Chunk, OnBlocksUpdated, onBlocksUpdatedSlot);
 				NazaraSlot(Chunk, OnReset, onResetSlot);
 
 				const Chunk* chunk;
@@ -4,10 +4,14 @@
 
 #include <ClientLib/ClientChunkEntities.hpp>
 #include <ClientLib/RenderConstants.hpp>
+#include <CommonLib/ChunkLod.hpp>
+#include <CommonLib/ChunkMesher.hpp>
+#include <CommonLib/Utility/ContentHasher.hpp>
 #include <Nazara/Core/ApplicationBase.hpp>
+#include <Nazara/Core/BufferMapper.hpp>
+#include <Nazara/Core/Components/NodeComponent.hpp>
 #include <Nazara/Core/FilesystemAppComponent.hpp>
 #include <Nazara/Core/IndexBuffer.hpp>
-#include <Nazara/Core/TaskSchedulerAppComponent.hpp>
 #include <Nazara/Core/VertexBuffer.hpp>
 #include <Nazara/Graphics/GraphicalMesh.hpp>
 #include <Nazara/Graphics/Graphics.hpp>
@@ -19,11 +23,68 @@
 #include <Nazara/Graphics/PropertyHandler/TexturePropertyHandler.hpp>
 #include <Nazara/Graphics/PropertyHandler/UniformValuePropertyHandler.hpp>
 #include <Nazara/Physics3D/Components/RigidBody3DComponent.hpp>
+#include <algorithm>
+#include <bit>
+#include <cassert>
 
 namespace tsom
 {
+	namespace
+	{
+		void AppendFace(const ChunkMeshFace& face, std::vector<ChunkMeshVertex>& vertices)
+		{
+			for (std::size_t i = 0; i < face.positions.size(); ++i)
+			{
+				ChunkMeshVertex& vertex = vertices.emplace_back();
+				vertex.position = face.positions[i];
+				vertex.normal = face.normal;
+				vertex.uvw = Nz::Vector3f(face.uvs[i], face.textureIndex);
+				vertex.tangent = face.tangent;
+			}
+		}
+
+		// Faces are independent quads, their indices only depend on the face count
+		std::shared_ptr<Nz::IndexBuffer> BuildFaceIndexBuffer(Nz::UInt32 faceCount)
+		{
+			Nz::UInt32 indexCount = faceCount * Nz::SafeCast<Nz::UInt32>(ChunkMesherBase::s_faceIndices.size());
+
+			std::shared_ptr<Nz::IndexBuffer> indexBuffer = std::make_shared<Nz::IndexBuffer>(Nz::IndexType::U32, indexCount, Nz::BufferUsage::Read | Nz::BufferUsage::Write, Nz::SoftwareBufferFactory);
+			{
+				Nz::BufferMapper<Nz::IndexBuffer> indexMapper(*indexBuffer, 0, indexCount);
+
+				Nz::UInt32* indices = static_cast<Nz::UInt32*>(indexMapper.GetPointer());
+				for (Nz::UInt32 faceIndex = 0; faceIndex < faceCount; ++faceIndex)
+				{
+					for (Nz::UInt32 index : ChunkMesherBase::s_faceIndices)
+						*indices++ = faceIndex * 4 + index;
+				}
+			}
+
+			return indexBuffer;
+		}
+
+		std::shared_ptr<Nz::Mesh> BuildStaticMesh(std::shared_ptr<Nz::VertexBuffer> vertexBuffer, std::shared_ptr<Nz::IndexBuffer> indexBuffer)
+		{
+			std::shared_ptr<Nz::StaticMesh> staticMesh = std::make_shared<Nz::StaticMesh>(std::move(vertexBuffer), std::move(indexBuffer));
+			staticMesh->GenerateAABB();
+
+			std::shared_ptr<Nz::Mesh> chunkMesh = std::make_shared<Nz::Mesh>();
+			chunkMesh->CreateStatic();
+			chunkMesh->AddSubMesh(std::move(staticMesh));
+
+			return chunkMesh;
+		}
+	}
+
 	ClientChunkEntities::ClientChunkEntities(Nz::ApplicationBase& app, Nz::EnttWorld& world, ChunkContainer& chunkContainer, const ClientBlockLibrary& blockLibrary) :
-	ChunkEntities(app, world, chunkContainer, blockLibrary, NoInit{})
+	ChunkEntities(app, world, chunkContainer, blockLibrary, NoInit{}),
+	m_meshCache(DefaultMeshCacheCapacity),
+	m_meshCachePool(JobPoolCapacity),
+	m_modelJobPool(JobPoolCapacity),
+	m_occludedChunkCount(0),
+	m_directionCulling(true),
+	m_greedyMeshing(true),
+	m_occlusionCulling(true)
 	{
 		auto& filesystem = app.GetComponent<Nz::FilesystemAppComponent>();
 
@@ -134,109 +195,436 @@ namespace tsom
 		FillChunks();
 	}
 
-	std::shared_ptr<Nz::Mesh> ClientChunkEntities::BuildMesh(const Chunk* chunk)
+	std::shared_ptr<const ClientChunkEntities::ChunkMesh> ClientChunkEntities::BuildChunkMesh(const ChunkDirectionBounds& directionBounds, const Nz::FunctionRef<void(Direction direction, ChunkMeshVertex* vertices)>& copyVertices) const
 	{
-		std::vector<Nz::UInt32> indices;
-		std::vector<VertexStruct> vertices;
+		std::shared_ptr<ChunkMesh> chunkMesh = std::make_shared<ChunkMesh>();
+		chunkMesh->directionBounds = directionBounds;
 
-		auto AddVertices = [&](Nz::UInt32 count)
+		bool hasFaces = false;
+		for (auto&& [direction, mesh] : chunkMesh->directionMeshes.iter_kv())
 		{
-			Chunk::VertexAttributes vertexAttributes;
+			Nz::UInt32 faceCount = directionBounds.GetBounds(direction).faceCount;
+			if (faceCount == 0)
+				continue;
 
-			vertexAttributes.firstIndex = Nz::SafeCast<Nz::UInt32>(vertices.size());
-			vertices.resize(vertices.size() + count);
-			vertexAttributes.position = Nz::SparsePtr<Nz::Vector3f>(&vertices[vertexAttributes.firstIndex].position, sizeof(vertices.front()));
-			vertexAttributes.normal = Nz::SparsePtr<Nz::Vector3f>(&vertices[vertexAttributes.firstIndex].normal, sizeof(vertices.front()));
-			vertexAttributes.tangent = Nz::SparsePtr<Nz::Vector3f>(&vertices[vertexAttributes.firstIndex].tangent, sizeof(vertices.front()));
-			vertexAttributes.uv = Nz::SparsePtr<Nz::Vector3f>(&vertices[vertexAttributes.firstIndex].uvw, sizeof(vertices.front()));
+			Nz::UInt32 vertexCount = faceCount * 4;
+			std::shared_ptr<Nz::VertexBuffer> vertexBuffer = std::make_shared<Nz::VertexBuffer>(m_chunkVertexDeclaration, vertexCount, Nz::BufferUsage::Read | Nz::BufferUsage::Write, Nz::SoftwareBufferFactory);
+			{
+				Nz::BufferMapper<Nz::VertexBuffer> vertexMapper(*vertexBuffer, 0, vertexCount);
+				copyVertices(direction, static_cast<ChunkMeshVertex*>(vertexMapper.GetPointer()));
+			}
 
-			return vertexAttributes;
-		};
+			mesh = BuildStaticMesh(std::move(vertexBuffer), BuildFaceIndexBuffer(faceCount));
+			hasFaces = true;
+		}
 
-		chunk->BuildMesh(m_blockLibrary, indices, m_chunkContainer.GetCenter() - m_chunkContainer.GetChunkOffset(chunk->GetIndices()), AddVertices);
-		if (indices.empty())
+		if (!hasFaces)
 			return nullptr;
 
-		std::shared_ptr<Nz::IndexBuffer> indexBuffer = std::make_shared<Nz::IndexBuffer>(Nz::IndexType::U32, Nz::SafeCast<Nz::UInt32>(indices.size()), Nz::BufferUsage::Read, Nz::SoftwareBufferFactory, indices.data());
-		std::shared_ptr<Nz::VertexBuffer> vertexBuffer = std::make_shared<Nz::VertexBuffer>(m_chunkVertexDeclaration, Nz::SafeCast<Nz::UInt32>(vertices.size()), Nz::BufferUsage::Read, Nz::SoftwareBufferFactory, vertices.data());
+		return chunkMesh;
+	}
+
+	std::shared_ptr<const ClientChunkEntities::ChunkMesh> ClientChunkEntities::BuildLodMesh(const Chunk* chunk, const ChunkSnapshot& snapshot, unsigned int lodLevel) const
+	{
+		Nz::Vector3f gravityCenter = m_chunkContainer.GetCenter() - m_chunkContainer.GetChunkOffset(chunk->GetIndices());
 
-		std::shared_ptr<Nz::StaticMesh> staticMesh = std::make_shared<Nz::StaticMesh>(std::move(vertexBuffer), std::move(indexBuffer));
-		staticMesh->GenerateAABB();
-		staticMesh->GenerateTangents();
+		// Face count is only known once meshed, mesh into the worker scratch buffers before copying into the mesh buffers
+		thread_local Nz::EnumArray<Direction, std::vector<ChunkMeshVertex>> scratchVertices;
+		for (std::vector<ChunkMeshVertex>& vertices : scratchVertices)
+			vertices.clear();
 
-		std::shared_ptr<Nz::Mesh> chunkMesh = std::make_shared<Nz::Mesh>();
-		chunkMesh->CreateStatic();
-		chunkMesh->AddSubMesh(std::move(staticMesh));
+		// Downsampled chunks are meshed as a whole, their face count (and meshing cost) drops by the square of the cell size
+		thread_local ChunkLod chunkLod;
+		chunkLod.Reset(snapshot, 1u << lodLevel);
 
-		return chunkMesh;
+		ChunkDirectionBounds directionBounds;
+		chunkLod.BuildMesh(*chunk, m_blockLibrary, gravityCenter, [&](const ChunkMeshFace& face)
+		{
+			AppendFace(face, scratchVertices[face.direction]);
+			directionBounds.AddFace(face.direction, face.positions, face.normal);
+		});
+
+		chunkLod.Clear();
+
+		return BuildChunkMesh(directionBounds, [&](Direction direction, ChunkMeshVertex* vertices)
+		{
+			std::copy(scratchVertices[direction].begin(), scratchVertices[direction].end(), vertices);
+		});
+	}
+
+	std::shared_ptr<const ClientChunkEntities::ChunkMesh> ClientChunkEntities::BuildMesh(const Chunk* chunk, const ChunkSnapshot& snapshot, const ChunkMeshCache* previousMeshCache, ChunkMeshCache& meshCache, const std::atomic_bool& cancelled) const
+	{
+		Nz::Vector3f gravityCenter = m_chunkContainer.GetCenter() - m_chunkContainer.GetChunkOffset(chunk->GetIndices());
+
+		// Only remesh bricks which changed (or whose direct neighbors changed) since the previous mesh
+		if (!meshCache.Build(m_blockLibrary, *chunk, snapshot, gravityCenter, previousMeshCache, &cancelled))
+			return {};
+
+		// Bricks are already spliced together in each direction storage
+		return BuildChunkMesh(meshCache.GetDirectionBounds(), [&](Direction direction, ChunkMeshVertex* vertices)
+		{
+			const std::vector<ChunkMeshVertex>& directionVertices = meshCache.GetVertices(direction);
+			std::copy(directionVertices.begin(), directionVertices.end(), vertices);
+		});
+	}
+
+	void ClientChunkEntities::EnableDirectionCulling(bool enable)
+	{
+		// Models will be reattached with the right mask on the next culling update
+		m_directionCulling = enable;
+	}
+
+	void ClientChunkEntities::EnableGreedyMeshing(bool enable)
+	{
+		if (m_greedyMeshing == enable)
+			return;
+
+		m_greedyMeshing = enable;
+
+		// Rebuild all chunks meshes
+		m_chunkMeshCaches.clear();
+		for (auto it = m_chunkEntities.begin(); it != m_chunkEntities.end(); ++it)
+			m_invalidatedChunks.insert(it->first);
+	}
+
+	void ClientChunkEntities::SetLevelOfDetailSettings(const LevelOfDetailSettings& lodSettings)
+	{
+		m_lodSettings = lodSettings;
+
+		// Levels are computed again on the next update, remesh chunks at full resolution until then
+		for (auto it = m_chunkLodLevels.begin(); it != m_chunkLodLevels.end(); ++it)
+			m_invalidatedChunks.insert(it->first);
+
+		m_chunkLodLevels.clear();
+	}
+
+	void ClientChunkEntities::UpdateDirectionCulling(const Nz::Vector3f& viewerPosition)
+	{
+		for (auto it = m_chunkModels.begin(); it != m_chunkModels.end(); ++it)
+		{
+			ChunkModels& chunkModels = it.value();
+			entt::handle chunkEntity = Nz::Retrieve(m_chunkEntities, it->first);
+
+			// Direction bounds are in chunk space, bring the viewer in it (which accounts for the chunk frame orientation)
+			Nz::Vector3f localViewerPosition = chunkEntity.get<Nz::NodeComponent>().ToLocalPosition(viewerPosition);
+
+			auto& gfxComponent = chunkEntity.get<Nz::GraphicsComponent>();
+			for (auto&& [direction, model] : chunkModels.models.iter_kv())
+			{
+				if (!model)
+					continue;
+
+				bool backFacing = m_directionCulling && chunkModels.directionBounds.IsBackFacing(direction, localViewerPosition);
+				if (backFacing == chunkModels.backFacing[direction])
+					continue;
+
+				// Back-facing directions keep being rendered by lights (shadow maps render back faces)
+				gfxComponent.DetachRenderable(model);
+				gfxComponent.AttachRenderable(model, (backFacing) ? Constants::RenderMaskBackFacingChunk : Constants::RenderMask3D);
+
+				chunkModels.backFacing[direction] = backFacing;
+			}
+		}
+	}
+
+	void ClientChunkEntities::EnableOcclusionCulling(bool enable)
+	{
+		// Chunks will be shown back on the next culling update
+		m_occlusionCulling = enable;
+	}
+
+	void ClientChunkEntities::UpdateLevelsOfDetail(const Nz::Vector3f& viewerPosition)
+	{
+		if (!m_lodSettings.enabled)
+			return;
+
+		Nz::Vector3f halfChunkSize = Nz::Vector3f(ChunkContainer::ChunkSize * m_chunkContainer.GetTileSize() * 0.5f);
+
+		for (auto it = m_chunkEntities.begin(); it != m_chunkEntities.end(); ++it)
+		{
+			const ChunkIndices& chunkIndices = it->first;
+
+			// Distance from the viewer to the chunk bounds
+			Nz::Vector3f chunkCenter = m_chunkContainer.GetChunkOffset(chunkIndices);
+			Nz::Vector3f closestPoint;
+			closestPoint.x = std::clamp(viewerPosition.x, chunkCenter.x - halfChunkSize.x, chunkCenter.x + halfChunkSize.x);
+			closestPoint.y = std::clamp(viewerPosition.y, chunkCenter.y - halfChunkSize.y, chunkCenter.y + halfChunkSize.y);
+			closestPoint.z = std::clamp(viewerPosition.z, chunkCenter.z - halfChunkSize.z, chunkCenter.z + halfChunkSize.z);
+			float distance = closestPoint.Distance(viewerPosition);
+
+			auto lodIt = m_chunkLodLevels.find(chunkIndices);
+			unsigned int currentLevel = (lodIt != m_chunkLodLevels.end()) ? lodIt->second : 0;
+
+			// Boundary of the next level is twice as far as the previous one, chunks have to go past it by the hysteresis distance (in either way) to change level
+			unsigned int level = 0;
+			float levelDistance = m_lodSettings.distance;
+			while (level < m_lodSettings.maxLevel)
+			{
+				float boundary = levelDistance + ((level < currentLevel) ? -m_lodSettings.hysteresis : m_lodSettings.hysteresis);
+				if (distance < boundary)
+					break;
+
+				level++;
+				levelDistance *= 2.f;
+			}
+
+			if (level == currentLevel)
+				continue;
+
+			if (level > 0)
+				m_chunkLodLevels.insert_or_assign(chunkIndices, level);
+			else
+				m_chunkLodLevels.erase(chunkIndices);
+
+			m_invalidatedChunks.insert(chunkIndices);
+		}
+	}
+
+	void ClientChunkEntities::UpdateOcclusionCulling(const Nz::Vector3f& viewerPosition)
+	{
+		if (m_chunkEntities.empty())
+			return;
+
+		if (m_occlusionCulling)
+		{
+			ChunkIndices viewerChunk = m_chunkContainer.GetChunkIndicesByPosition(viewerPosition);
+
+			// Bound the flood fill to the chunks and the viewer, with an empty layer around them so sight can go around the planet
+			ChunkIndices minIndices = viewerChunk;
+			ChunkIndices maxIndices = viewerChunk;
+			for (auto it = m_chunkEntities.begin(); it != m_chunkEntities.end(); ++it)
+			{
+				minIndices.Minimize(it->first);
+				maxIndices.Maximize(it->first);
+			}
+
+			minIndices -= ChunkIndices(1);
+			maxIndices += ChunkIndices(1);
+
+			Nz::Boxi chunkBounds(minIndices.x, minIndices.y, minIndices.z, maxIndices.x - minIndices.x + 1, maxIndices.y - minIndices.y + 1, maxIndices.z - minIndices.z + 1);
+			m_chunkVisibility.Compute(viewerChunk, chunkBounds, [&](const ChunkIndices& chunkIndices) -> const ChunkConnectivity*
+			{
+				auto it = m_chunkConnectivities.find(chunkIndices);
+				if (it == m_chunkConnectivities.end())
+					return nullptr;
+
+				return &it->second;
+			});
+		}
+
+		// Hidden chunks are skipped by the render system (including shadows, occluded chunks are buried anyway)
+		m_occludedChunkCount = 0;
+		for (auto it = m_chunkEntities.begin(); it != m_chunkEntities.end(); ++it)
+		{
+			auto* gfxComponent = it->second.try_get<Nz::GraphicsComponent>();
+			if (!gfxComponent)
+				continue;
+
+			bool isVisible = !m_occlusionCulling || m_chunkVisibility.IsVisible(it->first);
+			if (gfxComponent->IsVisible() != isVisible)
+				gfxComponent->Show(isVisible);
+
+			if (!isVisible)
+				m_occludedChunkCount++;
+		}
+	}
+
+	void ClientChunkEntities::DestroyChunkEntity(const ChunkIndices& chunkIndices)
+	{
+		ChunkEntities::DestroyChunkEntity(chunkIndices);
+
+		m_chunkConnectivities.erase(chunkIndices);
+		m_chunkLodLevels.erase(chunkIndices);
+		m_chunkModels.erase(chunkIndices);
+
+		if (auto it = m_chunkMeshCaches.find(chunkIndices); it != m_chunkMeshCaches.end())
+		{
+			m_meshCachePool.Release(std::move(it.value()));
+			m_chunkMeshCaches.erase(it);
+		}
 	}
 
 	void ClientChunkEntities::HandleChunkUpdate(const ChunkIndices& chunkIndices, const Chunk* chunk)
 	{
+		auto lodIt = m_chunkLodLevels.find(chunkIndices);
+		unsigned int lodLevel = (lodIt != m_chunkLodLevels.end()) ? lodIt->second : 0;
+
 		// Try to cancel current update job to void useless work
 		if (auto it = m_updateJobs.find(chunkIndices); it != m_updateJobs.end())
 		{
 			UpdateJob& job = *it->second;
-			job.cancelled = true;
+
+			// Chunk and its neighbors didn't change since this job was scheduled
+			ColliderModelUpdateJob& modelUpdateJob = static_cast<ColliderModelUpdateJob&>(job);
+			if (job.snapshot.IsUpToDate(*chunk) && modelUpdateJob.buildCollider == HasColliderResidency(chunkIndices) && modelUpdateJob.lodLevel == lodLevel)
+				return;
+
+			// Coalesce updates, only the latest content is worth building
+			CancelUpdateJob(chunkIndices);
+		}
+
+		std::shared_ptr<ColliderModelUpdateJob> updateJob = m_modelJobPool.Acquire([&](ColliderModelUpdateJob& job)
+		{
+			// Jobs are only reused once their tasks are done, the mesh cache of a cancelled job can then be reused as well
+			std::shared_ptr<ChunkMeshCache> meshCache = std::move(job.meshCache);
+
+			std::destroy_at(&job);
+			std::construct_at(&job);
+
+			m_meshCachePool.Release(std::move(meshCache));
+		});
+		updateJob->lodLevel = lodLevel;
+		updateJob->snapshot = chunk->TakeSnapshot();
+		PrepareColliderUpdate(chunkIndices, *chunk, *updateJob);
+
+		if (!updateJob->snapshot.IsEmpty())
+		{
+			// Meshes are also built relative to the gravity center, which sets the texture orientation
+			Nz::Vector3f gravityCenter = m_chunkContainer.GetCenter() - m_chunkContainer.GetChunkOffset(chunkIndices);
+
+			ContentHasher hasher;
+			hasher.Append(ComputeContentKey(chunkIndices, *chunk, updateJob->snapshot));
+			hasher.Append(std::bit_cast<Nz::UInt32>(gravityCenter.x));
+			hasher.Append(std::bit_cast<Nz::UInt32>(gravityCenter.y));
+			hasher.Append(std::bit_cast<Nz::UInt32>(gravityCenter.z));
+			hasher.Append(lodLevel);
+			hasher.Append(m_greedyMeshing);
+			updateJob->meshKey = hasher.GetHash();
+
+			if (const CachedMesh* cachedMesh = m_meshCache.Find(updateJob->meshKey))
+			{
+				updateJob->meshCache = cachedMesh->meshCache;
+				updateJob->mesh = cachedMesh->mesh;
+				updateJob->connectivity = cachedMesh->connectivity;
+				updateJob->meshCacheHit = true;
+			}
 		}
+		else
+			updateJob->connectivity = ChunkConnectivity(true); //< sight crosses empty chunks in any direction
 
-		std::shared_ptr<ColliderModelUpdateJob> updateJob = std::make_shared<ColliderModelUpdateJob>();
-		updateJob->taskCount = 2;
+		if (!updateJob->meshCacheHit && !updateJob->snapshot.IsEmpty() && lodLevel == 0)
+		{
+			// Recycled caches keep their storage, remeshing a chunk doesn't allocate anything but the final mesh buffers
+			updateJob->meshCache = m_meshCachePool.Acquire([](ChunkMeshCache& /*meshCache*/) {});
+			updateJob->meshCache->Reset(m_greedyMeshing);
+
+			if (auto it = m_chunkMeshCaches.find(chunkIndices); it != m_chunkMeshCaches.end())
+				updateJob->previousMeshCache = it->second;
+		}
 
 		updateJob->applyFunc = [this](const ChunkIndices& chunkIndices, UpdateJob&& job)
 		{
 			ColliderModelUpdateJob&& colliderUpdateJob = static_cast<ColliderModelUpdateJob&&>(job);
 
-			entt::handle chunkEntity = Nz::Retrieve(m_chunkEntities, chunkIndices);
+			if (!colliderUpdateJob.meshCacheHit && !colliderUpdateJob.snapshot.IsEmpty())
+				m_meshCache.Insert(colliderUpdateJob.meshKey, { colliderUpdateJob.meshCache, colliderUpdateJob.mesh, colliderUpdateJob.connectivity });
+
+			m_chunkConnectivities.insert_or_assign(chunkIndices, colliderUpdateJob.connectivity);
 
-			auto& rigidBody = chunkEntity.get<Nz::RigidBody3DComponent>();
-			rigidBody.SetGeom(std::move(colliderUpdateJob.collider), false);
+			// Replaced mesh caches are reused once the jobs meshing from them are done
+			if (auto it = m_chunkMeshCaches.find(chunkIndices); it != m_chunkMeshCaches.end())
+			{
+				m_meshCachePool.Release(std::move(it.value()));
+				m_chunkMeshCaches.erase(it);
+			}
+
+			// Empty chunks don't go through meshing, and chunks meshed at a lower level of detail don't keep their full resolution bricks
+			if (colliderUpdateJob.meshCache && !colliderUpdateJob.meshCache->IsEmpty())
+				m_chunkMeshCaches.emplace(chunkIndices, std::move(colliderUpdateJob.meshCache));
+
+			ApplyColliderUpdate(chunkIndices, colliderUpdateJob);
+
+			entt::handle chunkEntity = Nz::Retrieve(m_chunkEntities, chunkIndices);
 
 			auto& gfxComponent = chunkEntity.get_or_emplace<Nz::GraphicsComponent>();
 			gfxComponent.Clear();
 
+			m_chunkModels.erase(chunkIndices);
 			if (colliderUpdateJob.mesh)
 			{
-				// TODO: Move GPU upload to async task (should almost already work on Vulkan, problem is OpenGL)
-				std::shared_ptr<Nz::GraphicalMesh> gfxMesh = Nz::GraphicalMesh::BuildFromMesh(*colliderUpdateJob.mesh);
+				// One model per direction, culled on their own by UpdateDirectionCulling
+				ChunkModels chunkModels;
+				chunkModels.backFacing.fill(false);
+				chunkModels.directionBounds = colliderUpdateJob.mesh->directionBounds;
+
+				for (auto&& [direction, mesh] : colliderUpdateJob.mesh->directionMeshes.iter_kv())
+				{
+					if (!mesh)
+						continue;
+
+					// TODO: Move GPU upload to async task (should almost already work on Vulkan, problem is OpenGL)
+					std::shared_ptr<Nz::GraphicalMesh> gfxMesh = Nz::GraphicalMesh::BuildFromMesh(*mesh);
 
-				std::shared_ptr<Nz::Model> model = std::make_shared<Nz::Model>(std::move(gfxMesh));
-				model->SetMaterial(0, m_chunkMaterial);
+					std::shared_ptr<Nz::Model> model = std::make_shared<Nz::Model>(std::move(gfxMesh));
+					model->SetMaterial(0, m_chunkMaterial);
 
-				gfxComponent.AttachRenderable(std::move(model), tsom::Constants::RenderMask3D);
+					gfxComponent.AttachRenderable(model, tsom::Constants::RenderMask3D);
+					chunkModels.models[direction] = std::move(model);
+				}
+
+				m_chunkModels.insert_or_assign(chunkIndices, std::move(chunkModels));
 			}
 
 			UpdateChunkDebugCollider(chunkIndices);
 		};
 
-		auto& taskScheduler = m_application.GetComponent<Nz::TaskSchedulerAppComponent>();
-		taskScheduler.AddTask([this, chunk, updateJob]
+		// Empty chunks have neither collider nor mesh, chunks out of colliders residency range are only meshed and cached results are already built
+		bool buildCollider = updateJob->buildCollider && !updateJob->snapshot.IsEmpty() && !updateJob->colliderCacheHit;
+		bool buildMesh = !updateJob->snapshot.IsEmpty() && !updateJob->meshCacheHit;
+
+		// Task count has to be known before scheduling any task
+		updateJob->taskCount = (buildCollider) ? 1 : 0;
+		if (buildMesh)
+			updateJob->taskCount++;
+
+		if (updateJob->taskCount == 0)
 		{
-			if (updateJob->cancelled)
-				return;
+			m_updateJobs.insert_or_assign(chunkIndices, std::move(updateJob));
+			return;
+		}
+
+		if (buildCollider)
+		{
+			m_jobScheduler.Schedule(chunkIndices, [this, chunk, updateJob]
+			{
+				if (updateJob->cancelled)
+					return;
 
-			chunk->LockRead();
-			updateJob->collider = chunk->BuildCollider(m_blockLibrary);
-			chunk->UnlockRead();
+				updateJob->collider = updateJob->colliderCache->Build(m_blockLibrary, *chunk, updateJob->snapshot, updateJob->previousColliderCache.get(), &updateJob->cancelled);
 
-			updateJob->executionCounter++;
-		});
+				updateJob->executionCounter++;
+			});
+		}
 
-		taskScheduler.AddTask([this, chunk, updateJob]
+		if (buildMesh)
 		{
-			if (updateJob->cancelled)
-				return;
+			m_jobScheduler.Schedule(chunkIndices, [this, chunk, updateJob]
+			{
+				if (updateJob->cancelled)
+					return;
 
-			chunk->LockRead();
-			updateJob->mesh = BuildMesh(chunk);
-			chunk->UnlockRead();
+				if (updateJob->lodLevel > 0)
+					updateJob->mesh = BuildLodMesh(chunk, updateJob->snapshot, updateJob->lodLevel);
+				else
+					updateJob->mesh = BuildMesh(chunk, updateJob->snapshot, updateJob->previousMeshCache.get(), *updateJob->meshCache, updateJob->cancelled);
 
-			updateJob->executionCounter++;
-		});
+				if (updateJob->cancelled)
+					return;
+
+				updateJob->connectivity.Reset(updateJob->snapshot.GetOccupancy());
+
+				updateJob->executionCounter++;
+			});
+		}
 
 		m_updateJobs.insert_or_assign(chunkIndices, std::move(updateJob));
 	}
 
+	void ClientChunkEntities::RecycleJob(std::shared_ptr<UpdateJob>&& job)
+	{
+		m_modelJobPool.Release(std::static_pointer_cast<ColliderModelUpdateJob>(std::move(job)));
+	}
+
 	void ClientChunkEntities::UpdateChunkDebugCollider(const ChunkIndices& chunkIndices)
 	{
 #if 0
@@ -0,0 +1,140 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com) (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CommonLib/BatchPerlinNoise.hpp>
+#include <PerlinNoise.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace tsom
+{
+	namespace
+	{
+		// Same operations in the same order as siv::PerlinNoise, so results match bit for bit
+		constexpr double Fade(double t)
+		{
+			return t * t * t * (t * (t * 6 - 15) + 10);
+		}
+
+		constexpr double Grad(Nz::UInt8 hash, double x, double y, double z)
+		{
+			Nz::UInt8 h = hash & 15;
+			double u = (h < 8) ? x : y;
+			double v = (h < 4) ? y : (h == 12 || h == 14) ? x : z;
+			return (((h & 1) == 0) ? u : -u) + (((h & 2) == 0) ? v : -v);
+		}
+
+		constexpr double Lerp(double a, double b, double t)
+		{
+			return a + (b - a) * t;
+		}
+	}
+
+	BatchPerlinNoise::BatchPerlinNoise() :
+	BatchPerlinNoise(siv::PerlinNoise{}.serialize())
+	{
+	}
+
+	BatchPerlinNoise::BatchPerlinNoise(Nz::UInt32 seed) :
+	BatchPerlinNoise(siv::PerlinNoise(seed).serialize())
+	{
+	}
+
+	// Fills results with the noise of each point (xValues[i], yValues[j]) in [0, 1], row by row (results[j * xValues.size() + i]), like siv::PerlinNoise::normalizedOctave2D_01
+	void BatchPerlinNoise::ComputeNormalizedOctave2D(std::span<const double> xValues, std::span<const double> yValues, Nz::UInt32 octaves, double* results, double persistence) const
+	{
+		std::size_t width = xValues.size();
+		std::fill_n(results, width * yValues.size(), 0.0);
+
+		// siv::PerlinNoise evaluates 2D noise as 3D noise at z = 0, the z interpolation then only gives back the z = 0 plane
+		// (up to the sign of zeros, which the final remapping erases)
+		for (std::size_t offset = 0; offset < width; offset += LaneCount)
+		{
+			std::size_t laneCount = std::min(LaneCount, width - offset);
+
+			std::array<double, LaneCount> x = {};
+			std::copy_n(&xValues[offset], laneCount, x.begin());
+
+			// Frequency is a power of two, scaling by it gives the same coordinates as doubling them at each octave
+			double amplitude = 1.0;
+			double frequency = 1.0;
+			for (Nz::UInt32 octave = 0; octave < octaves; ++octave)
+			{
+				// Lattice cells along X are shared by all rows
+				std::array<Nz::Int32, LaneCount> ix;
+				std::array<double, LaneCount> fx;
+				std::array<double, LaneCount> u;
+				for (std::size_t lane = 0; lane < LaneCount; ++lane)
+				{
+					double laneX = x[lane] * frequency;
+					double floorX = std::floor(laneX);
+
+					ix[lane] = static_cast<Nz::Int32>(floorX) & 255;
+					fx[lane] = laneX - floorX;
+					u[lane] = Fade(fx[lane]);
+				}
+
+				for (std::size_t row = 0; row < yValues.size(); ++row)
+				{
+					double y = yValues[row] * frequency;
+					double floorY = std::floor(y);
+
+					Nz::Int32 iy = static_cast<Nz::Int32>(floorY) & 255;
+					double fy = y - floorY;
+					double v = Fade(fy);
+
+					// Hashing the lattice corners is the only part which doesn't run in lanes
+					std::array<Nz::UInt8, LaneCount> hashAA;
+					std::array<Nz::UInt8, LaneCount> hashAB;
+					std::array<Nz::UInt8, LaneCount> hashBA;
+					std::array<Nz::UInt8, LaneCount> hashBB;
+					for (std::size_t lane = 0; lane < LaneCount; ++lane)
+					{
+						Nz::UInt8 a = (m_permutation[ix[lane]] + iy) & 255;
+						Nz::UInt8 b = (m_permutation[(ix[lane] + 1) & 255] + iy) & 255;
+
+						hashAA[lane] = m_permutation[m_permutation[a]];
+						hashAB[lane] = m_permutation[m_permutation[(a + 1) & 255]];
+						hashBA[lane] = m_permutation[m_permutation[b]];
+						hashBB[lane] = m_permutation[m_permutation[(b + 1) & 255]];
+					}
+
+					std::array<double, LaneCount> noise;
+					for (std::size_t lane = 0; lane < LaneCount; ++lane)
+					{
+						double p0 = Grad(hashAA[lane], fx[lane], fy, 0.0);
+						double p1 = Grad(hashBA[lane], fx[lane] - 1, fy, 0.0);
+						double p2 = Grad(hashAB[lane], fx[lane], fy - 1, 0.0);
+						double p3 = Grad(hashBB[lane], fx[lane] - 1, fy - 1, 0.0);
+
+						noise[lane] = Lerp(Lerp(p0, p1, u[lane]), Lerp(p2, p3, u[lane]), v);
+					}
+
+					double* rowResults = &results[row * width + offset];
+					for (std::size_t lane = 0; lane < laneCount; ++lane)
+						rowResults[lane] += noise[lane] * amplitude;
+				}
+
+				amplitude *= persistence;
+				frequency *= 2.0;
+			}
+		}
+
+		double maxAmplitude = 0.0;
+		double amplitude = 1.0;
+		for (Nz::UInt32 octave = 0; octave < octaves; ++octave)
+		{
+			maxAmplitude += amplitude;
+			amplitude *= persistence;
+		}
+
+		for (std::size_t i = 0; i < width * yValues.size(); ++i)
+			results[i] = (results[i] / maxAmplitude) * 0.5 + 0.5;
+	}
+
+	void BatchPerlinNoise::Reseed(Nz::UInt32 seed)
+	{
+		m_permutation = siv::PerlinNoise(seed).serialize();
+	}
+}
@@ -0,0 +1,235 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CommonLib/BlockStorage.hpp>
+#include <CommonLib/Utility/ContentHasher.hpp>
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <limits>
+
+namespace tsom
+{
+	BlockStorage::BlockStorage(std::size_t blockCount, BlockIndex initialBlock) :
+	m_blockCount(blockCount)
+	{
+		Fill(initialBlock);
+	}
+
+	Nz::UInt64 BlockStorage::ComputeContentHash() const
+	{
+		// Hash block values rather than palette indices, so that the same content hashes the same whatever its palette layout or bit width
+		ContentHasher hasher;
+		hasher.Append(m_blockCount);
+
+		constexpr std::size_t BlockPerWord = 64 / (sizeof(BlockIndex) * 8);
+
+		std::size_t blockIndex = 0;
+		while (blockIndex < m_blockCount)
+		{
+			Nz::UInt64 word = 0;
+			for (std::size_t i = 0; i < BlockPerWord && blockIndex < m_blockCount; ++i)
+				word |= Nz::UInt64(m_palette[GetPaletteIndex(blockIndex++)].blockIndex) << (i * sizeof(BlockIndex) * 8);
+
+			hasher.Append(word);
+		}
+
+		return hasher.GetHash();
+	}
+
+	void BlockStorage::Fill(BlockIndex blockIndex)
+	{
+		m_palette.clear();
+		m_palette.push_back({ blockIndex, static_cast<Nz::UInt32>(m_blockCount) });
+		m_usedPaletteEntryCount = 1;
+
+		ResetWords(0);
+	}
+
+	void BlockStorage::Load(const BlockIndex* blocks)
+	{
+		constexpr Nz::UInt32 InvalidPaletteIndex = std::numeric_limits<Nz::UInt32>::max();
+
+		// Build palette from used block types
+		std::vector<Nz::UInt32> paletteIndices;
+		m_palette.clear();
+		for (std::size_t i = 0; i < m_blockCount; ++i)
+		{
+			BlockIndex blockIndex = blocks[i];
+			if (blockIndex >= paletteIndices.size())
+				paletteIndices.resize(blockIndex + 1, InvalidPaletteIndex);
+
+			Nz::UInt32& paletteIndex = paletteIndices[blockIndex];
+			if (paletteIndex == InvalidPaletteIndex)
+			{
+				paletteIndex = static_cast<Nz::UInt32>(m_palette.size());
+				m_palette.push_back({ blockIndex, 0 });
+			}
+
+			m_palette[paletteIndex].count++;
+		}
+		m_usedPaletteEntryCount = m_palette.size();
+
+		ResetWords(ComputeBitsPerBlock(m_palette.size()));
+		if (m_bitsPerBlock == 0)
+			return;
+
+		for (std::size_t i = 0; i < m_blockCount; ++i)
+			SetPaletteIndex(i, paletteIndices[blocks[i]]);
+	}
+
+	void BlockStorage::Store(BlockIndex* blocks) const
+	{
+		if (m_bitsPerBlock == 0)
+		{
+			std::fill_n(blocks, m_blockCount, m_palette.front().blockIndex);
+			return;
+		}
+
+		std::size_t blockPerWord = 64 >> m_bitsPerBlockLog2;
+		Nz::UInt64 mask = (Nz::UInt64(1) << m_bitsPerBlock) - 1;
+
+		std::size_t blockIndex = 0;
+		for (Nz::UInt64 word : m_words)
+		{
+			for (std::size_t i = 0; i < blockPerWord && blockIndex < m_blockCount; ++i)
+			{
+				blocks[blockIndex++] = m_palette[word & mask].blockIndex;
+				word >>= m_bitsPerBlock;
+			}
+		}
+	}
+
+	BlockIndex BlockStorage::UpdateBlock(std::size_t index, BlockIndex blockIndex)
+	{
+		Nz::UInt32 previousPaletteIndex = GetPaletteIndex(index);
+		BlockIndex previousBlockIndex = m_palette[previousPaletteIndex].blockIndex;
+		if (previousBlockIndex == blockIndex)
+			return previousBlockIndex;
+
+		// Palette only grows when it has no unused entry, which means repacking doesn't reorder it
+		Nz::UInt32 paletteIndex = AcquirePaletteIndex(blockIndex);
+		m_palette[paletteIndex].count++;
+		SetPaletteIndex(index, paletteIndex);
+
+		if (--m_palette[previousPaletteIndex].count == 0)
+		{
+			m_usedPaletteEntryCount--;
+
+			// Go back to uniform storage as soon as possible, otherwise only shrink when we're using less than half
+			// of the smaller bit width capacity, to prevent repacking back and forth
+			if (m_usedPaletteEntryCount == 1 || (m_bitsPerBlock > 1 && m_usedPaletteEntryCount * 2 <= (std::size_t(1) << (m_bitsPerBlock / 2))))
+				Repack(ComputeBitsPerBlock(m_usedPaletteEntryCount));
+		}
+
+		return previousBlockIndex;
+	}
+
+	Nz::UInt32 BlockStorage::AcquirePaletteIndex(BlockIndex blockIndex)
+	{
+		std::size_t freeEntryIndex = m_palette.size();
+		for (std::size_t i = 0; i < m_palette.size(); ++i)
+		{
+			PaletteEntry& entry = m_palette[i];
+			if (entry.blockIndex == blockIndex)
+			{
+				if (entry.count == 0)
+					m_usedPaletteEntryCount++;
+
+				return static_cast<Nz::UInt32>(i);
+			}
+
+			if (entry.count == 0 && freeEntryIndex == m_palette.size())
+				freeEntryIndex = i;
+		}
+
+		m_usedPaletteEntryCount++;
+
+		if (freeEntryIndex != m_palette.size())
+		{
+			m_palette[freeEntryIndex].blockIndex = blockIndex;
+			return static_cast<Nz::UInt32>(freeEntryIndex);
+		}
+
+		if (m_palette.size() >= (std::size_t(1) << m_bitsPerBlock))
+		{
+			assert(m_bitsPerBlock < MaxBitsPerBlock);
+			Repack((m_bitsPerBlock > 0) ? m_bitsPerBlock * 2 : 1);
+		}
+
+		m_palette.push_back({ blockIndex, 0 });
+		return static_cast<Nz::UInt32>(m_palette.size() - 1);
+	}
+
+	void BlockStorage::Repack(unsigned int bitsPerBlock)
+	{
+		// Remove unused palette entries
+		std::vector<Nz::UInt32> remappedIndices(m_palette.size());
+		std::vector<PaletteEntry> newPalette;
+		newPalette.reserve(m_usedPaletteEntryCount);
+
+		for (std::size_t i = 0; i < m_palette.size(); ++i)
+		{
+			if (m_palette[i].count == 0)
+				continue;
+
+			remappedIndices[i] = static_cast<Nz::UInt32>(newPalette.size());
+			newPalette.push_back(m_palette[i]);
+		}
+
+		assert(newPalette.size() <= (std::size_t(1) << bitsPerBlock));
+
+		std::vector<Nz::UInt64> previousWords = std::move(m_words);
+		unsigned int previousBitsPerBlock = m_bitsPerBlock;
+		std::size_t previousBlockPerWord = 64 >> m_bitsPerBlockLog2;
+		Nz::UInt64 previousMask = (Nz::UInt64(1) << previousBitsPerBlock) - 1;
+
+		ResetWords(bitsPerBlock);
+		m_palette = std::move(newPalette);
+
+		// A uniform storage only has one palette entry, remapped to index 0 which matches the zero-initialized words
+		if (previousBitsPerBlock == 0 || m_bitsPerBlock == 0)
+			return;
+
+		std::size_t blockIndex = 0;
+		for (Nz::UInt64 word : previousWords)
+		{
+			for (std::size_t i = 0; i < previousBlockPerWord && blockIndex < m_blockCount; ++i)
+			{
+				SetPaletteIndex(blockIndex++, remappedIndices[word & previousMask]);
+				word >>= previousBitsPerBlock;
+			}
+		}
+	}
+
+	void BlockStorage::ResetWords(unsigned int bitsPerBlock)
+	{
+		m_bitsPerBlock = bitsPerBlock;
+		if (bitsPerBlock == 0)
+		{
+			// Release block data
+			m_bitsPerBlockLog2 = 0;
+			m_words = {};
+			return;
+		}
+
+		m_bitsPerBlockLog2 = std::countr_zero(bitsPerBlock);
+
+		std::size_t blockPerWord = 64 >> m_bitsPerBlockLog2;
+		m_words.assign((m_blockCount + blockPerWord - 1) / blockPerWord, 0);
+	}
+
+	unsigned int BlockStorage::ComputeBitsPerBlock(std::size_t paletteSize)
+	{
+		if (paletteSize <= 1)
+			return 0;
+
+		unsigned int bitsPerBlock = 1;
+		while ((std::size_t(1) << bitsPerBlock) < paletteSize)
+			bitsPerBlock *= 2;
+
+		assert(bitsPerBlock <= MaxBitsPerBlock);
+		return bitsPerBlock;
+	}
+}
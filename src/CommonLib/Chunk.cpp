@@ -4,177 +4,146 @@
 
 #include <CommonLib/Chunk.hpp>
 #include <CommonLib/BlockLibrary.hpp>
+#include <CommonLib/ChunkMesher.hpp>
 #include <CommonLib/InternalConstants.hpp>
+#include <CommonLib/Utility/ContentHasher.hpp>
 #include <Nazara/Core/ByteStream.hpp>
 #include <Nazara/Core/VertexStruct.hpp>
 #include <NazaraUtils/EnumArray.hpp>
+#include <algorithm>
+#include <atomic>
+#include <bit>
 #include <cassert>
+#include <mutex>
 #include <numeric>
+#include <thread>
+#include <typeinfo>
 
 namespace tsom
 {
 	Chunk::~Chunk() = default;
 
-	void Chunk::BuildMesh(const BlockLibrary& blockManager, std::vector<Nz::UInt32>& indices, const Nz::Vector3f& gravityCenter, const Nz::FunctionRef<VertexAttributes(Nz::UInt32)>& addVertices) const
+	void Chunk::BuildGreedyMesh(const BlockLibrary& blockManager, const ChunkSnapshot& snapshot, const Nz::Boxui& blocks, std::vector<Nz::UInt32>& indices, const Nz::Vector3f& gravityCenter, const Nz::FunctionRef<VertexAttributes(Nz::UInt32 count)>& addVertices) const
 	{
-		auto DrawFace = [&](BlockIndex blockIndex, const Nz::Vector3f& blockCenter, const std::array<Nz::Vector3f, 4>& pos)
-		{
-			VertexAttributes vertexAttributes = addVertices(pos.size());
-			assert(vertexAttributes.position);
-
-			for (std::size_t i = 0; i < pos.size(); ++i)
-				vertexAttributes.position[i] = pos[i];
-
-			Nz::Vector3f faceCenter = std::accumulate(pos.begin(), pos.end(), Nz::Vector3f::Zero()) / pos.size();
-			Nz::Vector3f faceDirection = Nz::Vector3f::Normalize(faceCenter - blockCenter);
-
-			if (vertexAttributes.normal)
-			{
-				for (std::size_t i = 0; i < pos.size(); ++i)
-					vertexAttributes.normal[i] = faceDirection;
-			}
-
-			if (vertexAttributes.uv)
-			{
-				// Get face up vector
-				Nz::Vector3f faceUp = s_dirNormals[DirectionFromNormal(Nz::Vector3f::Normalize(faceCenter - gravityCenter))];
-
-				// Make up the rotation from the face up to the regular up
-				Nz::Quaternionf upRotation = Nz::Quaternionf::RotationBetween(faceUp, Nz::Vector3f::Up());
-
-				// Compute texture direction based on face direction in regular orientation
-				Direction texDirection = DirectionFromNormal(upRotation * faceDirection);
+		// Faces can't be merged in the general case, fallback to one quad per face
+		BuildMesh(blockManager, snapshot, blocks, indices, gravityCenter, addVertices);
+	}
 
-				const auto& blockData = blockManager.GetBlockData(blockIndex);
-				std::size_t textureIndex = blockData.texIndices[texDirection];
+	void Chunk::BuildMesh(const BlockLibrary& blockManager, const ChunkSnapshot& snapshot, const Nz::Boxui& blocks, std::vector<Nz::UInt32>& indices, const Nz::Vector3f& gravityCenter, const Nz::FunctionRef<VertexAttributes(Nz::UInt32)>& addVertices) const
+	{
+		if (snapshot.IsEmpty())
+			return;
 
-				// Compute UV
-				float sliceIndex = textureIndex;
-				for (std::size_t i = 0; i < pos.size(); ++i)
-				{
-					// Get vector from center to corner (no need to normalize) and use it to compute UV
-					// This is similar to the way a GPU compute UV when sampling a cubemap: https://www.gamedev.net/forums/topic/687535-implementing-a-cube-map-lookup-function/5337472/
-					Nz::Vector3f dir = upRotation * (pos[i] - blockCenter);
-					Nz::Vector3f dirAbs = dir.GetAbs();
-
-					float mag = 0.f;
-					Nz::Vector2f uv;
-					switch (texDirection) //< TODO: texture direction should be defined by dir to handle corners
-					{
-						case Direction::Back:
-						case Direction::Front:
-						{
-							mag = 0.5f / dirAbs.x;
-							uv = { dir.x < 0.f ? -dir.z : dir.z, -dir.y };
-							break;
-						}
-
-						case Direction::Down:
-						case Direction::Up:
-						{
-							mag = 0.5f / dirAbs.y;
-							uv = { dir.x, dir.y < 0.f ? -dir.z : dir.z };
-							break;
-						}
-
-						case Direction::Left:
-						case Direction::Right:
-						{
-							mag = 0.5f / dirAbs.z;
-							uv = { dir.z < 0.f ? dir.x : -dir.x, -dir.y };
-							break;
-						}
-					}
+		assert(blocks.x + blocks.width <= m_size.x);
+		assert(blocks.y + blocks.height <= m_size.y);
+		assert(blocks.z + blocks.depth <= m_size.z);
 
-					vertexAttributes.uv[i] = Nz::Vector3f(uv * mag + Nz::Vector2f(0.5f), sliceIndex);
-				}
-			}
+		Nz::Vector3ui firstBlock(blocks.x, blocks.y, blocks.z);
+		Nz::Vector3ui blockCount(blocks.width, blocks.height, blocks.depth);
 
-			indices.push_back(vertexAttributes.firstIndex);
-			indices.push_back(vertexAttributes.firstIndex + 2);
-			indices.push_back(vertexAttributes.firstIndex + 1);
+		for (auto&& [direction, offset] : s_blockDirOffsets.iter_kv())
+		{
+			// Visible faces are computed for a whole column along the face normal axis at once
+			unsigned int axis = (offset.x != 0) ? 0 : (offset.y != 0) ? 1 : 2;
+			unsigned int uAxis = (axis + 1) % 3;
+			unsigned int vAxis = (axis + 2) % 3;
 
-			indices.push_back(vertexAttributes.firstIndex + 1);
-			indices.push_back(vertexAttributes.firstIndex + 2);
-			indices.push_back(vertexAttributes.firstIndex + 3);
-		};
+			Nz::UInt32 rangeMask = ((blockCount[axis] >= 32) ? 0xFFFFFFFF : (Nz::UInt32(1) << blockCount[axis]) - 1) << firstBlock[axis];
+			const auto& faceCorners = s_faceCorners[direction];
 
-		for (unsigned int z = 0; z < m_size.z; ++z)
-		{
-			for (unsigned int y = 0; y < m_size.y; ++y)
+			Nz::Vector3ui blockIndices;
+			for (unsigned int v = firstBlock[vAxis]; v < firstBlock[vAxis] + blockCount[vAxis]; ++v)
 			{
-				for (unsigned int x = 0; x < m_size.x; ++x)
+				blockIndices[vAxis] = v;
+				for (unsigned int u = firstBlock[uAxis]; u < firstBlock[uAxis] + blockCount[uAxis]; ++u)
 				{
-					BlockIndex blockIndex = GetBlockContent({ x, y, z });
-					if (blockIndex == EmptyBlockIndex)
-						continue;
-
-					Nz::EnumArray<Nz::BoxCorner, Nz::Vector3f> corners = ComputeVoxelCorners({ x, y, z });
+					blockIndices[uAxis] = u;
 
-					Nz::Vector3f blockCenter = std::accumulate(corners.begin(), corners.end(), Nz::Vector3f::Zero()) / corners.size();
-
-					// Up
-					if (auto neighborOpt = GetNeighborBlock({ x, y, z }, { 0, 0, 1 }); !neighborOpt || neighborOpt == EmptyBlockIndex)
-						DrawFace(blockIndex, blockCenter, { corners[Nz::BoxCorner::FarLeftTop], corners[Nz::BoxCorner::FarRightTop], corners[Nz::BoxCorner::NearLeftTop], corners[Nz::BoxCorner::NearRightTop] });
-
-					// Down
-					if (auto neighborOpt = GetNeighborBlock({ x, y, z }, { 0, 0, -1 }); !neighborOpt || neighborOpt == EmptyBlockIndex)
-						DrawFace(blockIndex, blockCenter, { corners[Nz::BoxCorner::FarRightBottom], corners[Nz::BoxCorner::FarLeftBottom], corners[Nz::BoxCorner::NearRightBottom], corners[Nz::BoxCorner::NearLeftBottom] });
+					Nz::UInt32 visibleFaces = snapshot.ComputeVisibleFaces(direction, blockIndices) & rangeMask;
+					while (visibleFaces != 0)
+					{
+						blockIndices[axis] = std::countr_zero(visibleFaces);
+						visibleFaces &= visibleFaces - 1;
 
-					// Front
-					if (auto neighborOpt = GetNeighborBlock({ x, y, z }, { 0, -1, 0 }); !neighborOpt || neighborOpt == EmptyBlockIndex)
-						DrawFace(blockIndex, blockCenter, { corners[Nz::BoxCorner::FarRightTop], corners[Nz::BoxCorner::FarLeftTop], corners[Nz::BoxCorner::FarRightBottom], corners[Nz::BoxCorner::FarLeftBottom] });
+						Nz::EnumArray<Nz::BoxCorner, Nz::Vector3f> corners = ComputeVoxelCorners(blockIndices);
+						Nz::Vector3f blockCenter = std::accumulate(corners.begin(), corners.end(), Nz::Vector3f::Zero()) / corners.size();
 
-					// Back
-					if (auto neighborOpt = GetNeighborBlock({ x, y, z }, { 0, 1, 0 }); !neighborOpt || neighborOpt == EmptyBlockIndex)
-						DrawFace(blockIndex, blockCenter, { corners[Nz::BoxCorner::NearLeftTop], corners[Nz::BoxCorner::NearRightTop], corners[Nz::BoxCorner::NearLeftBottom], corners[Nz::BoxCorner::NearRightBottom] });
+						std::array<Nz::Vector3f, 4> pos = { corners[faceCorners[0]], corners[faceCorners[1]], corners[faceCorners[2]], corners[faceCorners[3]] };
 
-					// Left
-					if (auto neighborOpt = GetNeighborBlock({ x, y, z }, { -1, 0, 0 }); !neighborOpt || neighborOpt == EmptyBlockIndex)
-						DrawFace(blockIndex, blockCenter, { corners[Nz::BoxCorner::FarLeftTop], corners[Nz::BoxCorner::NearLeftTop], corners[Nz::BoxCorner::FarLeftBottom], corners[Nz::BoxCorner::NearLeftBottom] });
+						// Get face up vector
+						Nz::Vector3f faceCenter = std::accumulate(pos.begin(), pos.end(), Nz::Vector3f::Zero()) / pos.size();
+						Direction upDirection = DirectionFromNormal(Nz::Vector3f::Normalize(faceCenter - gravityCenter));
 
-					// Right
-					if (auto neighborOpt = GetNeighborBlock({ x, y, z }, { 1, 0, 0 }); !neighborOpt || neighborOpt == EmptyBlockIndex)
-						DrawFace(blockIndex, blockCenter, { corners[Nz::BoxCorner::NearRightTop], corners[Nz::BoxCorner::FarRightTop], corners[Nz::BoxCorner::NearRightBottom], corners[Nz::BoxCorner::FarRightBottom] });
+						DrawFace(blockManager, indices, addVertices, snapshot.GetBlockContent(blockIndices), upDirection, blockCenter, pos);
+					}
 				}
 			}
 		}
 	}
 
+	Nz::UInt64 Chunk::ComputeGeometryHash() const
+	{
+		// Chunks of the same type and dimensions build the same colliders out of the same blocks
+		ContentHasher hasher;
+		hasher.Append(typeid(*this).hash_code());
+		hasher.Append(m_size.x);
+		hasher.Append(m_size.y);
+		hasher.Append(m_size.z);
+		hasher.Append(std::bit_cast<Nz::UInt32>(m_blockSize));
+
+		return hasher.GetHash();
+	}
+
+	// Resets all blocks to the same type, without going through unpacked blocks
+	void Chunk::Fill(BlockIndex blockIndex)
+	{
+		GetWritableContent().blocks.Fill(blockIndex);
+		OnChunkReset();
+	}
+
 	void Chunk::Serialize(const BlockLibrary& blockLibrary, Nz::ByteStream& byteStream)
 	{
 		byteStream << Constants::ChunkBinaryVersion;
 		byteStream << m_size;
 
-		std::vector<BlockIndex> serializationIndices(m_blockTypeCount.size());
-		Nz::UInt16 nextUniqueIndex = 0;
+		// Block types are serialized in ascending order
+		const BlockStorage& blockStorage = m_content->blocks;
 
-		for (BlockIndex i = 0; i < m_blockTypeCount.size(); ++i)
+		std::vector<BlockIndex> usedBlocks;
+		usedBlocks.reserve(blockStorage.GetUsedPaletteEntryCount());
+		for (const BlockStorage::PaletteEntry& paletteEntry : blockStorage.GetPalette())
 		{
-			if (m_blockTypeCount[i] == 0)
-				continue;
-
-			serializationIndices[i] = nextUniqueIndex++;
+			if (paletteEntry.count > 0)
+				usedBlocks.push_back(paletteEntry.blockIndex);
 		}
+		std::sort(usedBlocks.begin(), usedBlocks.end());
 
-		byteStream << Nz::SafeCast<Nz::UInt16>(nextUniqueIndex);
-		for (BlockIndex i = 0; i < m_blockTypeCount.size(); ++i)
-		{
-			if (m_blockTypeCount[i] == 0)
-				continue;
+		std::vector<BlockIndex> serializationIndices(usedBlocks.back() + 1);
+		Nz::UInt16 nextUniqueIndex = 0;
 
-			byteStream << blockLibrary.GetBlockData(i).name;
+		byteStream << Nz::SafeCast<Nz::UInt16>(usedBlocks.size());
+		for (BlockIndex blockIndex : usedBlocks)
+		{
+			serializationIndices[blockIndex] = nextUniqueIndex++;
+			byteStream << blockLibrary.GetBlockData(blockIndex).name;
 		}
 
+		// Uniform chunks don't store per-block data
+		if (usedBlocks.size() == 1)
+			return;
+
+		std::vector<BlockIndex> blocks(blockStorage.GetBlockCount());
+		blockStorage.Store(blocks.data());
+
 		// nextUniqueIndex is the number of bits required to store all the different block types used
 		if (nextUniqueIndex > 8)
 		{
-			for (BlockIndex blockIndex : m_blocks)
+			for (BlockIndex blockIndex : blocks)
 				byteStream << static_cast<Nz::UInt16>(serializationIndices[blockIndex]);
 		}
 		else
 		{
-			for (BlockIndex blockIndex : m_blocks)
+			for (BlockIndex blockIndex : blocks)
 				byteStream << static_cast<Nz::UInt8>(serializationIndices[blockIndex]);
 		}
 	}
@@ -184,7 +153,8 @@ namespace tsom
 		Nz::UInt32 chunkBinaryVersion;
 		byteStream >> chunkBinaryVersion;
 
-		if (chunkBinaryVersion != Constants::ChunkBinaryVersion)
+		// Version 1 stored per-block data even for uniform chunks
+		if (chunkBinaryVersion != 1 && chunkBinaryVersion != Constants::ChunkBinaryVersion)
 			throw std::runtime_error("incompatible chunk version");
 
 		Nz::Vector3ui chunkSize;
@@ -212,7 +182,14 @@ namespace tsom
 			deserializationIndices.push_back(blockIndex);
 		}
 
-		std::vector<BlockIndex> blocks(m_blocks.size());
+		if (blockTypeCount == 1 && chunkBinaryVersion >= 2)
+		{
+			GetWritableContent().blocks.Fill(deserializationIndices.front());
+			OnChunkReset();
+			return;
+		}
+
+		std::vector<BlockIndex> blocks(m_content->blocks.GetBlockCount());
 		if (blockTypeCount > 8)
 		{
 			for (BlockIndex& blockIndex : blocks)
@@ -234,24 +211,125 @@ namespace tsom
 			}
 		}
 
-		m_blocks = std::move(blocks);
+		GetWritableContent().blocks.Load(blocks.data());
 		OnChunkReset();
 	}
 
-	void Chunk::OnChunkReset()
+	ChunkSnapshot Chunk::TakeSnapshot() const
+	{
+		// Keep the chunk locked while grabbing neighbor contents, so they can't be unlinked and destroyed (Planet::RemoveChunk) in the meantime
+		// neighbors are only tried, two snapshots of adjacent chunks could otherwise deadlock behind writers waiting on both chunks
+		for (;;)
+		{
+			std::shared_lock lock(m_mutex);
+
+			Nz::EnumArray<Direction, std::shared_ptr<const ChunkContent>> neighborContents;
+			bool lockedNeighbors = true;
+			for (auto&& [direction, neighbor] : m_neighbors.iter_kv())
+			{
+				if (!neighbor)
+					continue;
+
+				std::shared_lock neighborLock(neighbor->m_mutex, std::try_to_lock);
+				if (!neighborLock.owns_lock())
+				{
+					lockedNeighbors = false;
+					break;
+				}
+
+				neighborContents[direction] = neighbor->m_content;
+			}
+
+			if (lockedNeighbors)
+				return ChunkSnapshot(m_size, m_content, std::move(neighborContents));
+
+			// Neighbor is being written, let it finish without holding this chunk
+			lock.unlock();
+			std::this_thread::yield();
+		}
+	}
+
+	void Chunk::UpdateBlocks(std::span<const BlockUpdate> updates)
 	{
-		std::fill(m_blockTypeCount.begin(), m_blockTypeCount.end(), 0);
-		for (std::size_t blockIndex = 0; blockIndex < m_blocks.size(); ++blockIndex)
+		if (updates.empty())
+			return;
+
+		ChunkContent& content = GetWritableContent();
+		for (const BlockUpdate& update : updates)
 		{
-			BlockIndex blockContent = m_blocks[blockIndex];
-			m_collisionCellMask[blockIndex] = (blockContent != EmptyBlockIndex);
+			content.blocks.UpdateBlock(GetBlockLocalIndex(update.indices), update.newBlock);
+			content.occupancy.Set(update.indices, update.newBlock != EmptyBlockIndex);
+			content.InvalidateBrick(update.indices);
+		}
+
+		// Release occupancy columns if the chunk became uniform
+		if (content.blocks.IsUniform() && !content.occupancy.IsUniform())
+			content.occupancy.Reset(content.blocks);
+
+		OnBlocksUpdated(this, updates);
+	}
+
+	ChunkContent& Chunk::GetWritableContent()
+	{
+		// Content may be referenced by snapshots, which expect it to never change
+		if (m_content.use_count() > 1)
+			m_content = std::make_shared<ChunkContent>(*m_content);
+
+		m_content->version = GenerateContentVersion();
+		return *m_content;
+	}
+
+	void Chunk::DrawFace(const BlockLibrary& blockManager, std::vector<Nz::UInt32>& indices, const Nz::FunctionRef<VertexAttributes(Nz::UInt32 count)>& addVertices, BlockIndex blockIndex, Direction upDirection, const Nz::Vector3f& blockCenter, const std::array<Nz::Vector3f, 4>& pos)
+	{
+		VertexAttributes vertexAttributes = addVertices(pos.size());
+		assert(vertexAttributes.position);
 
-			if (blockContent >= m_blockTypeCount.size())
-				m_blockTypeCount.resize(blockContent + 1);
+		for (std::size_t i = 0; i < pos.size(); ++i)
+			vertexAttributes.position[i] = pos[i];
 
-			m_blockTypeCount[blockContent]++;
+		Nz::Vector3f faceCenter = std::accumulate(pos.begin(), pos.end(), Nz::Vector3f::Zero()) / pos.size();
+		Nz::Vector3f faceDirection = Nz::Vector3f::Normalize(faceCenter - blockCenter);
+
+		if (vertexAttributes.normal)
+		{
+			for (std::size_t i = 0; i < pos.size(); ++i)
+				vertexAttributes.normal[i] = faceDirection;
 		}
 
+		if (vertexAttributes.uv || vertexAttributes.tangent)
+		{
+			ChunkMesherBase::FaceTexturing texturing = ChunkMesherBase::ComputeFaceTexturing(pos, faceDirection, blockCenter, upDirection);
+
+			if (vertexAttributes.tangent)
+			{
+				for (std::size_t i = 0; i < pos.size(); ++i)
+					vertexAttributes.tangent[i] = texturing.tangent;
+			}
+
+			if (vertexAttributes.uv)
+			{
+				float sliceIndex = blockManager.GetBlockData(blockIndex).texIndices[texturing.texDirection];
+				for (std::size_t i = 0; i < pos.size(); ++i)
+					vertexAttributes.uv[i] = Nz::Vector3f(texturing.uvs[i], sliceIndex);
+			}
+		}
+
+		for (Nz::UInt32 index : ChunkMesherBase::s_faceIndices)
+			indices.push_back(vertexAttributes.firstIndex + index);
+	}
+
+	void Chunk::OnChunkReset()
+	{
+		m_content->InvalidateBricks();
+		m_content->occupancy.Reset(m_content->blocks);
+
 		OnReset(this);
 	}
+
+	Nz::UInt64 Chunk::GenerateContentVersion()
+	{
+		// Versions are unique across chunks, so that snapshots can compare neighbor versions even when a neighbor was replaced
+		static std::atomic<Nz::UInt64> s_nextContentVersion = 1;
+		return s_nextContentVersion++;
+	}
 }
@@ -0,0 +1,89 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com) (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CommonLib/ChunkColliderCache.hpp>
+#include <CommonLib/ChunkSnapshot.hpp>
+#include <CommonLib/FlatChunk.hpp>
+#include <Nazara/Physics3D/Collider3D.hpp>
+
+namespace tsom
+{
+	std::shared_ptr<Nz::Collider3D> ChunkColliderCache::Build(const BlockLibrary& blockLibrary, const Chunk& chunk, const ChunkSnapshot& snapshot, const ChunkColliderCache* previousCache, const std::atomic_bool* cancelled)
+	{
+		m_rebuiltBrickCount = 0;
+
+		// Uniform chunks are covered by a single shape, there's nothing to reuse
+		if (snapshot.IsUniform() && !m_settings.surfaceOnly)
+		{
+			m_bricks.clear();
+			return chunk.BuildCollider(blockLibrary, snapshot, m_settings);
+		}
+
+		const Nz::Vector3ui& brickGridSize = snapshot.GetBrickGridSize();
+
+		m_bricks.resize(brickGridSize.x * brickGridSize.y * brickGridSize.z);
+		if (previousCache && (previousCache->m_bricks.size() != m_bricks.size() || previousCache->m_settings != m_settings))
+			previousCache = nullptr;
+
+		// Surface-only colliders depend on the blocks around them: direct neighbors for the exposed faces and, for thicker shells,
+		// every brick (diagonals included) closer than the shell thickness; deformed chunk colliders are made of visible faces
+		bool dependsOnNeighbors = m_settings.surfaceOnly || !dynamic_cast<const FlatChunk*>(&chunk);
+		unsigned int shellBrickRadius = (m_settings.surfaceOnly && m_settings.shellThickness > 1) ? (m_settings.shellThickness + ChunkContent::BrickSize - 1) / ChunkContent::BrickSize : 0;
+
+		std::vector<Nz::CompoundCollider3D::ChildCollider> childColliders;
+		for (unsigned int z = 0; z < brickGridSize.z; ++z)
+		{
+			for (unsigned int y = 0; y < brickGridSize.y; ++y)
+			{
+				for (unsigned int x = 0; x < brickGridSize.x; ++x)
+				{
+					// Chunk changed again while its collider was being built
+					if (cancelled && *cancelled)
+						return {};
+
+					Nz::Vector3ui brickIndices(x, y, z);
+					unsigned int brickIndex = snapshot.GetBrickLocalIndex(brickIndices);
+
+					BrickCollider& brickCollider = m_bricks[brickIndex];
+					brickCollider.version = snapshot.GetBrickVersion(brickIndices);
+					brickCollider.surroundingVersion = (shellBrickRadius > 0) ? snapshot.ComputeSurroundingBrickVersion(brickIndices, shellBrickRadius) : 0;
+					for (auto&& [direction, neighborVersion] : brickCollider.neighborVersions.iter_kv())
+						neighborVersion = (dependsOnNeighbors) ? snapshot.GetNeighborBrickVersion(brickIndices, direction) : 0;
+
+					const BrickCollider* previousBrickCollider = (previousCache) ? &previousCache->m_bricks[brickIndex] : nullptr;
+					if (previousBrickCollider && previousBrickCollider->version == brickCollider.version && previousBrickCollider->neighborVersions == brickCollider.neighborVersions && previousBrickCollider->surroundingVersion == brickCollider.surroundingVersion)
+						brickCollider.childColliders = previousBrickCollider->childColliders;
+					else
+					{
+						brickCollider.childColliders.clear();
+						if (std::shared_ptr<Nz::Collider3D> collider = chunk.BuildCollider(blockLibrary, snapshot, snapshot.GetBrickBlocks(brickIndices), m_settings))
+						{
+							// Brick colliders are expressed in chunk space, keep their shapes so they can be merged into a single compound
+							if (const Nz::CompoundCollider3D* compound = dynamic_cast<const Nz::CompoundCollider3D*>(collider.get()))
+								brickCollider.childColliders = compound->GetGeoms();
+							else
+							{
+								auto& childCollider = brickCollider.childColliders.emplace_back();
+								childCollider.collider = std::move(collider);
+								childCollider.offset = Nz::Vector3f::Zero();
+							}
+						}
+
+						m_rebuiltBrickCount++;
+					}
+
+					childColliders.insert(childColliders.end(), brickCollider.childColliders.begin(), brickCollider.childColliders.end());
+				}
+			}
+		}
+
+		if (childColliders.empty())
+			return {};
+
+		if (childColliders.size() == 1 && childColliders.front().offset == Nz::Vector3f::Zero())
+			return std::move(childColliders.front().collider);
+
+		return std::make_shared<Nz::CompoundCollider3D>(std::move(childColliders));
+	}
+}
@@ -0,0 +1,87 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com) (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CommonLib/ChunkColliderResidency.hpp>
+#include <CommonLib/ChunkContainer.hpp>
+#include <algorithm>
+
+namespace tsom
+{
+	void ChunkColliderResidency::ReleaseChunk(const ChunkIndices& chunkIndices)
+	{
+		m_residentChunks.erase(chunkIndices);
+	}
+
+	void ChunkColliderResidency::ReleaseExpiredChunks(Nz::Time now, const ChunkCallback& releaseCallback)
+	{
+		// The delay prevents rebuilding colliders over and over when a body moves along a chunk border
+		for (auto it = m_residentChunks.begin(); it != m_residentChunks.end();)
+		{
+			if (now - it->second < m_settings.releaseDelay)
+			{
+				++it;
+				continue;
+			}
+
+			ChunkIndices chunkIndices = it->first;
+			it = m_residentChunks.erase(it);
+
+			releaseCallback(chunkIndices);
+		}
+	}
+
+	void ChunkColliderResidency::RequestChunks(const ChunkContainer& chunkContainer, const Nz::Vector3f& position, const Nz::Vector3f& linearVelocity, Nz::Time now, const ChunkCallback& acquireCallback)
+	{
+		ForEachRequestedChunk(chunkContainer, m_settings, position, linearVelocity, [&](const ChunkIndices& chunkIndices)
+		{
+			auto [it, inserted] = m_residentChunks.insert_or_assign(chunkIndices, now);
+			if (inserted)
+				acquireCallback(chunkIndices);
+		});
+	}
+
+	void ChunkColliderResidency::ForEachRequestedChunk(const ChunkContainer& chunkContainer, const Settings& settings, const Nz::Vector3f& position, const Nz::Vector3f& linearVelocity, const ChunkCallback& callback)
+	{
+		float radius = settings.radius;
+		float radiusSq = radius * radius;
+		Nz::Vector3f halfChunkSize = Nz::Vector3f(ChunkContainer::ChunkSize * chunkContainer.GetTileSize() * 0.5f);
+
+		auto RequestColliders = [&](const Nz::Vector3f& requestPosition)
+		{
+			ChunkIndices firstChunk = chunkContainer.GetChunkIndicesByPosition(requestPosition - Nz::Vector3f(radius));
+			ChunkIndices lastChunk = chunkContainer.GetChunkIndicesByPosition(requestPosition + Nz::Vector3f(radius));
+
+			for (Nz::Int32 z = firstChunk.z; z <= lastChunk.z; ++z)
+			{
+				for (Nz::Int32 y = firstChunk.y; y <= lastChunk.y; ++y)
+				{
+					for (Nz::Int32 x = firstChunk.x; x <= lastChunk.x; ++x)
+					{
+						ChunkIndices chunkIndices(x, y, z);
+						if (!chunkContainer.GetChunk(chunkIndices))
+							continue;
+
+						// Distance from the body to the chunk bounds
+						Nz::Vector3f chunkCenter = chunkContainer.GetChunkOffset(chunkIndices);
+						Nz::Vector3f closestPoint;
+						closestPoint.x = std::clamp(requestPosition.x, chunkCenter.x - halfChunkSize.x, chunkCenter.x + halfChunkSize.x);
+						closestPoint.y = std::clamp(requestPosition.y, chunkCenter.y - halfChunkSize.y, chunkCenter.y + halfChunkSize.y);
+						closestPoint.z = std::clamp(requestPosition.z, chunkCenter.z - halfChunkSize.z, chunkCenter.z + halfChunkSize.z);
+						if (closestPoint.SquaredDistance(requestPosition) > radiusSq)
+							continue;
+
+						callback(chunkIndices);
+					}
+				}
+			}
+		};
+
+		// Request colliders around the body, and around where it's heading to build them before it arrives
+		RequestColliders(position);
+
+		Nz::Vector3f futurePosition = position + linearVelocity * settings.lookAhead.AsSeconds<float>();
+		if (futurePosition.SquaredDistance(position) > halfChunkSize.GetSquaredLength())
+			RequestColliders(futurePosition);
+	}
+}
@@ -0,0 +1,128 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com) (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CommonLib/ChunkConnectivity.hpp>
+#include <CommonLib/ChunkOccupancy.hpp>
+#include <vector>
+
+namespace tsom
+{
+	// Flood fills each group of connected empty blocks and connects all chunk faces it touches
+	void ChunkConnectivity::Reset(const ChunkOccupancy& occupancy)
+	{
+		m_connections = 0;
+
+		const Nz::Vector3ui& size = occupancy.GetSize();
+		if (occupancy.IsUniform())
+		{
+			if (!occupancy.IsOccupied({ 0, 0, 0 }))
+				m_connections = FullConnectionMask;
+
+			return;
+		}
+
+		// Flood fill works on X rows of empty blocks (indexed by z * size.y + y), spreading whole runs of blocks at once
+		Nz::UInt32 rowMask = occupancy.GetColumnMask(0);
+		Nz::UInt32 firstBlock = 1;
+		Nz::UInt32 lastBlock = Nz::UInt32(1) << (size.x - 1);
+
+		std::vector<Nz::UInt32> emptyRows(std::size_t(size.y) * size.z);
+		for (unsigned int z = 0; z < size.z; ++z)
+		{
+			for (unsigned int y = 0; y < size.y; ++y)
+				emptyRows[std::size_t(z) * size.y + y] = ~occupancy.GetColumn(0, { 0, y, z }) & rowMask;
+		}
+
+		struct RowFill
+		{
+			unsigned int y;
+			unsigned int z;
+			Nz::UInt32 blocks;
+		};
+
+		std::vector<RowFill> pendingFills;
+		for (unsigned int z = 0; z < size.z; ++z)
+		{
+			for (unsigned int y = 0; y < size.y; ++y)
+			{
+				Nz::UInt32& seedRow = emptyRows[std::size_t(z) * size.y + y];
+				while (seedRow != 0)
+				{
+					unsigned int faces = 0;
+					auto TouchFace = [&](Direction direction)
+					{
+						faces |= 1u << static_cast<unsigned int>(direction);
+					};
+
+					// Filled blocks are removed from emptyRows
+					pendingFills.push_back({ y, z, seedRow & (~seedRow + 1) });
+					while (!pendingFills.empty())
+					{
+						RowFill fill = pendingFills.back();
+						pendingFills.pop_back();
+
+						Nz::UInt32& row = emptyRows[std::size_t(fill.z) * size.y + fill.y];
+						Nz::UInt32 blocks = fill.blocks & row;
+						if (blocks == 0)
+							continue;
+
+						// Spread along the row to the whole runs of empty blocks
+						for (;;)
+						{
+							Nz::UInt32 spreadBlocks = (blocks | (blocks << 1) | (blocks >> 1)) & row;
+							if (spreadBlocks == blocks)
+								break;
+
+							blocks = spreadBlocks;
+						}
+
+						row &= ~blocks;
+
+						if (blocks & firstBlock)
+							TouchFace(Direction::Left);
+
+						if (blocks & lastBlock)
+							TouchFace(Direction::Right);
+
+						// Block (x, y, z) is positioned at (x, z, y)
+						if (fill.y == 0)
+							TouchFace(Direction::Front);
+						else
+							pendingFills.push_back({ fill.y - 1, fill.z, blocks });
+
+						if (fill.y == size.y - 1)
+							TouchFace(Direction::Back);
+						else
+							pendingFills.push_back({ fill.y + 1, fill.z, blocks });
+
+						if (fill.z == 0)
+							TouchFace(Direction::Down);
+						else
+							pendingFills.push_back({ fill.y, fill.z - 1, blocks });
+
+						if (fill.z == size.z - 1)
+							TouchFace(Direction::Up);
+						else
+							pendingFills.push_back({ fill.y, fill.z + 1, blocks });
+					}
+
+					for (unsigned int first = 0; first < FaceCount; ++first)
+					{
+						if ((faces & (1u << first)) == 0)
+							continue;
+
+						for (unsigned int second = 0; second < FaceCount; ++second)
+						{
+							if (faces & (1u << second))
+								Connect(static_cast<Direction>(first), static_cast<Direction>(second));
+						}
+					}
+
+					if (IsFullyConnected())
+						return;
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,77 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com) (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CommonLib/ChunkDirectionBounds.hpp>
+#include <CommonLib/ChunkMesher.hpp>
+#include <algorithm>
+
+namespace tsom
+{
+	void ChunkDirectionBounds::AddFace(Direction direction, const std::array<Nz::Vector3f, 4>& positions, const Nz::Vector3f& outsideNormal)
+	{
+		Bounds& bounds = m_bounds[direction];
+		if (bounds.faceCount == 0)
+			bounds.box = Nz::Boxf(positions[0], Nz::Vector3f::Zero());
+
+		for (const Nz::Vector3f& position : positions)
+			bounds.box.ExtendTo(position);
+
+		// Deformed faces aren't planar nor aligned with their direction, bound the normals of both their triangles
+		const auto& faceIndices = ChunkMesherBase::s_faceIndices;
+		for (std::size_t i = 0; i < faceIndices.size(); i += 3)
+		{
+			const Nz::Vector3f& a = positions[faceIndices[i + 0]];
+			const Nz::Vector3f& b = positions[faceIndices[i + 1]];
+			const Nz::Vector3f& c = positions[faceIndices[i + 2]];
+
+			Nz::Vector3f triangleNormal = (b - a).CrossProduct(c - a);
+			float length = triangleNormal.GetLength();
+			if (length <= 0.f)
+				continue;
+
+			// Winding is the same for all faces, orient the normal outside
+			triangleNormal /= length;
+			if (triangleNormal.DotProduct(outsideNormal) < 0.f)
+				triangleNormal = -triangleNormal;
+
+			bounds.normalDeviation = std::max(bounds.normalDeviation, (triangleNormal - s_dirNormals[direction]).GetLength());
+		}
+
+		bounds.faceCount++;
+	}
+
+	bool ChunkDirectionBounds::IsBackFacing(Direction direction, const Nz::Vector3f& viewerPosition) const
+	{
+		const Bounds& bounds = m_bounds[direction];
+		if (bounds.faceCount == 0)
+			return true;
+
+		// All triangles face away when dot(p - viewer, n) >= 0 for any of their points p = center + e (|e.i| <= halfExtents.i) and normals n = axis + d (|d| <= normalDeviation)
+		// dot(toCenter + e, axis + d) >= dot(toCenter, axis) - dot(halfExtents, |axis|) - (|toCenter| + |halfExtents|) * normalDeviation
+		const Nz::Vector3f& axis = s_dirNormals[direction];
+		Nz::Vector3f halfExtents = bounds.box.GetLengths() * 0.5f;
+		Nz::Vector3f toCenter = bounds.box.GetCenter() - viewerPosition;
+
+		float lowerBound = toCenter.DotProduct(axis) - halfExtents.DotProduct(axis.GetAbs()) - (toCenter.GetLength() + halfExtents.GetLength()) * bounds.normalDeviation;
+		return lowerBound > 0.f;
+	}
+
+	void ChunkDirectionBounds::Merge(const ChunkDirectionBounds& directionBounds)
+	{
+		for (auto&& [direction, bounds] : m_bounds.iter_kv())
+		{
+			const Bounds& otherBounds = directionBounds.m_bounds[direction];
+			if (otherBounds.faceCount == 0)
+				continue;
+
+			if (bounds.faceCount == 0)
+				bounds.box = otherBounds.box;
+			else
+				bounds.box.ExtendTo(otherBounds.box);
+
+			bounds.normalDeviation = std::max(bounds.normalDeviation, otherBounds.normalDeviation);
+			bounds.faceCount += otherBounds.faceCount;
+		}
+	}
+}
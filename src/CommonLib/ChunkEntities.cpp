@@ -4,12 +4,19 @@
 
 #include <CommonLib/ChunkEntities.hpp>
 #include <CommonLib/BlockLibrary.hpp>
+#include <CommonLib/Utility/ContentHasher.hpp>
 #include <Nazara/Core/ApplicationBase.hpp>
 #include <Nazara/Core/EnttWorld.hpp>
 #include <Nazara/Core/TaskSchedulerAppComponent.hpp>
+#include <Nazara/Core/Components/DisabledComponent.hpp>
 #include <Nazara/Core/Components/NodeComponent.hpp>
+#include <Nazara/Physics3D/Collider3D.hpp>
+#include <Nazara/Physics3D/Components/PhysCharacter3DComponent.hpp>
 #include <Nazara/Physics3D/Components/RigidBody3DComponent.hpp>
+#include <algorithm>
 #include <cassert>
+#include <limits>
+#include <thread>
 
 namespace tsom
 {
@@ -20,6 +27,9 @@ namespace tsom
 	}
 
 	ChunkEntities::ChunkEntities(Nz::ApplicationBase& application, Nz::EnttWorld& world, const ChunkContainer& chunkContainer, const BlockLibrary& blockLibrary, NoInit) :
+	m_jobScheduler(ChunkContainer::ChunkSize * chunkContainer.GetTileSize(), std::max(std::thread::hardware_concurrency(), 1u) * 2),
+	m_colliderJobPool(JobPoolCapacity),
+	m_colliderCache(DefaultColliderCacheCapacity),
 	m_world(world),
 	m_application(application),
 	m_blockLibrary(blockLibrary),
@@ -30,6 +40,11 @@ namespace tsom
 			CreateChunkEntity(chunk->GetIndices(), chunk);
 		});
 
+		m_onChunkNeighborUpdated.Connect(chunkContainer.OnChunkNeighborUpdated, [this](ChunkContainer* /*emitter*/, Chunk* chunk, Direction /*neighborDirection*/)
+		{
+			m_invalidatedChunks.insert(chunk->GetIndices());
+		});
+
 		m_onChunkRemove.Connect(chunkContainer.OnChunkRemove, [this](ChunkContainer* /*emitter*/, Chunk* chunk)
 		{
 			DestroyChunkEntity(chunk->GetIndices());
@@ -51,32 +66,151 @@ namespace tsom
 		}
 	}
 
-	void ChunkEntities::Update()
+	void ChunkEntities::SetColliderResidencySettings(const ColliderResidencySettings& residencySettings)
+	{
+		// Let the next update request colliders around bodies again, chunks which are no longer resident will drop their collider
+		m_colliderResidency.SetSettings(residencySettings);
+		for (auto it = m_chunkEntities.begin(); it != m_chunkEntities.end(); ++it)
+			m_invalidatedChunks.insert(it->first);
+	}
+
+	void ChunkEntities::SetColliderSettings(const Chunk::ColliderSettings& colliderSettings)
 	{
-		for (auto it = m_updateJobs.begin(); it != m_updateJobs.end(); )
+		m_colliderSettings = colliderSettings;
+
+		// Pending jobs were scheduled with the previous settings
+		for (auto it = m_updateJobs.begin(); it != m_updateJobs.end(); ++it)
+			it->second->cancelled = true;
+
+		m_jobScheduler.Clear();
+		m_updateJobs.clear();
+
+		// Rebuild all chunks colliders
+		m_chunkColliderCaches.clear();
+		for (auto it = m_chunkEntities.begin(); it != m_chunkEntities.end(); ++it)
+			m_invalidatedChunks.insert(it->first);
+	}
+
+	void ChunkEntities::Update(std::span<const Nz::Vector3f> viewerPositions)
+	{
+		// Applying a job (collider and mesh upload) has a main thread cost, bursts of chunk updates are spread over several updates closest chunks first
+		m_finishedJobs.clear();
+		for (auto it = m_updateJobs.begin(); it != m_updateJobs.end(); ++it)
 		{
-			UpdateJob& job = *it->second;
+			const UpdateJob& job = *it->second;
 			if (job.executionCounter != job.taskCount)
-			{
-				++it;
 				continue;
-			}
 
-			job.applyFunc(it->first, std::move(job));
-			it = m_updateJobs.erase(it);
+			float viewerDistanceSq = std::numeric_limits<float>::infinity();
+
+			Nz::Vector3f chunkCenter = m_chunkContainer.GetChunkOffset(it->first);
+			for (const Nz::Vector3f& viewerPosition : viewerPositions)
+				viewerDistanceSq = std::min(viewerDistanceSq, chunkCenter.SquaredDistance(viewerPosition));
+
+			m_finishedJobs.emplace_back(viewerDistanceSq, it->first);
 		}
 
+		std::sort(m_finishedJobs.begin(), m_finishedJobs.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
+		Nz::HighPrecisionClock applyClock;
+
+		std::size_t appliedJobCount = 0;
+		for (const auto& [viewerDistanceSq, chunkIndices] : m_finishedJobs)
+		{
+			if (m_jobApplySettings.enabled && appliedJobCount > 0 && applyClock.GetElapsedTime() >= m_jobApplySettings.budget)
+				break;
+
+			auto it = m_updateJobs.find(chunkIndices);
+			assert(it != m_updateJobs.end());
+
+			std::shared_ptr<UpdateJob> job = std::move(it.value());
+			job->applyFunc(chunkIndices, std::move(*job));
+			m_updateJobs.erase(it);
+
+			RecycleJob(std::move(job));
+
+			appliedJobCount++;
+		}
+
+		m_jobApplyStats.applyTime = applyClock.GetElapsedTime();
+		m_jobApplyStats.appliedJobCount = appliedJobCount;
+		m_jobApplyStats.pendingJobCount = m_finishedJobs.size() - appliedJobCount;
+		m_jobApplyStats.runningJobCount = m_updateJobs.size() - m_jobApplyStats.pendingJobCount;
+
+		if (m_colliderResidency.GetSettings().enabled)
+			UpdateColliderResidency();
+
 		for (const ChunkIndices& chunkIndices : m_invalidatedChunks)
 			UpdateChunkEntity(chunkIndices);
 
 		m_invalidatedChunks.clear();
+
+		// Tasks only reach the task scheduler when a worker is about to be free, so nearby edits don't wait behind far chunks
+		auto& taskScheduler = m_application.GetComponent<Nz::TaskSchedulerAppComponent>();
+		m_jobScheduler.Dispatch(viewerPositions, [&](ChunkJobScheduler::Task&& task)
+		{
+			taskScheduler.AddTask(std::move(task));
+		});
+
+		m_jobApplyStats.queuedTaskCount = m_jobScheduler.GetPendingTaskCount();
+	}
+
+	void ChunkEntities::ApplyColliderUpdate(const ChunkIndices& chunkIndices, ColliderUpdateJob& job)
+	{
+		// Chunk may have been released while its collider was being built
+		if (!HasColliderResidency(chunkIndices))
+		{
+			ReleaseChunkCollider(chunkIndices);
+			return;
+		}
+
+		if (!job.buildCollider)
+			return;
+
+		if (!job.colliderCacheHit && !job.snapshot.IsEmpty())
+			m_colliderCache.Insert(job.colliderKey, { job.colliderCache, job.collider });
+
+		// Empty chunks don't go through collider building
+		if (!job.colliderCache->IsEmpty())
+			m_chunkColliderCaches.insert_or_assign(chunkIndices, std::move(job.colliderCache));
+		else
+			m_chunkColliderCaches.erase(chunkIndices);
+
+		// Chunks without collider have no rigid body, a null collider couldn't be changed back (see CreateChunkEntity)
+		entt::handle chunkEntity = Nz::Retrieve(m_chunkEntities, chunkIndices);
+		if (!job.collider)
+			chunkEntity.remove<Nz::RigidBody3DComponent>();
+		else if (auto* rigidBody = chunkEntity.try_get<Nz::RigidBody3DComponent>())
+			rigidBody->SetGeom(std::move(job.collider), false);
+		else
+			chunkEntity.emplace<Nz::RigidBody3DComponent>(Nz::RigidBody3D::StaticSettings(std::move(job.collider)));
+	}
+
+	Nz::UInt64 ChunkEntities::ComputeContentKey(const ChunkIndices& chunkIndices, const Chunk& chunk, const ChunkSnapshot& snapshot)
+	{
+		// Hashing blocks is the expensive part, only do it once per content version
+		ContentHash& contentHash = m_contentHashes[chunkIndices];
+		if (contentHash.version != snapshot.GetVersion())
+		{
+			contentHash.hash = snapshot.GetBlockStorage().ComputeContentHash();
+			contentHash.version = snapshot.GetVersion();
+		}
+
+		ContentHasher hasher;
+		hasher.Append(contentHash.hash);
+		hasher.Append(snapshot.ComputeNeighborBorderHash());
+		hasher.Append(chunk.ComputeGeometryHash());
+
+		return hasher.GetHash();
 	}
 
 	void ChunkEntities::CreateChunkEntity(const ChunkIndices& chunkIndices, const Chunk* chunk)
 	{
 		entt::handle chunkEntity = m_world.CreateEntity();
 		chunkEntity.emplace<Nz::NodeComponent>(m_chunkContainer.GetChunkOffset(chunkIndices));
-		chunkEntity.emplace<Nz::RigidBody3DComponent>(Nz::RigidBody3D::StaticSettings(std::make_shared<Nz::SphereCollider3D>(1.f))); //< FIXME: null collider couldn't be changed back (sensor issue), set to null when Nazara is updated
+		// Resident chunks get their rigid body once their collider is built
+		if (!m_colliderResidency.GetSettings().enabled)
+			chunkEntity.emplace<Nz::RigidBody3DComponent>(Nz::RigidBody3D::StaticSettings(std::make_shared<Nz::SphereCollider3D>(1.f))); //< FIXME: null collider couldn't be changed back (sensor issue), set to null when Nazara is updated
 
 		assert(!m_chunkEntities.contains(chunkIndices));
 		m_chunkEntities.insert_or_assign(chunkIndices, chunkEntity);
@@ -84,15 +218,29 @@ namespace tsom
 		HandleChunkUpdate(chunkIndices, chunk);
 	}
 
+	// Queued tasks of the job are dropped, and running ones stop at their next brick
+	void ChunkEntities::CancelUpdateJob(const ChunkIndices& chunkIndices)
+	{
+		auto it = m_updateJobs.find(chunkIndices);
+		if (it == m_updateJobs.end())
+			return;
+
+		std::shared_ptr<UpdateJob> job = std::move(it.value());
+		m_updateJobs.erase(it);
+
+		job->cancelled = true;
+		m_jobScheduler.Cancel(chunkIndices);
+
+		RecycleJob(std::move(job));
+	}
+
 	void ChunkEntities::DestroyChunkEntity(const ChunkIndices& chunkIndices)
 	{
-		if (auto it = m_updateJobs.find(chunkIndices); it != m_updateJobs.end())
-		{
-			UpdateJob& job = *it->second;
-			job.cancelled = true;
+		CancelUpdateJob(chunkIndices);
 
-			m_updateJobs.erase(chunkIndices);
-		}
+		m_chunkColliderCaches.erase(chunkIndices);
+		m_contentHashes.erase(chunkIndices);
+		m_colliderResidency.ReleaseChunk(chunkIndices);
 
 		if (auto it = m_chunkEntities.find(chunkIndices); it != m_chunkEntities.end())
 		{
@@ -117,30 +265,39 @@ namespace tsom
 		if (auto it = m_updateJobs.find(chunkIndices); it != m_updateJobs.end())
 		{
 			UpdateJob& job = *it->second;
-			job.cancelled = true;
+
+			// Chunk and its neighbors didn't change since this job was scheduled
+			if (job.snapshot.IsUpToDate(*chunk) && static_cast<ColliderUpdateJob&>(job).buildCollider == HasColliderResidency(chunkIndices))
+				return;
+
+			// Coalesce updates, only the latest content is worth building
+			CancelUpdateJob(chunkIndices);
 		}
 
-		std::shared_ptr<ColliderUpdateJob> updateJob = std::make_shared<ColliderUpdateJob>();
+		std::shared_ptr<ColliderUpdateJob> updateJob = m_colliderJobPool.Acquire();
 		updateJob->taskCount = 1;
+		updateJob->snapshot = chunk->TakeSnapshot();
+		PrepareColliderUpdate(chunkIndices, *chunk, *updateJob);
 
 		updateJob->applyFunc = [this](const ChunkIndices& chunkIndices, UpdateJob&& job)
 		{
-			ColliderUpdateJob&& colliderUpdateJob = static_cast<ColliderUpdateJob&&>(job);
-
-			entt::handle chunkEntity = Nz::Retrieve(m_chunkEntities, chunkIndices);
-			auto& rigidBody = chunkEntity.get<Nz::RigidBody3DComponent>();
-			rigidBody.SetGeom(std::move(colliderUpdateJob.collider), false);
+			ApplyColliderUpdate(chunkIndices, static_cast<ColliderUpdateJob&>(job));
 		};
 
-		auto& taskScheduler = m_application.GetComponent<Nz::TaskSchedulerAppComponent>();
-		taskScheduler.AddTask([this, chunk, updateJob]
+		// Empty and non-resident chunks have no collider and cached colliders are already built, no need to go through the task scheduler
+		if (!updateJob->buildCollider || updateJob->snapshot.IsEmpty() || updateJob->colliderCacheHit)
+		{
+			updateJob->executionCounter = updateJob->taskCount;
+			m_updateJobs.insert_or_assign(chunkIndices, std::move(updateJob));
+			return;
+		}
+
+		m_jobScheduler.Schedule(chunkIndices, [this, chunk, updateJob]
 		{
 			if (updateJob->cancelled)
 				return;
 
-			chunk->LockRead();
-			updateJob->collider = chunk->BuildCollider(m_blockLibrary);
-			chunk->UnlockRead();
+			updateJob->collider = updateJob->colliderCache->Build(m_blockLibrary, *chunk, updateJob->snapshot, updateJob->previousColliderCache.get(), &updateJob->cancelled);
 
 			updateJob->executionCounter++;
 		});
@@ -148,6 +305,47 @@ namespace tsom
 		m_updateJobs.insert_or_assign(chunkIndices, std::move(updateJob));
 	}
 
+	void ChunkEntities::PrepareColliderUpdate(const ChunkIndices& chunkIndices, const Chunk& chunk, ColliderUpdateJob& job)
+	{
+		job.buildCollider = HasColliderResidency(chunkIndices);
+		if (job.buildCollider && !job.snapshot.IsEmpty())
+		{
+			ContentHasher hasher;
+			hasher.Append(ComputeContentKey(chunkIndices, chunk, job.snapshot));
+			hasher.Append(m_colliderSettings.shellThickness);
+			hasher.Append(m_colliderSettings.surfaceOnly);
+			job.colliderKey = hasher.GetHash();
+
+			if (const CachedCollider* cachedCollider = m_colliderCache.Find(job.colliderKey))
+			{
+				job.colliderCache = cachedCollider->colliderCache;
+				job.collider = cachedCollider->collider;
+				job.colliderCacheHit = true;
+				return;
+			}
+		}
+
+		job.colliderCache = std::make_shared<ChunkColliderCache>(m_colliderSettings);
+
+		if (auto it = m_chunkColliderCaches.find(chunkIndices); it != m_chunkColliderCaches.end())
+			job.previousColliderCache = it->second;
+	}
+
+	void ChunkEntities::RecycleJob(std::shared_ptr<UpdateJob>&& job)
+	{
+		m_colliderJobPool.Release(std::static_pointer_cast<ColliderUpdateJob>(std::move(job)));
+	}
+
+	void ChunkEntities::ReleaseChunkCollider(const ChunkIndices& chunkIndices)
+	{
+		m_chunkColliderCaches.erase(chunkIndices);
+
+		// Remove the rigid body instead of setting a null collider, which couldn't be changed back (see CreateChunkEntity)
+		// a new one is created once the chunk collider is built again
+		if (entt::handle chunkEntity = Nz::Retrieve(m_chunkEntities, chunkIndices))
+			chunkEntity.remove<Nz::RigidBody3DComponent>();
+	}
+
 	void ChunkEntities::UpdateChunkEntity(const ChunkIndices& chunkIndices)
 	{
 		assert(m_chunkEntities.contains(chunkIndices));
@@ -156,4 +354,38 @@ namespace tsom
 
 		HandleChunkUpdate(chunkIndices, chunk);
 	}
+
+	void ChunkEntities::UpdateColliderResidency()
+	{
+		Nz::Time now = m_residencyClock.GetElapsedTime();
+
+		auto AcquireCollider = [&](const ChunkIndices& chunkIndices)
+		{
+			m_invalidatedChunks.insert(chunkIndices);
+		};
+
+		auto& registry = m_world.GetRegistry();
+
+		auto characterView = registry.view<Nz::PhysCharacter3DComponent>(entt::exclude<Nz::DisabledComponent>);
+		for (auto&& [entity, character] : characterView.each())
+			m_colliderResidency.RequestChunks(m_chunkContainer, character.GetPosition(), character.GetLinearVelocity(), now, AcquireCollider);
+
+		auto rigidBodyView = registry.view<Nz::RigidBody3DComponent>(entt::exclude<Nz::DisabledComponent>);
+		for (auto&& [entity, rigidBody] : rigidBodyView.each())
+		{
+			if (rigidBody.IsStatic())
+				continue;
+
+			m_colliderResidency.RequestChunks(m_chunkContainer, rigidBody.GetPosition(), rigidBody.GetLinearVelocity(), now, AcquireCollider);
+		}
+
+		// Drop colliders no body came close to for a while
+		m_colliderResidency.ReleaseExpiredChunks(now, [&](const ChunkIndices& chunkIndices)
+		{
+			ReleaseChunkCollider(chunkIndices);
+
+			// Cancel collider building in progress
+			m_invalidatedChunks.insert(chunkIndices);
+		});
+	}
 }
@@ -0,0 +1,90 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com) (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CommonLib/ChunkJobScheduler.hpp>
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+namespace tsom
+{
+	ChunkJobScheduler::ChunkJobScheduler(float chunkSize, unsigned int maxRunningTasks) :
+	m_runningTaskCount(std::make_shared<std::atomic_uint>(0)),
+	m_pendingTaskCount(0),
+	m_chunkSize(chunkSize),
+	m_maxRunningTasks(maxRunningTasks)
+	{
+	}
+
+	// Pending tasks of the chunk are dropped without running, running tasks have to be cancelled by their job
+	void ChunkJobScheduler::Cancel(const ChunkIndices& chunkIndices)
+	{
+		auto it = m_pendingTasks.find(chunkIndices);
+		if (it == m_pendingTasks.end())
+			return;
+
+		m_pendingTaskCount -= it->second.size();
+		m_pendingTasks.erase(it);
+	}
+
+	void ChunkJobScheduler::Clear()
+	{
+		m_pendingTasks.clear();
+		m_pendingTaskCount = 0;
+	}
+
+	void ChunkJobScheduler::Dispatch(std::span<const Nz::Vector3f> viewerPositions, const Nz::FunctionRef<void(Task&& task)>& submitTask)
+	{
+		unsigned int runningTaskCount = *m_runningTaskCount;
+		if (m_pendingTasks.empty() || runningTaskCount >= m_maxRunningTasks)
+			return;
+
+		unsigned int freeTaskCount = m_maxRunningTasks - runningTaskCount;
+
+		m_dispatchOrder.clear();
+		for (auto it = m_pendingTasks.begin(); it != m_pendingTasks.end(); ++it)
+		{
+			float viewerDistanceSq = std::numeric_limits<float>::infinity();
+
+			Nz::Vector3f chunkCenter = Nz::Vector3f(it->first) * m_chunkSize;
+			for (const Nz::Vector3f& viewerPosition : viewerPositions)
+				viewerDistanceSq = std::min(viewerDistanceSq, chunkCenter.SquaredDistance(viewerPosition));
+
+			m_dispatchOrder.emplace_back(viewerDistanceSq, it->first);
+		}
+
+		// Chunks have at least one task, only the closest chunks which can be dispatched need to be sorted
+		auto sortEnd = m_dispatchOrder.begin() + std::min<std::size_t>(freeTaskCount, m_dispatchOrder.size());
+		std::partial_sort(m_dispatchOrder.begin(), sortEnd, m_dispatchOrder.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
+		for (auto orderIt = m_dispatchOrder.begin(); orderIt != sortEnd && freeTaskCount > 0; ++orderIt)
+		{
+			assert(m_pendingTasks.contains(orderIt->second));
+			std::vector<Task>& chunkTasks = m_pendingTasks[orderIt->second];
+
+			// Tasks of a chunk are dispatched together as their job only completes once all of them ran
+			for (Task& task : chunkTasks)
+			{
+				m_runningTaskCount->fetch_add(1);
+				submitTask([runningTaskCount = m_runningTaskCount, task = std::move(task)]
+				{
+					task();
+					runningTaskCount->fetch_sub(1);
+				});
+
+				if (freeTaskCount > 0)
+					freeTaskCount--;
+			}
+
+			m_pendingTaskCount -= chunkTasks.size();
+			m_pendingTasks.erase(orderIt->second);
+		}
+	}
+
+	void ChunkJobScheduler::Schedule(const ChunkIndices& chunkIndices, Task&& task)
+	{
+		m_pendingTasks[chunkIndices].push_back(std::move(task));
+		m_pendingTaskCount++;
+	}
+}
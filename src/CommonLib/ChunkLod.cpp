@@ -0,0 +1,249 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com) (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CommonLib/ChunkLod.hpp>
+#include <CommonLib/BlockLibrary.hpp>
+#include <CommonLib/Chunk.hpp>
+#include <CommonLib/ChunkMesher.hpp>
+#include <CommonLib/ChunkSnapshot.hpp>
+#include <algorithm>
+#include <numeric>
+#include <optional>
+#include <utility>
+
+namespace tsom
+{
+	ChunkLod::ChunkLod(ChunkSnapshot snapshot, unsigned int lodFactor)
+	{
+		Reset(std::move(snapshot), lodFactor);
+	}
+
+	void ChunkLod::BuildMesh(const Chunk& chunk, const BlockLibrary& blockLibrary, const Nz::Vector3f& gravityCenter, const Nz::FunctionRef<void(const ChunkMeshFace& face)>& vertexSink) const
+	{
+		if (m_isEmpty)
+			return;
+
+		struct CellCorners
+		{
+			Nz::EnumArray<Nz::BoxCorner, Nz::Vector3f> corners;
+			Nz::Vector3f center;
+		};
+
+		auto ComputeCellCorners = [&](const Nz::Vector3ui& cellIndices)
+		{
+			// Corners of a cell are the matching corners of its outermost blocks
+			CellCorners cellCorners;
+
+			Nz::Vector3ui firstBlock = cellIndices * m_lodFactor;
+			for (auto&& [corner, position] : cellCorners.corners.iter_kv())
+				position = chunk.ComputeVoxelCorners(firstBlock + Chunk::s_cornerOffsets[corner] * (m_lodFactor - 1))[corner];
+
+			cellCorners.center = std::accumulate(cellCorners.corners.begin(), cellCorners.corners.end(), Nz::Vector3f::Zero()) / cellCorners.corners.size();
+			return cellCorners;
+		};
+
+		auto DrawFace = [&](const CellCorners& cellCorners, BlockIndex cellContent, Direction direction)
+		{
+			const auto& faceCorners = Chunk::s_faceCorners[direction];
+
+			ChunkMeshFace face;
+			for (std::size_t i = 0; i < face.positions.size(); ++i)
+				face.positions[i] = cellCorners.corners[faceCorners[i]];
+
+			Nz::Vector3f faceCenter = std::accumulate(face.positions.begin(), face.positions.end(), Nz::Vector3f::Zero()) / face.positions.size();
+			face.normal = Nz::Vector3f::Normalize(faceCenter - cellCorners.center);
+			face.direction = direction;
+
+			Direction upDirection = DirectionFromNormal(Nz::Vector3f::Normalize(faceCenter - gravityCenter));
+
+			ChunkMesherBase::FaceTexturing texturing = ChunkMesherBase::ComputeFaceTexturing(face.positions, face.normal, cellCorners.center, upDirection);
+
+			// Cell faces span lodFactor blocks, keep textures repeating once per block
+			for (std::size_t i = 0; i < face.uvs.size(); ++i)
+				face.uvs[i] = texturing.uvs[i] * float(m_lodFactor);
+
+			face.tangent = texturing.tangent;
+			face.textureIndex = blockLibrary.GetBlockData(cellContent).texIndices[texturing.texDirection];
+
+			vertexSink(face);
+		};
+
+		for (unsigned int z = 0; z < m_cellGridSize.z; ++z)
+		{
+			for (unsigned int y = 0; y < m_cellGridSize.y; ++y)
+			{
+				for (unsigned int x = 0; x < m_cellGridSize.x; ++x)
+				{
+					Nz::Vector3ui cellIndices(x, y, z);
+					BlockIndex cellContent = m_cells[GetCellLocalIndex(cellIndices)];
+					if (cellContent == EmptyBlockIndex)
+						continue;
+
+					std::optional<CellCorners> cellCorners;
+					for (auto&& [direction, offset] : s_blockDirOffsets.iter_kv())
+					{
+						if (!IsFaceVisible(cellIndices, direction))
+							continue;
+
+						if (!cellCorners)
+							cellCorners = ComputeCellCorners(cellIndices);
+
+						DrawFace(*cellCorners, cellContent, direction);
+
+						if (!IsBorderFace(cellIndices, direction))
+							continue;
+
+						// Neighbor chunk may be meshed at a finer level, with a surface up to a cell lower (as cells are solid as soon as one of their blocks is)
+						// hang the border face of the cell below each empty cell along the border, unless it's already visible
+						unsigned int axis = (offset.x != 0) ? 0 : (offset.y != 0) ? 1 : 2;
+						for (unsigned int skirtAxis : { (axis + 1) % 3, (axis + 2) % 3 })
+						{
+							for (int skirtOffset : { -1, 1 })
+							{
+								if (!IsCellEmpty(cellIndices, skirtAxis, skirtOffset))
+									continue;
+
+								Nz::Vector3i skirtCell(cellIndices);
+								skirtCell[skirtAxis] -= skirtOffset;
+								if (skirtCell[skirtAxis] < 0 || skirtCell[skirtAxis] >= static_cast<int>(m_cellGridSize[skirtAxis]))
+									continue;
+
+								Nz::Vector3ui skirtCellIndices(skirtCell);
+								BlockIndex skirtCellContent = m_cells[GetCellLocalIndex(skirtCellIndices)];
+								if (skirtCellContent == EmptyBlockIndex || IsFaceVisible(skirtCellIndices, direction))
+									continue;
+
+								DrawFace(ComputeCellCorners(skirtCellIndices), skirtCellContent, direction);
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+
+	void ChunkLod::Clear()
+	{
+		// Drop the snapshot so chunk content isn't kept alive, storage is kept so that reusing this ChunkLod doesn't allocate
+		m_snapshot = ChunkSnapshot{};
+		m_cellGridSize = Nz::Vector3ui(0, 0, 0);
+		m_cells.clear();
+		m_isEmpty = true;
+	}
+
+	void ChunkLod::Reset(ChunkSnapshot snapshot, unsigned int lodFactor)
+	{
+		m_snapshot = std::move(snapshot);
+		m_lodFactor = lodFactor;
+		m_isEmpty = true;
+
+		const Nz::Vector3ui& chunkSize = m_snapshot.GetSize();
+		assert(lodFactor > 0);
+		assert(chunkSize.x % lodFactor == 0 && chunkSize.y % lodFactor == 0 && chunkSize.z % lodFactor == 0);
+
+		m_cellGridSize = chunkSize / lodFactor;
+		m_cells.assign(m_cellGridSize.x * m_cellGridSize.y * m_cellGridSize.z, EmptyBlockIndex);
+
+		if (m_snapshot.IsEmpty())
+			return;
+
+		m_isEmpty = false;
+		if (m_snapshot.IsUniform())
+		{
+			std::fill(m_cells.begin(), m_cells.end(), m_snapshot.GetBlockContent(0));
+			return;
+		}
+
+		// Cells are mostly made of one or two block types, a linear search is enough to count them
+		for (unsigned int z = 0; z < m_cellGridSize.z; ++z)
+		{
+			for (unsigned int y = 0; y < m_cellGridSize.y; ++y)
+			{
+				for (unsigned int x = 0; x < m_cellGridSize.x; ++x)
+				{
+					Nz::Vector3ui firstBlock = Nz::Vector3ui(x, y, z) * lodFactor;
+
+					m_blockCounts.clear();
+					for (unsigned int blockZ = firstBlock.z; blockZ < firstBlock.z + lodFactor; ++blockZ)
+					{
+						for (unsigned int blockY = firstBlock.y; blockY < firstBlock.y + lodFactor; ++blockY)
+						{
+							for (unsigned int blockX = firstBlock.x; blockX < firstBlock.x + lodFactor; ++blockX)
+							{
+								BlockIndex blockIndex = m_snapshot.GetBlockContent({ blockX, blockY, blockZ });
+								if (blockIndex == EmptyBlockIndex)
+									continue;
+
+								auto it = std::find_if(m_blockCounts.begin(), m_blockCounts.end(), [&](const auto& blockCount) { return blockCount.first == blockIndex; });
+								if (it != m_blockCounts.end())
+									it->second++;
+								else
+									m_blockCounts.emplace_back(blockIndex, 1);
+							}
+						}
+					}
+
+					if (m_blockCounts.empty())
+						continue;
+
+					auto it = std::max_element(m_blockCounts.begin(), m_blockCounts.end(), [](const auto& lhs, const auto& rhs) { return lhs.second < rhs.second; });
+					m_cells[GetCellLocalIndex({ x, y, z })] = it->first;
+				}
+			}
+		}
+	}
+
+	bool ChunkLod::IsBorderFace(const Nz::Vector3ui& cellIndices, Direction direction) const
+	{
+		const Nz::Vector3i& offset = s_blockDirOffsets[direction];
+		unsigned int axis = (offset.x != 0) ? 0 : (offset.y != 0) ? 1 : 2;
+
+		int neighborCell = static_cast<int>(cellIndices[axis]) + offset[axis];
+		return neighborCell < 0 || neighborCell >= static_cast<int>(m_cellGridSize[axis]);
+	}
+
+	bool ChunkLod::IsCellEmpty(const Nz::Vector3ui& cellIndices, unsigned int axis, int offset) const
+	{
+		// Cells out of the chunk are considered solid
+		Nz::Vector3i neighborCell(cellIndices);
+		neighborCell[axis] += offset;
+		if (neighborCell[axis] < 0 || neighborCell[axis] >= static_cast<int>(m_cellGridSize[axis]))
+			return false;
+
+		return m_cells[GetCellLocalIndex(Nz::Vector3ui(neighborCell))] == EmptyBlockIndex;
+	}
+
+	bool ChunkLod::IsFaceVisible(const Nz::Vector3ui& cellIndices, Direction direction) const
+	{
+		const Nz::Vector3i& offset = s_blockDirOffsets[direction];
+		unsigned int axis = (offset.x != 0) ? 0 : (offset.y != 0) ? 1 : 2;
+		unsigned int uAxis = (axis + 1) % 3;
+		unsigned int vAxis = (axis + 2) % 3;
+
+		if (!IsBorderFace(cellIndices, direction))
+			return IsCellEmpty(cellIndices, axis, offset[axis]);
+
+		// Chunk border: neighbor chunk hides the face only if all of its blocks along the face are solid
+		Nz::Vector3ui firstBlock = cellIndices * m_lodFactor;
+		if (offset[axis] > 0)
+			firstBlock[axis] += m_lodFactor - 1;
+
+		for (unsigned int v = 0; v < m_lodFactor; ++v)
+		{
+			for (unsigned int u = 0; u < m_lodFactor; ++u)
+			{
+				Nz::Vector3ui blockIndices = firstBlock;
+				blockIndices[uAxis] += u;
+				blockIndices[vAxis] += v;
+
+				std::optional<BlockIndex> neighborBlock = m_snapshot.GetNeighborBlock(blockIndices, offset);
+				if (!neighborBlock || *neighborBlock == EmptyBlockIndex)
+					return true;
+			}
+		}
+
+		// Border faces of surface cells are kept, along with their skirt (see BuildMesh)
+		return IsCellEmpty(cellIndices, uAxis, -1) || IsCellEmpty(cellIndices, uAxis, 1) || IsCellEmpty(cellIndices, vAxis, -1) || IsCellEmpty(cellIndices, vAxis, 1);
+	}
+}
@@ -0,0 +1,184 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com) (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CommonLib/ChunkMeshCache.hpp>
+#include <CommonLib/ChunkMesher.hpp>
+#include <CommonLib/ChunkSnapshot.hpp>
+#include <CommonLib/FlatChunk.hpp>
+#include <cassert>
+
+namespace tsom
+{
+	bool ChunkMeshCache::Build(const BlockLibrary& blockLibrary, const Chunk& chunk, const ChunkSnapshot& snapshot, const Nz::Vector3f& gravityCenter, const ChunkMeshCache* previousCache, const std::atomic_bool* cancelled)
+	{
+		assert(previousCache != this);
+
+		const Nz::Vector3ui& brickGridSize = snapshot.GetBrickGridSize();
+
+		// Recycled caches are expected to build without growing any of their buffers
+		std::size_t brickCount = brickGridSize.x * brickGridSize.y * brickGridSize.z;
+		m_storageGrowthCount = (m_bricks.capacity() < brickCount) ? 1 : 0;
+
+		m_bricks.resize(brickCount);
+		if (previousCache && (previousCache->m_bricks.size() != m_bricks.size() || previousCache->m_greedyMeshing != m_greedyMeshing))
+			previousCache = nullptr;
+
+		// Resolve the chunk type once, so that bricks are meshed by a mesher specialized for it
+		if (const FlatChunk* flatChunk = dynamic_cast<const FlatChunk*>(&chunk))
+			return BuildBricks(blockLibrary, *flatChunk, snapshot, gravityCenter, previousCache, cancelled);
+		else
+			return BuildBricks(blockLibrary, chunk, snapshot, gravityCenter, previousCache, cancelled);
+	}
+
+	void ChunkMeshCache::Reset(bool greedyMeshing)
+	{
+		// Storage is kept, so that recycled caches don't allocate when building a mesh of the same size
+		for (std::vector<ChunkMeshVertex>& vertices : m_vertices)
+			vertices.clear();
+
+		m_bricks.clear();
+		m_directionBounds = ChunkDirectionBounds{};
+		m_greedyMeshing = greedyMeshing;
+		m_rebuiltBrickCount = 0;
+		m_storageGrowthCount = 0;
+	}
+
+	template<typename ChunkType>
+	bool ChunkMeshCache::BuildBricks(const BlockLibrary& blockLibrary, const ChunkType& chunk, const ChunkSnapshot& snapshot, const Nz::Vector3f& gravityCenter, const ChunkMeshCache* previousCache, const std::atomic_bool* cancelled)
+	{
+		const Nz::Vector3ui& brickGridSize = snapshot.GetBrickGridSize();
+
+		m_directionBounds = ChunkDirectionBounds{};
+		m_rebuiltBrickCount = 0;
+		for (std::vector<ChunkMeshVertex>& vertices : m_vertices)
+			vertices.clear();
+
+		auto IsBrickUpToDate = [&](unsigned int brickIndex)
+		{
+			if (!previousCache)
+				return false;
+
+			const Brick& brick = m_bricks[brickIndex];
+			const Brick& previousBrick = previousCache->m_bricks[brickIndex];
+			return previousBrick.version == brick.version && previousBrick.neighborVersions == brick.neighborVersions;
+		};
+
+		// First pass finds out which bricks changed (or whose direct neighbors changed) and how many vertices each direction will hold,
+		// faces are then written directly into exactly-sized storage (greedy meshing only merges faces so their count is an upper bound)
+		Nz::EnumArray<Direction, std::size_t> vertexCounts;
+		vertexCounts.fill(0);
+
+		for (unsigned int z = 0; z < brickGridSize.z; ++z)
+		{
+			for (unsigned int y = 0; y < brickGridSize.y; ++y)
+			{
+				for (unsigned int x = 0; x < brickGridSize.x; ++x)
+				{
+					// Chunk changed again while it was being meshed
+					if (cancelled && *cancelled)
+						return false;
+
+					Nz::Vector3ui brickIndices(x, y, z);
+					unsigned int brickIndex = snapshot.GetBrickLocalIndex(brickIndices);
+
+					Brick& brick = m_bricks[brickIndex];
+					brick.version = snapshot.GetBrickVersion(brickIndices);
+					for (auto&& [direction, neighborVersion] : brick.neighborVersions.iter_kv())
+						neighborVersion = snapshot.GetNeighborBrickVersion(brickIndices, direction);
+
+					if (IsBrickUpToDate(brickIndex))
+					{
+						for (auto&& [direction, vertexCount] : vertexCounts.iter_kv())
+							vertexCount += previousCache->m_bricks[brickIndex].vertexCount[direction];
+					}
+					else
+					{
+						Nz::Boxui brickBlocks = snapshot.GetBrickBlocks(brickIndices);
+						for (auto&& [direction, vertexCount] : vertexCounts.iter_kv())
+							vertexCount += ChunkMesherBase::CountVisibleFaces(snapshot, brickBlocks, direction) * 4;
+					}
+				}
+			}
+		}
+
+		for (auto&& [direction, vertices] : m_vertices.iter_kv())
+		{
+			if (vertices.capacity() < vertexCounts[direction])
+				m_storageGrowthCount++;
+
+			vertices.reserve(vertexCounts[direction]);
+		}
+
+		// Bricks are stored in brick order, so each brick range can be copied from the previous cache as a whole
+		for (unsigned int z = 0; z < brickGridSize.z; ++z)
+		{
+			for (unsigned int y = 0; y < brickGridSize.y; ++y)
+			{
+				for (unsigned int x = 0; x < brickGridSize.x; ++x)
+				{
+					if (cancelled && *cancelled)
+						return false;
+
+					Nz::Vector3ui brickIndices(x, y, z);
+					unsigned int brickIndex = snapshot.GetBrickLocalIndex(brickIndices);
+
+					Brick& brick = m_bricks[brickIndex];
+					if (IsBrickUpToDate(brickIndex))
+					{
+						const Brick& previousBrick = previousCache->m_bricks[brickIndex];
+						for (auto&& [direction, vertices] : m_vertices.iter_kv())
+						{
+							auto firstVertex = previousCache->m_vertices[direction].begin() + previousBrick.firstVertex[direction];
+
+							brick.firstVertex[direction] = Nz::SafeCast<Nz::UInt32>(vertices.size());
+							brick.vertexCount[direction] = previousBrick.vertexCount[direction];
+							vertices.insert(vertices.end(), firstVertex, firstVertex + previousBrick.vertexCount[direction]);
+						}
+
+						brick.directionBounds = previousBrick.directionBounds;
+					}
+					else
+					{
+						for (auto&& [direction, vertices] : m_vertices.iter_kv())
+							brick.firstVertex[direction] = Nz::SafeCast<Nz::UInt32>(vertices.size());
+
+						brick.directionBounds = ChunkDirectionBounds{};
+
+						auto AddFace = [&](const ChunkMeshFace& face)
+						{
+							std::vector<ChunkMeshVertex>& vertices = m_vertices[face.direction];
+							for (std::size_t i = 0; i < face.positions.size(); ++i)
+							{
+								ChunkMeshVertex& vertex = vertices.emplace_back();
+								vertex.position = face.positions[i];
+								vertex.normal = face.normal;
+								vertex.uvw = Nz::Vector3f(face.uvs[i], face.textureIndex);
+								vertex.tangent = face.tangent;
+							}
+
+							brick.directionBounds.AddFace(face.direction, face.positions, face.normal);
+						};
+
+						Nz::Boxui brickBlocks = snapshot.GetBrickBlocks(brickIndices);
+
+						ChunkMesher mesher(chunk, blockLibrary, AddFace);
+						if (m_greedyMeshing)
+							mesher.BuildGreedyMesh(snapshot, brickBlocks, gravityCenter);
+						else
+							mesher.BuildMesh(snapshot, brickBlocks, gravityCenter);
+
+						for (auto&& [direction, vertices] : m_vertices.iter_kv())
+							brick.vertexCount[direction] = Nz::SafeCast<Nz::UInt32>(vertices.size() - brick.firstVertex[direction]);
+
+						m_rebuiltBrickCount++;
+					}
+
+					m_directionBounds.Merge(brick.directionBounds);
+				}
+			}
+		}
+
+		return true;
+	}
+}
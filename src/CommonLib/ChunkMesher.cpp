@@ -0,0 +1,154 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com) (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CommonLib/ChunkMesher.hpp>
+#include <Nazara/Math/Quaternion.hpp>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+namespace tsom
+{
+	namespace
+	{
+		Nz::EnumArray<Direction, std::array<Nz::Vector3f, 4>> BuildAxisAlignedFaceCorners()
+		{
+			Nz::EnumArray<Nz::BoxCorner, Nz::Vector3f> corners = Nz::Boxf(0.f, 0.f, 0.f, 1.f, 1.f, 1.f).GetCorners();
+
+			Nz::EnumArray<Direction, std::array<Nz::Vector3f, 4>> faceCorners;
+			for (auto&& [direction, positions] : faceCorners.iter_kv())
+			{
+				for (std::size_t i = 0; i < positions.size(); ++i)
+					positions[i] = corners[Chunk::s_faceCorners[direction][i]];
+			}
+
+			return faceCorners;
+		}
+
+		Nz::EnumArray<Direction, Nz::EnumArray<Direction, ChunkMesherBase::FaceTexturing>> BuildAxisAlignedFaceTexturings(const Nz::EnumArray<Direction, std::array<Nz::Vector3f, 4>>& faceCorners)
+		{
+			// Texturing of an axis-aligned face depends neither on the block size nor on its position, compute it on a unit block
+			Nz::EnumArray<Direction, Nz::EnumArray<Direction, ChunkMesherBase::FaceTexturing>> faceTexturings;
+			for (auto&& [upDirection, upFaceTexturings] : faceTexturings.iter_kv())
+			{
+				for (auto&& [direction, faceTexturing] : upFaceTexturings.iter_kv())
+					faceTexturing = ChunkMesherBase::ComputeFaceTexturing(faceCorners[direction], s_dirNormals[direction], Nz::Vector3f(0.5f), upDirection);
+			}
+
+			return faceTexturings;
+		}
+	}
+
+	const Nz::EnumArray<Direction, std::array<Nz::Vector3f, 4>> ChunkMesherBase::s_axisAlignedFaceCorners = BuildAxisAlignedFaceCorners();
+	const Nz::EnumArray<Direction, Nz::EnumArray<Direction, ChunkMesherBase::FaceTexturing>> ChunkMesherBase::s_axisAlignedFaceTexturings = BuildAxisAlignedFaceTexturings(s_axisAlignedFaceCorners);
+
+	auto ChunkMesherBase::ComputeFaceTexturing(const std::array<Nz::Vector3f, 4>& positions, const Nz::Vector3f& normal, const Nz::Vector3f& blockCenter, Direction upDirection) -> FaceTexturing
+	{
+		FaceTexturing texturing;
+
+		// Make up the rotation from the face up to the regular up
+		Nz::Quaternionf upRotation = Nz::Quaternionf::RotationBetween(s_dirNormals[upDirection], Nz::Vector3f::Up());
+
+		// Compute texture direction based on face direction in regular orientation
+		texturing.texDirection = DirectionFromNormal(upRotation * normal);
+
+		// Compute UV
+		Nz::Vector2f minUV(std::numeric_limits<float>::infinity());
+		for (std::size_t i = 0; i < positions.size(); ++i)
+		{
+			// Get vector from center to corner (no need to normalize) and project it along the face normal to compute UV
+			// This is similar to the way a GPU compute UV when sampling a cubemap: https://www.gamedev.net/forums/topic/687535-implementing-a-cube-map-lookup-function/5337472/
+			Nz::Vector3f dir = upRotation * (positions[i] - blockCenter);
+			Nz::Vector3f dirAbs = dir.GetAbs();
+
+			float mag = 0.f;
+			Nz::Vector2f uv;
+			switch (texturing.texDirection) //< TODO: texture direction should be defined by dir to handle corners
+			{
+				case Direction::Back:
+				case Direction::Front:
+				{
+					mag = 0.5f / dirAbs.z;
+					uv = { dir.z < 0.f ? -dir.x : dir.x, -dir.y };
+					break;
+				}
+
+				case Direction::Down:
+				case Direction::Up:
+				{
+					mag = 0.5f / dirAbs.y;
+					uv = { dir.x, dir.y < 0.f ? -dir.z : dir.z };
+					break;
+				}
+
+				case Direction::Left:
+				case Direction::Right:
+				{
+					mag = 0.5f / dirAbs.x;
+					uv = { dir.x < 0.f ? dir.z : -dir.z, -dir.y };
+					break;
+				}
+			}
+
+			texturing.uvs[i] = uv * mag;
+			minUV.Minimize(texturing.uvs[i]);
+		}
+
+		// Merged faces span multiple blocks, make UV start on a texture border so the texture repeats once per block
+		Nz::Vector2f uvOffset(std::round(minUV.x * 2.f) * 0.5f, std::round(minUV.y * 2.f) * 0.5f);
+		for (Nz::Vector2f& uv : texturing.uvs)
+			uv -= uvOffset;
+
+		// Tangent follows U along the face, faces are planar so the first triangle is enough
+		Nz::Vector3f edge1 = positions[1] - positions[0];
+		Nz::Vector3f edge2 = positions[2] - positions[0];
+		Nz::Vector2f deltaUV1 = texturing.uvs[1] - texturing.uvs[0];
+		Nz::Vector2f deltaUV2 = texturing.uvs[2] - texturing.uvs[0];
+
+		float det = deltaUV1.x * deltaUV2.y - deltaUV2.x * deltaUV1.y;
+		texturing.tangent = Nz::Vector3f::Normalize((edge1 * deltaUV2.y - edge2 * deltaUV1.y) / det);
+
+		return texturing;
+	}
+
+	std::size_t ChunkMesherBase::CountVisibleFaces(const ChunkSnapshot& snapshot, const Nz::Boxui& blocks)
+	{
+		std::size_t faceCount = 0;
+		for (auto&& [direction, offset] : s_blockDirOffsets.iter_kv())
+			faceCount += CountVisibleFaces(snapshot, blocks, direction);
+
+		return faceCount;
+	}
+
+	std::size_t ChunkMesherBase::CountVisibleFaces(const ChunkSnapshot& snapshot, const Nz::Boxui& blocks, Direction direction)
+	{
+		if (snapshot.IsEmpty())
+			return 0;
+
+		Nz::Vector3ui firstBlock(blocks.x, blocks.y, blocks.z);
+		Nz::Vector3ui blockCount(blocks.width, blocks.height, blocks.depth);
+
+		// Same traversal as ForEachVisibleFace, counting faces of a whole column at once
+		const Nz::Vector3i& offset = s_blockDirOffsets[direction];
+		unsigned int axis = (offset.x != 0) ? 0 : (offset.y != 0) ? 1 : 2;
+		unsigned int uAxis = (axis + 1) % 3;
+		unsigned int vAxis = (axis + 2) % 3;
+
+		Nz::UInt32 rangeMask = ((blockCount[axis] >= 32) ? 0xFFFFFFFF : (Nz::UInt32(1) << blockCount[axis]) - 1) << firstBlock[axis];
+
+		std::size_t faceCount = 0;
+		Nz::Vector3ui blockIndices;
+		for (unsigned int v = firstBlock[vAxis]; v < firstBlock[vAxis] + blockCount[vAxis]; ++v)
+		{
+			blockIndices[vAxis] = v;
+			for (unsigned int u = firstBlock[uAxis]; u < firstBlock[uAxis] + blockCount[uAxis]; ++u)
+			{
+				blockIndices[uAxis] = u;
+				faceCount += std::popcount(snapshot.ComputeVisibleFaces(direction, blockIndices) & rangeMask);
+			}
+		}
+
+		return faceCount;
+	}
+}
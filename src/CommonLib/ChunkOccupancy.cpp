@@ -0,0 +1,211 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CommonLib/ChunkOccupancy.hpp>
+#include <CommonLib/BlockStorage.hpp>
+#include <algorithm>
+#include <bit>
+
+namespace tsom
+{
+	ChunkOccupancy::ChunkOccupancy(const Nz::Vector3ui& size) :
+	m_size(size),
+	m_uniformValue(false)
+	{
+		assert(size.x <= MaxSize && size.y <= MaxSize && size.z <= MaxSize);
+	}
+
+	// Splits occupied blocks into boxes, greedily grown along X, then Y, then Z
+	void ChunkOccupancy::ComputeBoxes(const Nz::FunctionRef<void(const Nz::Boxui& blocks)>& callback) const
+	{
+		ComputeBoxes(Nz::Boxui(Nz::Vector3ui::Zero(), m_size), *this, callback);
+	}
+
+	// Same as above for occupied blocks of a region, boxes may also cover blocks of mergeableOccupancy (which should contain occupied blocks) to get bigger and fewer boxes
+	void ChunkOccupancy::ComputeBoxes(const Nz::Boxui& blocks, const ChunkOccupancy& mergeableOccupancy, const Nz::FunctionRef<void(const Nz::Boxui& blocks)>& callback) const
+	{
+		assert(mergeableOccupancy.GetSize() == m_size);
+		assert(blocks.x + blocks.width <= m_size.x && blocks.y + blocks.height <= m_size.y && blocks.z + blocks.depth <= m_size.z);
+
+		if (blocks.width == 0 || blocks.height == 0 || blocks.depth == 0)
+			return;
+
+		if (IsUniform())
+		{
+			if (m_uniformValue)
+				callback(blocks);
+
+			return;
+		}
+
+		Nz::UInt32 regionMask = ((blocks.width >= 32) ? 0xFFFFFFFF : (Nz::UInt32(1) << blocks.width) - 1) << blocks.x;
+
+		// X columns of the region are rows of blocks, indexed by (z - blocks.z) * blocks.height + (y - blocks.y)
+		std::vector<Nz::UInt32> rows(std::size_t(blocks.height) * blocks.depth);
+		std::vector<Nz::UInt32> mergeableRows(rows.size());
+		for (unsigned int z = 0; z < blocks.depth; ++z)
+		{
+			for (unsigned int y = 0; y < blocks.height; ++y)
+			{
+				Nz::Vector3ui rowIndices(0, blocks.y + y, blocks.z + z);
+
+				std::size_t rowIndex = std::size_t(z) * blocks.height + y;
+				rows[rowIndex] = GetColumn(0, rowIndices) & regionMask;
+				mergeableRows[rowIndex] = (mergeableOccupancy.GetColumn(0, rowIndices) & regionMask) | rows[rowIndex];
+			}
+		}
+
+		auto ContainsRow = [&](unsigned int y, unsigned int z, Nz::UInt32 rowMask)
+		{
+			return (mergeableRows[std::size_t(z) * blocks.height + y] & rowMask) == rowMask;
+		};
+
+		for (unsigned int z = 0; z < blocks.depth; ++z)
+		{
+			for (unsigned int y = 0; y < blocks.height; ++y)
+			{
+				std::size_t rowIndex = std::size_t(z) * blocks.height + y;
+
+				Nz::UInt32& row = rows[rowIndex];
+				while (row != 0)
+				{
+					unsigned int startX = std::countr_zero(row);
+					unsigned int width = std::countr_one(mergeableRows[rowIndex] >> startX);
+					Nz::UInt32 rowMask = (width >= 32) ? 0xFFFFFFFF : ((Nz::UInt32(1) << width) - 1) << startX;
+
+					unsigned int endY = y + 1;
+					while (endY < blocks.height && ContainsRow(endY, z, rowMask))
+						endY++;
+
+					unsigned int endZ = z + 1;
+					for (; endZ < blocks.depth; ++endZ)
+					{
+						bool isLayerFull = true;
+						for (unsigned int layerY = y; layerY < endY; ++layerY)
+						{
+							if (!ContainsRow(layerY, endZ, rowMask))
+							{
+								isLayerFull = false;
+								break;
+							}
+						}
+
+						if (!isLayerFull)
+							break;
+					}
+
+					// Boxes never overlap
+					for (unsigned int boxZ = z; boxZ < endZ; ++boxZ)
+					{
+						for (unsigned int boxY = y; boxY < endY; ++boxY)
+						{
+							std::size_t boxRowIndex = std::size_t(boxZ) * blocks.height + boxY;
+							rows[boxRowIndex] &= ~rowMask;
+							mergeableRows[boxRowIndex] &= ~rowMask;
+						}
+					}
+
+					callback(Nz::Boxui(startX, blocks.y + y, blocks.z + z, width, endY - y, endZ - z));
+				}
+			}
+		}
+	}
+
+	void ChunkOccupancy::Reset(const BlockStorage& blocks)
+	{
+		assert(blocks.GetBlockCount() == m_size.x * m_size.y * m_size.z);
+
+		if (blocks.IsUniform())
+		{
+			for (auto& columns : m_columns)
+				columns = {};
+
+			m_uniformValue = (blocks.GetBlock(0) != EmptyBlockIndex);
+			return;
+		}
+
+		for (unsigned int axis = 0; axis < 3; ++axis)
+			m_columns[axis].assign(std::size_t(m_size[(axis + 1) % 3]) * m_size[(axis + 2) % 3], 0);
+
+		std::size_t blockIndex = 0;
+		for (unsigned int z = 0; z < m_size.z; ++z)
+		{
+			for (unsigned int y = 0; y < m_size.y; ++y)
+			{
+				Nz::UInt32 xColumn = 0;
+				for (unsigned int x = 0; x < m_size.x; ++x)
+				{
+					if (blocks.GetBlock(blockIndex++) == EmptyBlockIndex)
+						continue;
+
+					xColumn |= Nz::UInt32(1) << x;
+					m_columns[1][std::size_t(x) * m_size.z + z] |= Nz::UInt32(1) << y;
+					m_columns[2][std::size_t(y) * m_size.x + x] |= Nz::UInt32(1) << z;
+				}
+
+				m_columns[0][std::size_t(z) * m_size.y + y] = xColumn;
+			}
+		}
+	}
+
+	// Rebuilds occupancy from X columns only (indexed by z * size.y + y)
+	void ChunkOccupancy::Reset(std::span<const Nz::UInt32> xColumns)
+	{
+		assert(xColumns.size() == std::size_t(m_size.y) * m_size.z);
+
+		Nz::UInt32 xMask = GetColumnMask(0);
+		bool isEmpty = std::all_of(xColumns.begin(), xColumns.end(), [](Nz::UInt32 column) { return column == 0; });
+		bool isFull = std::all_of(xColumns.begin(), xColumns.end(), [&](Nz::UInt32 column) { return column == xMask; });
+		if (isEmpty || isFull)
+		{
+			for (auto& columns : m_columns)
+				columns = {};
+
+			m_uniformValue = isFull;
+			return;
+		}
+
+		m_columns[0].assign(xColumns.begin(), xColumns.end());
+		for (unsigned int axis = 1; axis < 3; ++axis)
+			m_columns[axis].assign(std::size_t(m_size[(axis + 1) % 3]) * m_size[(axis + 2) % 3], 0);
+
+		for (unsigned int z = 0; z < m_size.z; ++z)
+		{
+			for (unsigned int y = 0; y < m_size.y; ++y)
+			{
+				Nz::UInt32 xColumn = xColumns[std::size_t(z) * m_size.y + y];
+				while (xColumn != 0)
+				{
+					unsigned int x = std::countr_zero(xColumn);
+					xColumn &= xColumn - 1;
+
+					m_columns[1][std::size_t(x) * m_size.z + z] |= Nz::UInt32(1) << y;
+					m_columns[2][std::size_t(y) * m_size.x + x] |= Nz::UInt32(1) << z;
+				}
+			}
+		}
+	}
+
+	void ChunkOccupancy::Set(const Nz::Vector3ui& blockIndices, bool isOccupied)
+	{
+		if (IsUniform())
+		{
+			if (isOccupied == m_uniformValue)
+				return;
+
+			for (unsigned int axis = 0; axis < 3; ++axis)
+				m_columns[axis].assign(std::size_t(m_size[(axis + 1) % 3]) * m_size[(axis + 2) % 3], (m_uniformValue) ? GetColumnMask(axis) : 0);
+		}
+
+		for (unsigned int axis = 0; axis < 3; ++axis)
+		{
+			Nz::UInt32& column = m_columns[axis][GetColumnIndex(axis, blockIndices)];
+			Nz::UInt32 bit = Nz::UInt32(1) << blockIndices[axis];
+			if (isOccupied)
+				column |= bit;
+			else
+				column &= ~bit;
+		}
+	}
+}
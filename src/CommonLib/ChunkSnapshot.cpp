@@ -0,0 +1,295 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CommonLib/ChunkSnapshot.hpp>
+#include <CommonLib/Chunk.hpp>
+#include <CommonLib/Utility/ContentHasher.hpp>
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <iterator>
+
+namespace tsom
+{
+	// Meshes and colliders only depend on neighbors through the occupancy of their blocks touching the chunk
+	Nz::UInt64 ChunkSnapshot::ComputeNeighborBorderHash() const
+	{
+		ContentHasher hasher;
+		for (auto&& [direction, neighborContent] : m_neighborContents.iter_kv())
+		{
+			// Missing neighbors and empty borders don't hide faces the same way
+			if (!neighborContent)
+			{
+				hasher.Append(0);
+				continue;
+			}
+
+			hasher.Append(1);
+
+			const Nz::Vector3i& offset = s_blockDirOffsets[direction];
+			unsigned int axis = (offset.x != 0) ? 0 : (offset.y != 0) ? 1 : 2;
+			unsigned int uAxis = (axis + 1) % 3;
+			unsigned int vAxis = (axis + 2) % 3;
+
+			// Neighbor layer touching this chunk
+			const ChunkOccupancy& neighborOccupancy = neighborContent->occupancy;
+			unsigned int layer = (offset[axis] > 0) ? 0 : neighborOccupancy.GetSize()[axis] - 1;
+
+			Nz::UInt64 bits = 0;
+			unsigned int bitCount = 0;
+
+			Nz::Vector3ui blockIndices(0);
+			for (unsigned int v = 0; v < neighborOccupancy.GetSize()[vAxis]; ++v)
+			{
+				blockIndices[vAxis] = v;
+				for (unsigned int u = 0; u < neighborOccupancy.GetSize()[uAxis]; ++u)
+				{
+					blockIndices[uAxis] = u;
+
+					bits = (bits << 1) | ((neighborOccupancy.GetColumn(axis, blockIndices) >> layer) & 1);
+					if (++bitCount == 64)
+					{
+						hasher.Append(bits);
+						bits = 0;
+						bitCount = 0;
+					}
+				}
+			}
+
+			if (bitCount > 0)
+				hasher.Append(bits);
+		}
+
+		return hasher.GetHash();
+	}
+
+	// Returns the occupancy of blocks (in a region) having at least one visible face, along with the solid blocks up to shellThickness - 1 blocks under them
+	ChunkOccupancy ChunkSnapshot::ComputeSurfaceOccupancy(const Nz::Boxui& blocks, unsigned int shellThickness) const
+	{
+		assert(shellThickness > 0);
+		assert(blocks.x + blocks.width <= m_size.x && blocks.y + blocks.height <= m_size.y && blocks.z + blocks.depth <= m_size.z);
+
+		const ChunkOccupancy& occupancy = m_content->occupancy;
+
+		ChunkOccupancy surfaceOccupancy(m_size);
+		if (IsEmpty() || blocks.width == 0 || blocks.height == 0 || blocks.depth == 0)
+			return surfaceOccupancy;
+
+		// Shell blocks can come from exposed blocks up to shellThickness - 1 blocks away from the region
+		Nz::Vector3ui first(blocks.x, blocks.y, blocks.z);
+		Nz::Vector3ui last = first + Nz::Vector3ui(blocks.width, blocks.height, blocks.depth) - Nz::Vector3ui(1);
+		for (unsigned int axis = 0; axis < 3; ++axis)
+		{
+			first[axis] -= std::min(first[axis], shellThickness - 1);
+			last[axis] = std::min(last[axis] + shellThickness - 1, m_size[axis] - 1);
+		}
+
+		auto RangeMask = [](unsigned int first, unsigned int last)
+		{
+			return ((last >= 31) ? 0xFFFFFFFF : (Nz::UInt32(1) << (last + 1)) - 1) & ~((Nz::UInt32(1) << first) - 1);
+		};
+
+		Nz::Vector3ui32 extendedMasks(RangeMask(first.x, last.x), RangeMask(first.y, last.y), RangeMask(first.z, last.z));
+
+		// Work on X columns (rows), indexed by z * size.y + y
+		std::size_t rowCount = std::size_t(m_size.y) * m_size.z;
+		std::vector<Nz::UInt32> solidRows(rowCount, 0);
+		std::vector<Nz::UInt32> surfaceRows(rowCount, 0);
+		for (unsigned int z = first.z; z <= last.z; ++z)
+		{
+			for (unsigned int y = first.y; y <= last.y; ++y)
+			{
+				std::size_t rowIndex = std::size_t(z) * m_size.y + y;
+				solidRows[rowIndex] = occupancy.GetColumn(0, { 0, y, z }) & extendedMasks.x;
+				surfaceRows[rowIndex] = (ComputeVisibleFaces(Direction::Left, { 0, y, z }) | ComputeVisibleFaces(Direction::Right, { 0, y, z })) & extendedMasks.x;
+			}
+		}
+
+		auto ScatterFaces = [&](Nz::UInt32 faces, auto&& GetRowIndex, unsigned int x)
+		{
+			while (faces != 0)
+			{
+				unsigned int coord = std::countr_zero(faces);
+				faces &= faces - 1;
+
+				surfaceRows[GetRowIndex(coord)] |= Nz::UInt32(1) << x;
+			}
+		};
+
+		for (unsigned int x = first.x; x <= last.x; ++x)
+		{
+			for (unsigned int z = first.z; z <= last.z; ++z)
+			{
+				Nz::UInt32 faces = ComputeVisibleFaces(Direction::Back, { x, 0, z }) | ComputeVisibleFaces(Direction::Front, { x, 0, z });
+				ScatterFaces(faces & extendedMasks.y, [&](unsigned int y) { return std::size_t(z) * m_size.y + y; }, x);
+			}
+
+			for (unsigned int y = first.y; y <= last.y; ++y)
+			{
+				Nz::UInt32 faces = ComputeVisibleFaces(Direction::Down, { x, y, 0 }) | ComputeVisibleFaces(Direction::Up, { x, y, 0 });
+				ScatterFaces(faces & extendedMasks.z, [&](unsigned int z) { return std::size_t(z) * m_size.y + y; }, x);
+			}
+		}
+
+		// Grow the shell inwards, one layer of solid blocks at a time
+		std::vector<Nz::UInt32> grownRows(rowCount, 0);
+		for (unsigned int layer = 1; layer < shellThickness; ++layer)
+		{
+			for (unsigned int z = first.z; z <= last.z; ++z)
+			{
+				for (unsigned int y = first.y; y <= last.y; ++y)
+				{
+					std::size_t rowIndex = std::size_t(z) * m_size.y + y;
+
+					Nz::UInt32 row = surfaceRows[rowIndex];
+					Nz::UInt32 neighbors = (row << 1) | (row >> 1);
+					if (y > 0)
+						neighbors |= surfaceRows[rowIndex - 1];
+
+					if (y + 1 < m_size.y)
+						neighbors |= surfaceRows[rowIndex + 1];
+
+					if (z > 0)
+						neighbors |= surfaceRows[rowIndex - m_size.y];
+
+					if (z + 1 < m_size.z)
+						neighbors |= surfaceRows[rowIndex + m_size.y];
+
+					grownRows[rowIndex] = row | (neighbors & solidRows[rowIndex]);
+				}
+			}
+
+			std::swap(surfaceRows, grownRows);
+		}
+
+		// Only keep the requested region
+		Nz::UInt32 regionMask = RangeMask(blocks.x, blocks.x + blocks.width - 1);
+		for (unsigned int z = 0; z < m_size.z; ++z)
+		{
+			for (unsigned int y = 0; y < m_size.y; ++y)
+			{
+				Nz::UInt32& row = surfaceRows[std::size_t(z) * m_size.y + y];
+				if (y < blocks.y || y >= blocks.y + blocks.height || z < blocks.z || z >= blocks.z + blocks.depth)
+					row = 0;
+				else
+					row &= regionMask;
+			}
+		}
+
+		surfaceOccupancy.Reset(surfaceRows);
+		return surfaceOccupancy;
+	}
+
+	// Returns the latest version of the bricks up to brickRadius bricks away (diagonals included), 0 if none of them exist
+	Nz::UInt64 ChunkSnapshot::ComputeSurroundingBrickVersion(const Nz::Vector3ui& brickIndices, unsigned int brickRadius) const
+	{
+		int radius = static_cast<int>(brickRadius);
+
+		Nz::UInt64 version = 0;
+		for (int z = -radius; z <= radius; ++z)
+		{
+			for (int y = -radius; y <= radius; ++y)
+			{
+				for (int x = -radius; x <= radius; ++x)
+				{
+					if (x == 0 && y == 0 && z == 0)
+						continue;
+
+					version = std::max(version, FindBrickVersion(Nz::Vector3i(brickIndices) + Nz::Vector3i(x, y, z)));
+				}
+			}
+		}
+
+		return version;
+	}
+
+	// Returns the blocks of a column whose face in the given direction is visible
+	Nz::UInt32 ChunkSnapshot::ComputeVisibleFaces(Direction direction, const Nz::Vector3ui& blockIndices) const
+	{
+		const Nz::Vector3i& offset = s_blockDirOffsets[direction];
+		unsigned int axis = (offset.x != 0) ? 0 : (offset.y != 0) ? 1 : 2;
+
+		Nz::UInt32 column = m_content->occupancy.GetColumn(axis, blockIndices);
+		if (column == 0)
+			return 0;
+
+		// Border blocks are hidden by the neighbor chunk blocks, if there's one
+		unsigned int lastBit = m_size[axis] - 1;
+		Nz::UInt32 neighborBit = 0;
+		if (const ChunkContent* neighborContent = m_neighborContents[direction].get(); neighborContent && neighborContent->occupancy.GetSize() == m_size)
+		{
+			Nz::UInt32 neighborColumn = neighborContent->occupancy.GetColumn(axis, blockIndices);
+			if (offset[axis] > 0)
+				neighborBit = (neighborColumn & 1) << lastBit;
+			else
+				neighborBit = (neighborColumn >> lastBit) & 1;
+		}
+
+		Nz::UInt32 occluders = (offset[axis] > 0) ? (column >> 1) : (column << 1);
+		return column & ~(occluders | neighborBit);
+	}
+
+	Nz::UInt64 ChunkSnapshot::GetNeighborBrickVersion(const Nz::Vector3ui& brickIndices, Direction direction) const
+	{
+		return FindBrickVersion(Nz::Vector3i(brickIndices) + s_blockDirOffsets[direction]);
+	}
+
+	bool ChunkSnapshot::IsUpToDate(const Chunk& chunk) const
+	{
+		// Content versions are unique across all chunks, comparing them is enough to know if anything changed
+		if (!m_content || m_content->version != chunk.GetContentVersion())
+			return false;
+
+		for (auto&& [direction, neighborContent] : m_neighborContents.iter_kv())
+		{
+			const Chunk* neighbor = chunk.GetNeighborChunk(direction);
+			if (!neighbor)
+			{
+				if (neighborContent)
+					return false;
+
+				continue;
+			}
+
+			if (!neighborContent || neighborContent->version != neighbor->GetContentVersion())
+				return false;
+		}
+
+		return true;
+	}
+
+	// Bricks out of the chunk along a single axis are looked up in the neighbor chunk of that side (0 means no neighbor)
+	// only face neighbors are known, so bricks out of the chunk along two or three axes are reported as missing
+	Nz::UInt64 ChunkSnapshot::FindBrickVersion(const Nz::Vector3i& brickIndices) const
+	{
+		const Nz::Vector3ui& brickGridSize = m_content->brickGridSize;
+
+		const ChunkContent* content = m_content.get();
+		Nz::Vector3i wrappedIndices = brickIndices;
+		for (unsigned int axis = 0; axis < 3; ++axis)
+		{
+			int gridSize = static_cast<int>(brickGridSize[axis]);
+			if (brickIndices[axis] >= 0 && brickIndices[axis] < gridSize)
+				continue;
+
+			// Only one step into a single neighbor
+			if (content != m_content.get() || brickIndices[axis] < -gridSize || brickIndices[axis] >= gridSize * 2)
+				return 0;
+
+			Nz::Vector3i offset = Nz::Vector3i::Zero();
+			offset[axis] = (brickIndices[axis] < 0) ? -1 : 1;
+
+			auto directionIt = std::find(s_blockDirOffsets.begin(), s_blockDirOffsets.end(), offset);
+			assert(directionIt != s_blockDirOffsets.end());
+
+			content = m_neighborContents[static_cast<Direction>(std::distance(s_blockDirOffsets.begin(), directionIt))].get();
+			if (!content || content->brickGridSize != brickGridSize)
+				return 0;
+
+			wrappedIndices[axis] = (brickIndices[axis] + gridSize) % gridSize;
+		}
+
+		return content->brickVersions[brickGridSize.x * (brickGridSize.y * wrappedIndices.z + wrappedIndices.y) + wrappedIndices.x];
+	}
+}
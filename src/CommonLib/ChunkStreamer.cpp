@@ -0,0 +1,152 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com) (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CommonLib/ChunkStreamer.hpp>
+#include <CommonLib/FlatChunk.hpp>
+#include <CommonLib/Planet.hpp>
+#include <Nazara/Core/TaskScheduler.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace tsom
+{
+	ChunkStreamer::ChunkStreamer(Planet& planet, const BlockLibrary& blockLibrary, Nz::TaskScheduler& taskScheduler, Nz::UInt32 seed, const Nz::Vector3ui& chunkCount) :
+	m_state(std::make_shared<StreamingState>()),
+	m_taskScheduler(taskScheduler),
+	m_seed(seed),
+	m_chunkCount(chunkCount),
+	m_blockLibrary(blockLibrary),
+	m_planet(planet)
+	{
+	}
+
+	ChunkStreamer::~ChunkStreamer()
+	{
+		// Tasks which didn't start yet are skipped, running tasks still reference the planet and have to finish
+		m_state->cancelled = true;
+		WaitForRunningChunks();
+	}
+
+	// Generates the chunks right away (using worker threads), for chunks which have to exist before any viewer comes close
+	void ChunkStreamer::GenerateChunks(std::span<const ChunkIndices> chunkIndices)
+	{
+		for (const ChunkIndices& indices : chunkIndices)
+		{
+			if (!IsInsidePlanet(indices) || m_requestedChunks.contains(indices) || m_planet.GetChunk(indices))
+				continue;
+
+			StartChunk(indices);
+		}
+
+		WaitForRunningChunks();
+		PublishChunks();
+	}
+
+	bool ChunkStreamer::IsInViewRadius(const ChunkIndices& chunkIndices, const Nz::Vector3f& viewerPosition, float margin) const
+	{
+		float radius = m_settings.viewRadius + margin;
+		return m_planet.GetChunkOffset(chunkIndices).SquaredDistance(viewerPosition) <= radius * radius;
+	}
+
+	void ChunkStreamer::Update(std::span<const Nz::Vector3f> viewerPositions)
+	{
+		PublishChunks();
+
+		unsigned int runningChunkCount = m_state->runningChunkCount;
+		if (viewerPositions.empty() || runningChunkCount >= m_settings.maxRunningChunks)
+			return;
+
+		unsigned int freeChunkCount = std::min(m_settings.maxStartedChunks, m_settings.maxRunningChunks - runningChunkCount);
+
+		float chunkSize = Planet::ChunkSize * m_planet.GetTileSize();
+		int chunkRadius = int(std::ceil(m_settings.viewRadius / chunkSize));
+
+		m_candidates.clear();
+		for (const Nz::Vector3f& viewerPosition : viewerPositions)
+		{
+			ChunkIndices viewerChunkIndices = m_planet.GetChunkIndicesByPosition(viewerPosition);
+			for (int z = -chunkRadius; z <= chunkRadius; ++z)
+			{
+				for (int y = -chunkRadius; y <= chunkRadius; ++y)
+				{
+					for (int x = -chunkRadius; x <= chunkRadius; ++x)
+					{
+						ChunkIndices chunkIndices = viewerChunkIndices + ChunkIndices(x, y, z);
+						if (!IsInsidePlanet(chunkIndices) || m_requestedChunks.contains(chunkIndices) || m_planet.GetChunk(chunkIndices))
+							continue;
+
+						if (!IsInViewRadius(chunkIndices, viewerPosition))
+							continue;
+
+						m_candidates.emplace_back(m_planet.GetChunkOffset(chunkIndices).SquaredDistance(viewerPosition), chunkIndices);
+					}
+				}
+			}
+		}
+
+		// Chunks seen by multiple viewers appear multiple times, the closest occurrence comes first
+		std::sort(m_candidates.begin(), m_candidates.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
+		for (auto it = m_candidates.begin(); it != m_candidates.end() && freeChunkCount > 0; ++it)
+		{
+			if (m_requestedChunks.contains(it->second))
+				continue;
+
+			StartChunk(it->second);
+			freeChunkCount--;
+		}
+	}
+
+	void ChunkStreamer::PublishChunks()
+	{
+		{
+			std::scoped_lock lock(m_state->finishedChunkMutex);
+			std::swap(m_publishQueue, m_state->finishedChunks);
+		}
+
+		for (std::unique_ptr<Chunk>& generatedChunk : m_publishQueue)
+		{
+			ChunkIndices chunkIndices = generatedChunk->GetIndices();
+
+			m_requestedChunks.erase(chunkIndices);
+
+			// Chunk may have been added by someone else in the meantime
+			if (!m_planet.GetChunk(chunkIndices))
+				m_planet.AddChunk(std::move(generatedChunk));
+		}
+		m_publishQueue.clear();
+	}
+
+	void ChunkStreamer::StartChunk(const ChunkIndices& chunkIndices)
+	{
+		m_requestedChunks.insert(chunkIndices);
+		m_state->runningChunkCount++;
+
+		// The chunk is generated on its own, the planet only learns about it once it's published
+		m_taskScheduler.AddTask([this, state = m_state, chunkIndices]
+		{
+			if (!state->cancelled)
+			{
+				std::unique_ptr<Chunk> chunk = std::make_unique<FlatChunk>(m_planet, chunkIndices, Nz::Vector3ui{ Planet::ChunkSize }, m_planet.GetTileSize());
+
+				// Saved chunks don't need to be generated
+				if (!m_loadCallback || !m_loadCallback(*chunk))
+					m_planet.GenerateChunk(m_blockLibrary, *chunk, m_seed, m_chunkCount);
+
+				std::scoped_lock lock(state->finishedChunkMutex);
+				state->finishedChunks.push_back(std::move(chunk));
+			}
+
+			state->runningChunkCount--;
+			state->runningChunkCount.notify_all();
+		});
+	}
+
+	void ChunkStreamer::WaitForRunningChunks()
+	{
+		unsigned int runningChunkCount;
+		while ((runningChunkCount = m_state->runningChunkCount) != 0)
+			m_state->runningChunkCount.wait(runningChunkCount);
+	}
+}
@@ -0,0 +1,59 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com) (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CommonLib/ChunkVisibility.hpp>
+
+namespace tsom
+{
+	// Chunks outside of chunkBounds are never visited, connectivityCallback returns null for chunks without connectivity (not generated or not meshed yet) which are considered fully connected
+	void ChunkVisibility::Compute(const ChunkIndices& viewerChunk, const Nz::Boxi& chunkBounds, const Nz::FunctionRef<const ChunkConnectivity*(const ChunkIndices& chunkIndices)>& connectivityCallback)
+	{
+		m_pendingChunks.clear();
+		m_visitedChunks.clear();
+
+		auto IsInBounds = [&](const ChunkIndices& chunkIndices)
+		{
+			return chunkIndices.x >= chunkBounds.x && chunkIndices.x < chunkBounds.x + chunkBounds.width &&
+			       chunkIndices.y >= chunkBounds.y && chunkIndices.y < chunkBounds.y + chunkBounds.height &&
+			       chunkIndices.z >= chunkBounds.z && chunkIndices.z < chunkBounds.z + chunkBounds.depth;
+		};
+
+		// The viewer may be anywhere in its chunk, sight can leave it through any face
+		m_visitedChunks.emplace(viewerChunk, 0);
+		m_pendingChunks.push_back({ viewerChunk, Direction::Back, 0, true });
+
+		// Breadth-first so chunks are first reached through the most direct path, a chunk is crossed at most once per entry face
+		for (std::size_t pendingIndex = 0; pendingIndex < m_pendingChunks.size(); ++pendingIndex)
+		{
+			PendingChunk pendingChunk = m_pendingChunks[pendingIndex];
+			const ChunkConnectivity* connectivity = (!pendingChunk.isViewerChunk) ? connectivityCallback(pendingChunk.indices) : nullptr;
+
+			for (auto&& [direction, normal] : s_dirNormals.iter_kv())
+			{
+				// Don't go back toward the viewer, which would let sight go around occluders
+				if (pendingChunk.directions & (1u << static_cast<unsigned int>(OppositeDirection(direction))))
+					continue;
+
+				if (connectivity && !connectivity->AreConnected(pendingChunk.entryFace, direction))
+					continue;
+
+				ChunkIndices neighborIndices = pendingChunk.indices + ChunkIndices(normal);
+				if (!IsInBounds(neighborIndices))
+					continue;
+
+				Direction entryFace = OppositeDirection(direction);
+				Nz::UInt8 entryFaceBit = Nz::UInt8(1u << static_cast<unsigned int>(entryFace));
+
+				Nz::UInt8& visitedFaces = m_visitedChunks[neighborIndices];
+				if (visitedFaces & entryFaceBit)
+					continue;
+
+				visitedFaces |= entryFaceBit;
+
+				Nz::UInt8 directions = Nz::UInt8(pendingChunk.directions | (1u << static_cast<unsigned int>(direction)));
+				m_pendingChunks.push_back({ neighborIndices, entryFace, directions, false });
+			}
+		}
+	}
+}
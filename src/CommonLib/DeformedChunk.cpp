@@ -3,32 +3,61 @@
 // For conditions of distribution and use, see copyright notice in LICENSE
 
 #include <CommonLib/DeformedChunk.hpp>
+#include <CommonLib/ChunkMesher.hpp>
+#include <CommonLib/Utility/ContentHasher.hpp>
 #include <CommonLib/Utility/SignedDistanceFunctions.hpp>
 #include <Nazara/Core/VertexStruct.hpp>
 #include <Nazara/Math/Ray.hpp>
 #include <Nazara/Physics3D/Collider3D.hpp>
 #include <fmt/format.h>
 #include <fmt/std.h>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
 
 namespace tsom
 {
-	std::shared_ptr<Nz::Collider3D> DeformedChunk::BuildCollider(const BlockLibrary& blockManager) const
+	std::shared_ptr<Nz::Collider3D> DeformedChunk::BuildCollider(const BlockLibrary& /*blockManager*/, const ChunkSnapshot& snapshot, const Nz::Boxui& blocks, const ColliderSettings& /*settings*/) const
 	{
+		constexpr Nz::UInt32 InvalidVertex = std::numeric_limits<Nz::UInt32>::max();
+
+		// Neighbor faces share their corners, which are the same lattice position, weld them by remapping lattice indices to collider vertices
+		// (remap buffer is reused by each worker thread across calls and reset after use)
+		thread_local std::vector<Nz::UInt32> vertexRemap;
+		if (vertexRemap.size() < m_lattice.size())
+			vertexRemap.resize(m_lattice.size(), InvalidVertex);
+
+		// The mesh collider is made of visible faces only, it is always surface-only
 		std::vector<Nz::UInt32> indices;
 		std::vector<Nz::Vector3f> positions;
+		std::vector<std::size_t> latticeIndices;
 
-		auto AddVertices = [&](Nz::UInt32 count)
+		ChunkMesherBase::ForEachVisibleFace(snapshot, blocks, [&](Direction direction, const Nz::Vector3ui& blockIndices)
 		{
-			VertexAttributes vertexAttributes;
-
-			vertexAttributes.firstIndex = Nz::SafeCast<Nz::UInt32>(positions.size());
-			positions.resize(positions.size() + count);
-			vertexAttributes.position = Nz::SparsePtr<Nz::Vector3f>(&positions[vertexAttributes.firstIndex]);
+			std::array<Nz::UInt32, 4> faceVertices;
+			for (std::size_t i = 0; i < faceVertices.size(); ++i)
+			{
+				std::size_t latticeIndex = GetLatticeIndex(blockIndices + s_cornerOffsets[s_faceCorners[direction][i]]);
+
+				Nz::UInt32& vertexIndex = vertexRemap[latticeIndex];
+				if (vertexIndex == InvalidVertex)
+				{
+					vertexIndex = Nz::SafeCast<Nz::UInt32>(positions.size());
+					positions.push_back(m_lattice[latticeIndex]);
+					latticeIndices.push_back(latticeIndex);
+				}
+
+				faceVertices[i] = vertexIndex;
+			}
+
+			for (Nz::UInt32 index : ChunkMesherBase::s_faceIndices)
+				indices.push_back(faceVertices[index]);
+		});
 
-			return vertexAttributes;
-		};
+		for (std::size_t latticeIndex : latticeIndices)
+			vertexRemap[latticeIndex] = InvalidVertex;
 
-		BuildMesh(blockManager, indices, m_deformationCenter, AddVertices);
 		if (indices.empty())
 			return nullptr;
 
@@ -42,14 +71,20 @@ namespace tsom
 		// Compute direction
 		Direction closestDir = DirectionFromNormal(outsideNormal);
 
-		// Compute height
+		// Compute height, as the first layer containing the position (layers are nested so we can binary search it)
 		std::size_t z = 0;
-		for (; z < m_size.z; ++z)
+		std::size_t layerCount = m_size.z;
+		while (layerCount > 0)
 		{
-			float depth = z * m_blockSize;
-			float dist = sdRoundBox(position, Nz::Vector3f(depth), m_deformationRadius);
-			if (dist < 0.f)
-				break;
+			std::size_t halfCount = layerCount / 2;
+			float depth = (z + halfCount) * m_blockSize;
+			if (sdRoundBox(position, Nz::Vector3f(depth), m_deformationRadius) < 0.f)
+				layerCount = halfCount;
+			else
+			{
+				z += halfCount + 1;
+				layerCount -= halfCount + 1;
+			}
 		}
 
 		if (z >= m_size.z)
@@ -112,26 +147,24 @@ namespace tsom
 		return pos;
 	}
 
+	Nz::UInt64 DeformedChunk::ComputeGeometryHash() const
+	{
+		// Block corners also depend on the deformation
+		ContentHasher hasher;
+		hasher.Append(Chunk::ComputeGeometryHash());
+		hasher.Append(std::bit_cast<Nz::UInt32>(m_deformationCenter.x));
+		hasher.Append(std::bit_cast<Nz::UInt32>(m_deformationCenter.y));
+		hasher.Append(std::bit_cast<Nz::UInt32>(m_deformationCenter.z));
+		hasher.Append(std::bit_cast<Nz::UInt32>(m_deformationRadius));
+
+		return hasher.GetHash();
+	}
+
 	Nz::EnumArray<Nz::BoxCorner, Nz::Vector3f> DeformedChunk::ComputeVoxelCorners(const Nz::Vector3ui& indices) const
 	{
-		float fX = indices.x * m_blockSize;
-		float fY = indices.y * m_blockSize;
-		float fZ = indices.z * m_blockSize;
-
-		Nz::Boxf box(fX, fZ, fY, m_blockSize, m_blockSize, m_blockSize);
-		Nz::EnumArray<Nz::BoxCorner, Nz::Vector3f> corners {
-			box.GetCorner(Nz::BoxCorner::FarLeftBottom),
-			box.GetCorner(Nz::BoxCorner::FarLeftTop),
-			box.GetCorner(Nz::BoxCorner::FarRightBottom),
-			box.GetCorner(Nz::BoxCorner::FarRightTop),
-			box.GetCorner(Nz::BoxCorner::NearLeftBottom),
-			box.GetCorner(Nz::BoxCorner::NearLeftTop),
-			box.GetCorner(Nz::BoxCorner::NearRightBottom),
-			box.GetCorner(Nz::BoxCorner::NearRightTop)
-		};
-
-		for (auto& position : corners)
-			position = DeformPosition(position);
+		Nz::EnumArray<Nz::BoxCorner, Nz::Vector3f> corners;
+		for (auto&& [corner, position] : corners.iter_kv())
+			position = m_lattice[GetLatticeIndex(indices + s_cornerOffsets[corner])];
 
 		return corners;
 	}
@@ -152,4 +185,53 @@ namespace tsom
 
 		return innerPos + normal * std::min(m_deformationRadius, distToCenter);
 	}
+
+	void DeformedChunk::UpdateLattice()
+	{
+		Nz::Vector3ui latticeSize = m_size + Nz::Vector3ui(1);
+		m_lattice.resize(std::size_t(latticeSize.x) * latticeSize.y * latticeSize.z);
+
+		// Same as DeformPosition, relative to the deformation center and written branchless on separate coordinates so rows get vectorized
+		std::vector<float> rowX(latticeSize.x);
+		std::vector<float> rowY(latticeSize.x);
+		std::vector<float> rowZ(latticeSize.x);
+
+		float radius = m_deformationRadius;
+		for (unsigned int z = 0; z < latticeSize.z; ++z)
+		{
+			for (unsigned int y = 0; y < latticeSize.y; ++y)
+			{
+				// Block (x, y, z) is positioned at (x, z, y)
+				float posY = z * m_blockSize - m_deformationCenter.y;
+				float posZ = y * m_blockSize - m_deformationCenter.z;
+
+				for (unsigned int x = 0; x < latticeSize.x; ++x)
+				{
+					float posX = x * m_blockSize - m_deformationCenter.x;
+
+					float distToCenter = std::max(std::abs(posX), std::max(std::abs(posY), std::abs(posZ)));
+					float innerReductionSize = std::max(distToCenter - radius, 0.f);
+
+					float innerX = std::clamp(posX, -innerReductionSize, innerReductionSize);
+					float innerY = std::clamp(posY, -innerReductionSize, innerReductionSize);
+					float innerZ = std::clamp(posZ, -innerReductionSize, innerReductionSize);
+
+					float normalX = posX - innerX;
+					float normalY = posY - innerY;
+					float normalZ = posZ - innerZ;
+
+					float length = std::sqrt(normalX * normalX + normalY * normalY + normalZ * normalZ);
+					float scale = (length > 0.f) ? std::min(radius, distToCenter) / length : 0.f;
+
+					rowX[x] = innerX + normalX * scale;
+					rowY[x] = innerY + normalY * scale;
+					rowZ[x] = innerZ + normalZ * scale;
+				}
+
+				Nz::Vector3f* row = &m_lattice[GetLatticeIndex({ 0, y, z })];
+				for (unsigned int x = 0; x < latticeSize.x; ++x)
+					row[x] = m_deformationCenter + Nz::Vector3f(rowX[x], rowY[x], rowZ[x]);
+			}
+		}
+	}
 }
@@ -4,115 +4,80 @@
 
 #include <CommonLib/FlatChunk.hpp>
 #include <CommonLib/ChunkContainer.hpp>
+#include <CommonLib/ChunkMesher.hpp>
 #include <Nazara/Physics3D/Collider3D.hpp>
-#include <NazaraUtils/Bitset.hpp>
 #include <fmt/format.h>
+#include <algorithm>
+#include <cassert>
 
 namespace tsom
 {
-	std::shared_ptr<Nz::Collider3D> FlatChunk::BuildCollider(const BlockLibrary& /*blockManager*/) const
+	std::shared_ptr<Nz::Collider3D> FlatChunk::BuildCollider(const BlockLibrary& /*blockManager*/, const ChunkSnapshot& snapshot, const Nz::Boxui& blocks, const ColliderSettings& settings) const
 	{
-		std::vector<Nz::CompoundCollider3D::ChildCollider> childColliders;
-
-		Nz::Bitset<Nz::UInt64> availableBlocks = GetCollisionCellMask();
+		if (snapshot.IsEmpty())
+			return {};
 
-		std::optional<Nz::Vector3ui> startPos;
-		auto CommitCollider = [&](unsigned int endX)
+		std::vector<Nz::CompoundCollider3D::ChildCollider> childColliders;
+		auto AddBox = [&](const Nz::Boxui& box)
 		{
-			if (!startPos)
-				return;
-
-			unsigned int endY = startPos->y;
-			unsigned int endZ = startPos->z;
-
-			// Try to grow on Y
-			for (endY += 1; endY < m_size.y; ++endY)
-			{
-				auto CheckX = [&]
-				{
-					for (unsigned int x = startPos->x; x <= endX; ++x)
-					{
-						if (!availableBlocks[GetBlockLocalIndex({ x, endY, endZ })])
-							return false;
-					}
-
-					return true;
-				};
-
-				if (!CheckX())
-					break;
-			}
-			endY--;
-
-			// Try to grow on Z
-			for (endZ += 1; endZ < m_size.z; ++endZ)
-			{
-				auto CheckXY = [&]
-				{
-					for (unsigned int y = startPos->y; y <= endY; ++y)
-					{
-						for (unsigned int x = startPos->x; x <= endX; ++x)
-						{
-							if (!availableBlocks[GetBlockLocalIndex({ x, y, endZ })])
-								return false;
-						}
-					}
-
-					return true;
-				};
-
-				if (!CheckXY())
-					break;
-			}
-			endZ--;
-
-			for (unsigned int z = startPos->z; z <= endZ; ++z)
-			{
-				for (unsigned int y = startPos->y; y <= endY; ++y)
-				{
-					for (unsigned int x = startPos->x; x <= endX; ++x)
-						availableBlocks[GetBlockLocalIndex({ x, y, z })] = false;
-				}
-			}
-
-			Nz::Vector3f startOffset(startPos->x, startPos->z, startPos->y);
-			Nz::Vector3f endOffset(endX + 1, endZ + 1, endY + 1);
-
-			Nz::Vector3f size = (endOffset - startOffset) * m_blockSize;
+			Nz::Vector3f startOffset(box.x, box.z, box.y);
+			Nz::Vector3f size = Nz::Vector3f(box.width, box.depth, box.height) * m_blockSize;
 
 			auto& childCollider = childColliders.emplace_back();
 			childCollider.offset = startOffset * m_blockSize + size * 0.5f - Nz::Vector3f(m_size) * m_blockSize * 0.5f;
 			childCollider.collider = std::make_shared<Nz::BoxCollider3D>(size);
-
-			startPos.reset();
 		};
 
-		Nz::Vector3f offset = Nz::Vector3f(m_blockSize) * 0.5f;
-		for (unsigned int z = 0; z < m_size.z; ++z)
+		// Uniform chunks are fully solid, a single box covers them
+		if (snapshot.IsUniform() && !settings.surfaceOnly)
+			AddBox(blocks);
+		else if (settings.surfaceOnly)
 		{
-			for (unsigned int y = 0; y < m_size.y; ++y)
-			{
-				for (unsigned int x = 0; x < m_size.x; ++x)
-				{
-					if (!availableBlocks[GetBlockLocalIndex({ x, y, z })])
-					{
-						CommitCollider(x - 1);
-						continue;
-					}
-
-					if (!startPos)
-						startPos = { x, y, z };
-				}
-				CommitCollider(m_size.x - 1);
-			}
+			// Boxes only have to cover exposed blocks, buried blocks are only used to merge them into bigger boxes
+			ChunkOccupancy surfaceOccupancy = snapshot.ComputeSurfaceOccupancy(blocks, std::max(settings.shellThickness, 1u));
+			surfaceOccupancy.ComputeBoxes(blocks, snapshot.GetOccupancy(), AddBox);
 		}
+		else
+			snapshot.GetOccupancy().ComputeBoxes(blocks, snapshot.GetOccupancy(), AddBox);
 
 		if (childColliders.empty())
 			return {};
 
+		// A single centered box (such as a full chunk) doesn't need a compound
+		if (childColliders.size() == 1 && childColliders.front().offset == Nz::Vector3f::Zero())
+			return std::move(childColliders.front().collider);
+
 		return std::make_shared<Nz::CompoundCollider3D>(std::move(childColliders));
 	}
 
+	void FlatChunk::BuildGreedyMesh(const BlockLibrary& blockManager, const ChunkSnapshot& snapshot, const Nz::Boxui& blocks, std::vector<Nz::UInt32>& indices, const Nz::Vector3f& gravityCenter, const Nz::FunctionRef<VertexAttributes(Nz::UInt32 count)>& addVertices) const
+	{
+		auto AddFace = [&](const ChunkMeshFace& face)
+		{
+			VertexAttributes vertexAttributes = addVertices(Nz::SafeCast<Nz::UInt32>(face.positions.size()));
+			assert(vertexAttributes.position);
+
+			for (std::size_t i = 0; i < face.positions.size(); ++i)
+			{
+				vertexAttributes.position[i] = face.positions[i];
+
+				if (vertexAttributes.normal)
+					vertexAttributes.normal[i] = face.normal;
+
+				if (vertexAttributes.tangent)
+					vertexAttributes.tangent[i] = face.tangent;
+
+				if (vertexAttributes.uv)
+					vertexAttributes.uv[i] = Nz::Vector3f(face.uvs[i], face.textureIndex);
+			}
+
+			for (Nz::UInt32 index : ChunkMesherBase::s_faceIndices)
+				indices.push_back(vertexAttributes.firstIndex + index);
+		};
+
+		ChunkMesher(*this, blockManager, AddFace).BuildGreedyMesh(snapshot, blocks, gravityCenter);
+	}
+
 	std::optional<Nz::Vector3ui> FlatChunk::ComputeCoordinates(const Nz::Vector3f& position) const
 	{
 		Nz::Vector3f indices = position - m_owner.GetChunkOffset(m_indices);
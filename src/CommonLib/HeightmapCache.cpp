@@ -0,0 +1,66 @@
+// Copyright (C) 2024 Jérôme "SirLynix" Leclercq (lynix680@gmail.com) (lynix680@gmail.com)
+// This file is part of the "This Space Of Mine" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CommonLib/HeightmapCache.hpp>
+
+namespace tsom
+{
+	HeightmapCache::HeightmapCache(std::size_t capacity) :
+	m_tiles(capacity)
+	{
+	}
+
+	std::shared_ptr<const std::vector<double>> HeightmapCache::Acquire(Direction face, const Nz::Vector2i& column, unsigned int columnChunkCount, const ComputeCallback& computeHeights)
+	{
+		std::shared_ptr<Tile> tile;
+		{
+			std::scoped_lock lock(m_mutex);
+
+			TileKey key{ face, column };
+			if (const std::shared_ptr<Tile>* cachedTile = m_tiles.Find(key))
+				tile = *cachedTile;
+			else
+			{
+				tile = std::make_shared<Tile>();
+				tile->remainingUses = columnChunkCount;
+
+				// Tiles used by a single chunk don't need to go through the cache
+				if (columnChunkCount > 1)
+					m_tiles.Insert(key, tile);
+			}
+
+			// The last chunk of the column keeps the tile alive on its own
+			if (tile->remainingUses <= 1)
+				m_tiles.Erase(key);
+			else
+				tile->remainingUses--;
+		}
+
+		// Chunks of the same column acquiring the tile concurrently wait for the first one to compute it
+		std::call_once(tile->computeFlag, [&]
+		{
+			computeHeights(tile->heights);
+		});
+
+		return std::shared_ptr<const std::vector<double>>(tile, &tile->heights);
+	}
+
+	void HeightmapCache::Clear()
+	{
+		std::scoped_lock lock(m_mutex);
+		m_tiles.Clear();
+	}
+
+	std::size_t HeightmapCache::GetCapacity() const
+	{
+		std::scoped_lock lock(m_mutex);
+		return m_tiles.GetCapacity();
+	}
+
+	std::size_t HeightmapCache::GetTileCount() const
+	{
+		std::scoped_lock lock(m_mutex);
+		return m_tiles.GetSize();
+	}
+}
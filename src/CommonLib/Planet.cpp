@@ -12,43 +12,110 @@
 #include <Nazara/Math/Ray.hpp>
 #include <Nazara/Physics3D/Collider3D.hpp>
 #include <NazaraUtils/CallOnExit.hpp>
-#include <PerlinNoise.hpp>
 #include <fmt/format.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <random>
+#include <span>
 
 namespace tsom
 {
 	Planet::Planet(float tileSize, float cornerRadius, float gravityFactor) :
 	ChunkContainer(tileSize),
 	m_cornerRadius(cornerRadius),
-	m_gravityFactor(gravityFactor)
+	m_gravityFactor(gravityFactor),
+	m_generatorVersion(GeneratorVersion)
 	{
 	}
 
 	Chunk& Planet::AddChunk(const ChunkIndices& indices, const Nz::FunctionRef<void(BlockIndex* blocks)>& initCallback)
 	{
-		assert(!m_chunks.contains(indices));
-		ChunkData chunkData;
-		chunkData.chunk = std::make_unique<FlatChunk>(*this, indices, Nz::Vector3ui{ ChunkSize }, m_tileSize);
+		std::unique_ptr<Chunk> chunk = std::make_unique<FlatChunk>(*this, indices, Nz::Vector3ui{ ChunkSize }, m_tileSize);
 
 		if (initCallback)
-			chunkData.chunk->Reset(initCallback);
+			chunk->Reset(initCallback);
+
+		return AddChunk(std::move(chunk));
+	}
+
+	// Takes ownership of a chunk built for this planet (such as a chunk generated on another thread), without copying its content
+	Chunk& Planet::AddChunk(std::unique_ptr<Chunk> newChunk)
+	{
+		assert(&newChunk->GetContainer() == this);
+
+		ChunkIndices indices = newChunk->GetIndices();
+		assert(!m_chunks.contains(indices));
+
+		ChunkData chunkData;
+		chunkData.chunk = std::move(newChunk);
 
 		chunkData.onReset.Connect(chunkData.chunk->OnReset, [this](Chunk* chunk)
 		{
 			OnChunkUpdated(this, chunk);
+
+			for (auto&& [direction, normal] : s_dirNormals.iter_kv())
+				NotifyNeighborUpdate(chunk, direction);
 		});
 
-		chunkData.onUpdated.Connect(chunkData.chunk->OnBlockUpdated, [this](Chunk* chunk, const Nz::Vector3ui& /*indices*/, BlockIndex /*newBlock*/)
+		chunkData.onUpdated.Connect(chunkData.chunk->OnBlocksUpdated, [this](Chunk* chunk, std::span<const Chunk::BlockUpdate> updates)
 		{
 			OnChunkUpdated(this, chunk);
+
+			// Blocks on the border of a chunk affect faces of its neighbors
+			const Nz::Vector3ui& chunkSize = chunk->GetSize();
+
+			Nz::EnumArray<Direction, bool> updatedBorders;
+			updatedBorders.fill(false);
+
+			for (const Chunk::BlockUpdate& update : updates)
+			{
+				if (update.indices.x == 0)
+					updatedBorders[Direction::Left] = true;
+				else if (update.indices.x == chunkSize.x - 1)
+					updatedBorders[Direction::Right] = true;
+
+				if (update.indices.y == 0)
+					updatedBorders[Direction::Front] = true;
+				else if (update.indices.y == chunkSize.y - 1)
+					updatedBorders[Direction::Back] = true;
+
+				if (update.indices.z == 0)
+					updatedBorders[Direction::Down] = true;
+				else if (update.indices.z == chunkSize.z - 1)
+					updatedBorders[Direction::Up] = true;
+			}
+
+			for (auto&& [direction, updated] : updatedBorders.iter_kv())
+			{
+				if (updated)
+					NotifyNeighborUpdate(chunk, direction);
+			}
 		});
 
 		auto it = m_chunks.insert_or_assign(indices, std::move(chunkData)).first;
+		Chunk* chunk = it->second.chunk.get();
 
-		OnChunkAdded(this, it->second.chunk.get());
+		// Link neighbors, the new chunk isn't visible to anyone yet but its neighbors may be read by other threads
+		for (auto&& [direction, normal] : s_dirNormals.iter_kv())
+		{
+			Chunk* neighbor = GetChunk(indices + ChunkIndices(normal));
+			if (!neighbor)
+				continue;
 
-		return *it->second.chunk;
+			chunk->SetNeighborChunk(direction, neighbor);
+
+			neighbor->LockWrite();
+			neighbor->SetNeighborChunk(OppositeDirection(direction), chunk);
+			neighbor->UnlockWrite();
+		}
+
+		OnChunkAdded(this, chunk);
+
+		for (auto&& [direction, normal] : s_dirNormals.iter_kv())
+			NotifyNeighborUpdate(chunk, direction);
+
+		return *chunk;
 	}
 
 	Nz::Vector3f Planet::ComputeUpDirection(const Nz::Vector3f& position) const
@@ -81,11 +148,29 @@ namespace tsom
 			callback(chunkIndices, *chunkData.chunk);
 	}
 
-	void Planet::GenerateChunk(const BlockLibrary& blockLibrary, Chunk& chunk, Nz::UInt32 seed, const Nz::Vector3ui& chunkCount)
+	auto Planet::GenerateChunk(const BlockLibrary& blockLibrary, Chunk& chunk, Nz::UInt32 seed, const Nz::Vector3ui& chunkCount, bool classifyChunk) -> GenerationPath
 	{
-		constexpr std::size_t freeSpace = 30;
+		constexpr std::size_t freeSpace = TerrainFreeSpace;
 
 		ChunkIndices chunkIndices = chunk.GetIndices();
+
+		ChunkGenerationBounds generationBounds = ComputeGenerationBounds(chunkIndices, chunkCount);
+		if (!classifyChunk)
+		{
+			// Go through every block and every surface pass
+			generationBounds.empty = false;
+			generationBounds.surfaceFaces.fill(true);
+		}
+
+		if (generationBounds.empty)
+		{
+			chunk.LockWrite();
+			chunk.Fill(EmptyBlockIndex);
+			chunk.UnlockWrite();
+
+			return GenerationPath::Empty;
+		}
+
 		Nz::UInt32 chunkSeed = seed + static_cast<Nz::UInt32>(chunkIndices.x) + static_cast<Nz::UInt32>(chunkIndices.y) + static_cast<Nz::UInt32>(chunkIndices.z);
 
 		std::minstd_rand rand(chunkSeed);
@@ -100,9 +185,12 @@ namespace tsom
 		Nz::Vector3i maxHeight((Nz::Vector3i(chunkCount) + Nz::Vector3i(1)) / 2);
 		maxHeight *= int(Planet::ChunkSize);
 
-		Nz::EnumArray<Direction, siv::PerlinNoise> perlin;
-		for (auto&& [dir, noise] : perlin.iter_kv())
-			noise.reseed(seed + static_cast<unsigned int>(dir));
+		bool reachesSurface = std::any_of(generationBounds.surfaceFaces.begin(), generationBounds.surfaceFaces.end(), [](bool reached) { return reached; });
+
+		// Chunks out of reach of all surface passes only need their layers
+		std::shared_ptr<const TerrainNoise> terrainNoise;
+		if (reachesSurface)
+			terrainNoise = GetTerrainNoise(seed);
 
 		chunk.LockWrite();
 		NAZARA_DEFER({ chunk.UnlockWrite(); });
@@ -120,19 +208,22 @@ namespace tsom
 					for (unsigned int x = 0; x < Planet::ChunkSize; ++x)
 					{
 						Nz::Vector3i blockPos = GetBlockIndices(chunkIndices, { x, y, z });
-						unsigned int depth = Nz::SafeCaster(std::min({
+						int blockDepth = std::min({
 							maxHeight.x - std::abs(blockPos.x),
 							maxHeight.y - std::abs(blockPos.z),
 							maxHeight.z - std::abs(blockPos.y)
-						}));
+						});
 
-						if (depth < freeSpace)
+						// Blocks past the planet height (outer chunks of even chunk counts) have a negative depth and are in free space as well,
+						// the first generator version wrapped that depth around (as unsigned) and filled them as deep layers
+						bool wrapsDepth = (blockDepth < 0 && m_generatorVersion < 2);
+						if (blockDepth < int(freeSpace) && !wrapsDepth)
 						{
 							*blockIndexPtr++ = EmptyBlockIndex;
 							continue;
 						}
 
-						depth -= freeSpace;
+						unsigned int depth = static_cast<unsigned int>(blockDepth) - static_cast<unsigned int>(freeSpace);
 
 						BlockIndex blockIndex;
 						if (depth <= 6)
@@ -151,179 +242,241 @@ namespace tsom
 				}
 			}
 
-			constexpr double heightScale = 1.5f;
 			constexpr double scale = 0.02f;
 
-			// +X
-			for (unsigned int y = 0; y < Planet::ChunkSize; ++y)
+			// Noise coordinates of the chunk blocks along each axis
+			BlockIndices chunkOrigin = GetBlockIndices(chunkIndices, { 0, 0, 0 });
+
+			std::array<double, Planet::ChunkSize> noiseX;
+			std::array<double, Planet::ChunkSize> noiseY;
+			std::array<double, Planet::ChunkSize> noiseZ;
+			for (unsigned int i = 0; i < Planet::ChunkSize; ++i)
+			{
+				noiseX[i] = (chunkOrigin.x + int(i)) * scale;
+				noiseY[i] = (chunkOrigin.y + int(i)) * scale;
+				noiseZ[i] = (chunkOrigin.z + int(i)) * scale;
+			}
+
+			// Chunks stacked along a face normal share the same heightmap, only the first one of the column computes it
+			auto GetFaceHeightmap = [&](Direction face, const Nz::Vector2i& column, std::span<const double> xValues, std::span<const double> yValues)
 			{
-				for (unsigned int x = 0; x < Planet::ChunkSize; ++x)
+				// Unclassified chunks don't know which chunks of their column will use the heightmap, don't keep it around
+				unsigned int columnChunkCount = (classifyChunk) ? CountSurfaceChunks(chunkIndices, face, chunkCount) : 1;
+				return m_heightmapCache.Acquire(face, column, columnChunkCount, [&](std::vector<double>& heights)
 				{
-					BlockIndices mapPos = GetBlockIndices(chunkIndices, { 0, x, y });
-					double height = perlin[Direction::Right].normalizedOctave2D_01(mapPos.y * scale, mapPos.z * scale, 4) * heightScale;
+					heights.resize(xValues.size() * yValues.size());
+					terrainNoise->faceNoises[face].ComputeNormalizedOctave2D(xValues, yValues, 4, heights.data());
+				});
+			};
 
-					int terrainDepth = std::round(std::min<double>(height * (maxHeight.x / 2 - freeSpace) + freeSpace, maxHeight.x / 2));
-					int blockDepth = maxHeight.x - mapPos.x + 1;
-					if (blockDepth < terrainDepth)
-						continue;
+			std::shared_ptr<const std::vector<double>> heightmap;
 
-					unsigned int startHeight = Nz::SafeCaster(blockDepth - terrainDepth);
-					if (startHeight >= Planet::ChunkSize)
-						continue;
+			// +X
+			if (generationBounds.surfaceFaces[Direction::Right])
+			{
+				heightmap = GetFaceHeightmap(Direction::Right, { chunkIndices.y, chunkIndices.z }, noiseY, noiseZ);
+				for (unsigned int y = 0; y < Planet::ChunkSize; ++y)
+				{
+					for (unsigned int x = 0; x < Planet::ChunkSize; ++x)
+					{
+						BlockIndices mapPos = GetBlockIndices(chunkIndices, { 0, x, y });
+						int terrainDepth = ComputeTerrainDepth((*heightmap)[x * Planet::ChunkSize + y], maxHeight.x);
+						int blockDepth = maxHeight.x - mapPos.x + 1;
+						if (blockDepth < terrainDepth)
+							continue;
 
-					if (BlockIndex& blockType = blockIndices[chunk.GetBlockLocalIndex({ startHeight, x, y })]; blockType == dirtBlockIndex)
-						blockType = grassBlockIndex;
+						unsigned int startHeight = Nz::SafeCaster(blockDepth - terrainDepth);
+						if (startHeight >= Planet::ChunkSize)
+							continue;
 
-					for (unsigned int height = startHeight + 1; height < Planet::ChunkSize; ++height)
-						blockIndices[chunk.GetBlockLocalIndex({ height, x, y })] = EmptyBlockIndex;
+						if (BlockIndex& blockType = blockIndices[chunk.GetBlockLocalIndex({ startHeight, x, y })]; blockType == dirtBlockIndex)
+							blockType = grassBlockIndex;
+
+						for (unsigned int height = startHeight + 1; height < Planet::ChunkSize; ++height)
+							blockIndices[chunk.GetBlockLocalIndex({ height, x, y })] = EmptyBlockIndex;
+					}
 				}
 			}
 
 			// -X
-			for (unsigned int y = 0; y < Planet::ChunkSize; ++y)
+			if (generationBounds.surfaceFaces[Direction::Left])
 			{
-				for (unsigned int x = 0; x < Planet::ChunkSize; ++x)
+				heightmap = GetFaceHeightmap(Direction::Left, { chunkIndices.y, chunkIndices.z }, noiseY, noiseZ);
+				for (unsigned int y = 0; y < Planet::ChunkSize; ++y)
 				{
-					BlockIndices mapPos = GetBlockIndices(chunkIndices, { Planet::ChunkSize - 1, x, y });
-					double height = perlin[Direction::Left].normalizedOctave2D_01(mapPos.y * scale, mapPos.z * scale, 4) * heightScale;
-
-					int terrainDepth = std::round(std::min<double>(height * (maxHeight.x / 2 - freeSpace) + freeSpace, maxHeight.x / 2));
-					int blockDepth = maxHeight.x + mapPos.x + 1;
-					if (blockDepth < terrainDepth)
-						continue;
+					for (unsigned int x = 0; x < Planet::ChunkSize; ++x)
+					{
+						BlockIndices mapPos = GetBlockIndices(chunkIndices, { Planet::ChunkSize - 1, x, y });
+						int terrainDepth = ComputeTerrainDepth((*heightmap)[x * Planet::ChunkSize + y], maxHeight.x);
+						int blockDepth = maxHeight.x + mapPos.x + 1;
+						if (blockDepth < terrainDepth)
+							continue;
 
-					unsigned int startHeight = Nz::SafeCast<unsigned int>(blockDepth - terrainDepth);
-					if (startHeight >= Planet::ChunkSize)
-						continue;
+						unsigned int startHeight = Nz::SafeCast<unsigned int>(blockDepth - terrainDepth);
+						if (startHeight >= Planet::ChunkSize)
+							continue;
 
-					if (BlockIndex& blockType = blockIndices[chunk.GetBlockLocalIndex({ Planet::ChunkSize - startHeight - 1, x, y })]; blockType == dirtBlockIndex)
-						blockType = grassBlockIndex;
+						if (BlockIndex& blockType = blockIndices[chunk.GetBlockLocalIndex({ Planet::ChunkSize - startHeight - 1, x, y })]; blockType == dirtBlockIndex)
+							blockType = grassBlockIndex;
 
-					for (unsigned int height = startHeight + 1; height < Planet::ChunkSize; ++height)
-						blockIndices[chunk.GetBlockLocalIndex({ Planet::ChunkSize - height - 1, x, y })] = EmptyBlockIndex;
+						for (unsigned int height = startHeight + 1; height < Planet::ChunkSize; ++height)
+							blockIndices[chunk.GetBlockLocalIndex({ Planet::ChunkSize - height - 1, x, y })] = EmptyBlockIndex;
+					}
 				}
 			}
 
 			// +Y
-			for (unsigned int z = 0; z < Planet::ChunkSize; ++z)
+			if (generationBounds.surfaceFaces[Direction::Up])
 			{
-				for (unsigned int x = 0; x < Planet::ChunkSize; ++x)
+				heightmap = GetFaceHeightmap(Direction::Up, { chunkIndices.x, chunkIndices.z }, noiseX, noiseZ);
+				for (unsigned int z = 0; z < Planet::ChunkSize; ++z)
 				{
-					BlockIndices mapPos = GetBlockIndices(chunkIndices, { x, z, 0 });
-					double height = perlin[Direction::Up].normalizedOctave2D_01(mapPos.x * scale, mapPos.z * scale, 4) * heightScale;
-
-					int terrainDepth = std::round(std::min<double>(height * (maxHeight.y / 2 - freeSpace) + freeSpace, maxHeight.y / 2));
-					int blockDepth = maxHeight.y - mapPos.y + 1;
-					if (blockDepth < terrainDepth)
-						continue;
+					for (unsigned int x = 0; x < Planet::ChunkSize; ++x)
+					{
+						BlockIndices mapPos = GetBlockIndices(chunkIndices, { x, z, 0 });
+						int terrainDepth = ComputeTerrainDepth((*heightmap)[z * Planet::ChunkSize + x], maxHeight.y);
+						int blockDepth = maxHeight.y - mapPos.y + 1;
+						if (blockDepth < terrainDepth)
+							continue;
 
-					unsigned int startHeight = Nz::SafeCaster(blockDepth - terrainDepth);
-					if (startHeight >= Planet::ChunkSize)
-						continue;
+						unsigned int startHeight = Nz::SafeCaster(blockDepth - terrainDepth);
+						if (startHeight >= Planet::ChunkSize)
+							continue;
 
-					if (BlockIndex& blockType = blockIndices[chunk.GetBlockLocalIndex({ x, z, startHeight })]; blockType == dirtBlockIndex)
-						blockType = grassBlockIndex;
+						if (BlockIndex& blockType = blockIndices[chunk.GetBlockLocalIndex({ x, z, startHeight })]; blockType == dirtBlockIndex)
+							blockType = grassBlockIndex;
 
-					for (unsigned int height = startHeight + 1; height < Planet::ChunkSize; ++height)
-						blockIndices[chunk.GetBlockLocalIndex({ x, z, height })] = EmptyBlockIndex;
+						for (unsigned int height = startHeight + 1; height < Planet::ChunkSize; ++height)
+							blockIndices[chunk.GetBlockLocalIndex({ x, z, height })] = EmptyBlockIndex;
+					}
 				}
 			}
 
 			// -Y
-			for (unsigned int z = 0; z < Planet::ChunkSize; ++z)
+			if (generationBounds.surfaceFaces[Direction::Down])
 			{
-				for (unsigned int x = 0; x < Planet::ChunkSize; ++x)
+				heightmap = GetFaceHeightmap(Direction::Down, { chunkIndices.x, chunkIndices.z }, noiseX, noiseZ);
+				for (unsigned int z = 0; z < Planet::ChunkSize; ++z)
 				{
-					BlockIndices mapPos = GetBlockIndices(chunkIndices, { x, z, Planet::ChunkSize - 1 });
-					double height = perlin[Direction::Down].normalizedOctave2D_01(mapPos.x * scale, mapPos.z * scale, 4) * heightScale;
-
-					int terrainDepth = std::round(std::min<double>(height * (maxHeight.y / 2 - freeSpace) + freeSpace, maxHeight.y / 2));
-					int blockDepth = maxHeight.y + mapPos.y + 1;
-					if (blockDepth < terrainDepth)
-						continue;
+					for (unsigned int x = 0; x < Planet::ChunkSize; ++x)
+					{
+						BlockIndices mapPos = GetBlockIndices(chunkIndices, { x, z, Planet::ChunkSize - 1 });
+						int terrainDepth = ComputeTerrainDepth((*heightmap)[z * Planet::ChunkSize + x], maxHeight.y);
+						int blockDepth = maxHeight.y + mapPos.y + 1;
+						if (blockDepth < terrainDepth)
+							continue;
 
-					unsigned int startHeight = Nz::SafeCast<unsigned int>(blockDepth - terrainDepth);
-					if (startHeight >= Planet::ChunkSize)
-						continue;
+						unsigned int startHeight = Nz::SafeCast<unsigned int>(blockDepth - terrainDepth);
+						if (startHeight >= Planet::ChunkSize)
+							continue;
 
-					if (BlockIndex& blockType = blockIndices[chunk.GetBlockLocalIndex({ x, z, Planet::ChunkSize - startHeight - 1 })]; blockType == dirtBlockIndex)
-						blockType = grassBlockIndex;
+						if (BlockIndex& blockType = blockIndices[chunk.GetBlockLocalIndex({ x, z, Planet::ChunkSize - startHeight - 1 })]; blockType == dirtBlockIndex)
+							blockType = grassBlockIndex;
 
-					for (unsigned int height = startHeight + 1; height < Planet::ChunkSize; ++height)
-						blockIndices[chunk.GetBlockLocalIndex({ x, z, Planet::ChunkSize - height - 1 })] = EmptyBlockIndex;
+						for (unsigned int height = startHeight + 1; height < Planet::ChunkSize; ++height)
+							blockIndices[chunk.GetBlockLocalIndex({ x, z, Planet::ChunkSize - height - 1 })] = EmptyBlockIndex;
+					}
 				}
 			}
 
 			// +Z
-			for (unsigned int y = 0; y < Planet::ChunkSize; ++y)
+			if (generationBounds.surfaceFaces[Direction::Back])
 			{
-				for (unsigned int x = 0; x < Planet::ChunkSize; ++x)
+				heightmap = GetFaceHeightmap(Direction::Back, { chunkIndices.x, chunkIndices.y }, noiseX, noiseY);
+				for (unsigned int y = 0; y < Planet::ChunkSize; ++y)
 				{
-					BlockIndices mapPos = GetBlockIndices(chunkIndices, { x, 0, y });
-					double height = perlin[Direction::Back].normalizedOctave2D_01(mapPos.x * scale, mapPos.y * scale, 4) * heightScale;
-
-					int terrainDepth = std::round(std::min<double>(height * (maxHeight.z / 2 - freeSpace) + freeSpace, maxHeight.z / 2));
-					int blockDepth = maxHeight.z - mapPos.z + 1;
-					if (blockDepth < terrainDepth)
-						continue;
+					for (unsigned int x = 0; x < Planet::ChunkSize; ++x)
+					{
+						BlockIndices mapPos = GetBlockIndices(chunkIndices, { x, 0, y });
+						int terrainDepth = ComputeTerrainDepth((*heightmap)[y * Planet::ChunkSize + x], maxHeight.z);
+						int blockDepth = maxHeight.z - mapPos.z + 1;
+						if (blockDepth < terrainDepth)
+							continue;
 
-					unsigned int startHeight = Nz::SafeCaster(blockDepth - terrainDepth);
-					if (startHeight >= Planet::ChunkSize)
-						continue;
+						unsigned int startHeight = Nz::SafeCaster(blockDepth - terrainDepth);
+						if (startHeight >= Planet::ChunkSize)
+							continue;
 
-					if (BlockIndex& blockType = blockIndices[chunk.GetBlockLocalIndex({ x, startHeight, y })]; blockType == dirtBlockIndex)
-						blockType = grassBlockIndex;
+						if (BlockIndex& blockType = blockIndices[chunk.GetBlockLocalIndex({ x, startHeight, y })]; blockType == dirtBlockIndex)
+							blockType = grassBlockIndex;
 
-					for (unsigned int height = startHeight + 1; height < Planet::ChunkSize; ++height)
-						blockIndices[chunk.GetBlockLocalIndex({ x, height, y })] = EmptyBlockIndex;
+						for (unsigned int height = startHeight + 1; height < Planet::ChunkSize; ++height)
+							blockIndices[chunk.GetBlockLocalIndex({ x, height, y })] = EmptyBlockIndex;
+					}
 				}
 			}
 
 			// -Z
-			for (unsigned int y = 0; y < Planet::ChunkSize; ++y)
+			if (generationBounds.surfaceFaces[Direction::Front])
 			{
-				for (unsigned int x = 0; x < Planet::ChunkSize; ++x)
+				heightmap = GetFaceHeightmap(Direction::Front, { chunkIndices.x, chunkIndices.y }, noiseX, noiseY);
+				for (unsigned int y = 0; y < Planet::ChunkSize; ++y)
 				{
-					BlockIndices mapPos = GetBlockIndices(chunkIndices, { x, Planet::ChunkSize - 1, y });
-					double height = perlin[Direction::Front].normalizedOctave2D_01(mapPos.x * scale, mapPos.y * scale, 4) * heightScale;
-
-					int terrainDepth = std::round(std::min<double>(height * (maxHeight.z / 2 - freeSpace) + freeSpace, maxHeight.z / 2));
-					int blockDepth = maxHeight.z + mapPos.z + 1;
-					if (blockDepth < terrainDepth)
-						continue;
+					for (unsigned int x = 0; x < Planet::ChunkSize; ++x)
+					{
+						BlockIndices mapPos = GetBlockIndices(chunkIndices, { x, Planet::ChunkSize - 1, y });
+						int terrainDepth = ComputeTerrainDepth((*heightmap)[y * Planet::ChunkSize + x], maxHeight.z);
+						int blockDepth = maxHeight.z + mapPos.z + 1;
+						if (blockDepth < terrainDepth)
+							continue;
 
-					unsigned int startHeight = Nz::SafeCaster(blockDepth - terrainDepth);
-					if (startHeight >= Planet::ChunkSize)
-						continue;
+						unsigned int startHeight = Nz::SafeCaster(blockDepth - terrainDepth);
+						if (startHeight >= Planet::ChunkSize)
+							continue;
 
-					if (BlockIndex& blockType = blockIndices[chunk.GetBlockLocalIndex({ x, Planet::ChunkSize - startHeight - 1, y })]; blockType == dirtBlockIndex)
-						blockType = grassBlockIndex;
+						if (BlockIndex& blockType = blockIndices[chunk.GetBlockLocalIndex({ x, Planet::ChunkSize - startHeight - 1, y })]; blockType == dirtBlockIndex)
+							blockType = grassBlockIndex;
 
-					for (unsigned int height = startHeight + 1; height < Planet::ChunkSize; ++height)
-						blockIndices[chunk.GetBlockLocalIndex({ x, Planet::ChunkSize - height - 1, y })] = EmptyBlockIndex;
+						for (unsigned int height = startHeight + 1; height < Planet::ChunkSize; ++height)
+							blockIndices[chunk.GetBlockLocalIndex({ x, Planet::ChunkSize - height - 1, y })] = EmptyBlockIndex;
+					}
 				}
 			}
 		});
+
+		return (reachesSurface) ? GenerationPath::Surface : GenerationPath::LayersOnly;
 	}
 
-	void Planet::GenerateChunks(const BlockLibrary& blockLibrary, Nz::TaskScheduler& taskScheduler, Nz::UInt32 seed, const Nz::Vector3ui& chunkCount)
+	auto Planet::GenerateChunks(const BlockLibrary& blockLibrary, Nz::TaskScheduler& taskScheduler, Nz::UInt32 seed, const Nz::Vector3ui& chunkCount) -> GenerationStats
 	{
+		// Add all chunks before generating them, as adding a chunk locks its neighbors
+		std::vector<Chunk*> chunks;
+		chunks.reserve(chunkCount.x * chunkCount.y * chunkCount.z);
+
 		for (int chunkZ = 0; chunkZ < chunkCount.z; ++chunkZ)
 		{
 			for (int chunkY = 0; chunkY < chunkCount.y; ++chunkY)
 			{
 				for (int chunkX = 0; chunkX < chunkCount.x; ++chunkX)
+					chunks.push_back(&AddChunk({ chunkX - int(chunkCount.x / 2), chunkY - int(chunkCount.y / 2), chunkZ - int(chunkCount.z / 2) }));
+			}
+		}
+
+		std::atomic_size_t emptyChunkCount = 0;
+		std::atomic_size_t surfaceChunkCount = 0;
+		std::atomic_size_t layersOnlyChunkCount = 0;
+
+		for (Chunk* chunk : chunks)
+		{
+			taskScheduler.AddTask([&, chunk]
+			{
+				switch (GenerateChunk(blockLibrary, *chunk, seed, chunkCount))
 				{
-					auto& chunk = AddChunk({ chunkX - int(chunkCount.x / 2), chunkY - int(chunkCount.y / 2), chunkZ - int(chunkCount.z / 2) });
-					taskScheduler.AddTask([&]
-					{
-						GenerateChunk(blockLibrary, chunk, seed, chunkCount);
-					});
+					case GenerationPath::Empty: emptyChunkCount++; break;
+					case GenerationPath::Surface: surfaceChunkCount++; break;
+					case GenerationPath::LayersOnly: layersOnlyChunkCount++; break;
 				}
-			}
+			});
 		}
 
 		taskScheduler.WaitForTasks();
+
+		GenerationStats stats;
+		stats.emptyChunkCount = emptyChunkCount;
+		stats.surfaceChunkCount = surfaceChunkCount;
+		stats.layersOnlyChunkCount = layersOnlyChunkCount;
+
+		return stats;
 	}
 
 	void Planet::GeneratePlatform(const BlockLibrary& blockLibrary, Direction upDirection, const BlockIndices& platformCenter)
@@ -345,6 +498,9 @@ namespace tsom
 		BlockIndex borderBlockIndex = blockLibrary.GetBlockIndex("copper_block");
 		BlockIndex interiorBlockIndex = blockLibrary.GetBlockIndex("stone_bricks");
 
+		// Group block updates per chunk to apply them all at once
+		tsl::hopscotch_map<Chunk*, std::vector<Chunk::BlockUpdate>> chunkUpdates;
+
 		BlockIndices originalCoordinates = coordinates;
 		for (unsigned int y = 0; y < freeHeight; ++y)
 		{
@@ -365,7 +521,7 @@ namespace tsom
 					Nz::Vector3ui innerCoordinates;
 					ChunkIndices chunkIndices = GetChunkIndicesByBlockIndices(coordinates, &innerCoordinates);
 					if (Chunk* chunk = GetChunk(chunkIndices))
-						chunk->UpdateBlock(innerCoordinates, blockIndex);
+						chunkUpdates[chunk].push_back({ innerCoordinates, blockIndex });
 
 					xPos += dirAxis.rightDir;
 				}
@@ -421,7 +577,7 @@ namespace tsom
 					}
 
 					hasEmpty = true;
-					chunk->UpdateBlock(innerCoordinates, planksBlockIndex);
+					chunkUpdates[chunk].push_back({ innerCoordinates, planksBlockIndex });
 				}
 
 				xPos = startingX;
@@ -433,6 +589,145 @@ namespace tsom
 
 			zPos = startingZ;
 		}
+
+		for (auto&& [chunk, updates] : chunkUpdates)
+		{
+			chunk->LockWrite();
+			chunk->UpdateBlocks(updates);
+			chunk->UnlockWrite();
+		}
+	}
+
+	// Conservative bounds of what generation can do to a chunk, from the planet dimensions and the noise range alone
+	auto Planet::ComputeGenerationBounds(const ChunkIndices& chunkIndices, const Nz::Vector3ui& chunkCount) const -> ChunkGenerationBounds
+	{
+		Nz::Vector3i maxHeight((Nz::Vector3i(chunkCount) + Nz::Vector3i(1)) / 2);
+		maxHeight *= int(Planet::ChunkSize);
+
+		BlockIndices firstBlock = GetBlockIndices(chunkIndices, { 0, 0, 0 });
+		BlockIndices lastBlock = GetBlockIndices(chunkIndices, { ChunkSize - 1, ChunkSize - 1, ChunkSize - 1 });
+
+		auto GetMinDistance = [](int first, int last)
+		{
+			return (first <= 0 && last >= 0) ? 0 : std::min(std::abs(first), std::abs(last));
+		};
+
+		// Block depth is the minimum of one term per axis, the deepest block of the chunk reaches the deepest value of each term
+		int maxDepth = std::min({
+			maxHeight.x - GetMinDistance(firstBlock.x, lastBlock.x),
+			maxHeight.y - GetMinDistance(firstBlock.z, lastBlock.z),
+			maxHeight.z - GetMinDistance(firstBlock.y, lastBlock.y)
+		});
+
+		// Chunks are aligned so that no chunk inside the planet fits in its free space, only chunks reaching past the planet height can be empty
+		// (except with the first generator version, which filled blocks past the planet height)
+		ChunkGenerationBounds bounds;
+		bounds.empty = (maxDepth < int(TerrainFreeSpace));
+		if (m_generatorVersion < 2)
+		{
+			auto GetMaxDistance = [](int first, int last)
+			{
+				return std::max(std::abs(first), std::abs(last));
+			};
+
+			bool insidePlanet = GetMaxDistance(firstBlock.x, lastBlock.x) <= maxHeight.x && GetMaxDistance(firstBlock.z, lastBlock.z) <= maxHeight.y && GetMaxDistance(firstBlock.y, lastBlock.y) <= maxHeight.z;
+			bounds.empty = bounds.empty && insidePlanet;
+		}
+
+		// Surface passes carve blocks from the terrain depth up to a chunk size past it, terrain depth is monotonic in the noise (which lies in [0, 1])
+		// but decreases with it on planets smaller than twice the free space
+		auto CanReachSurface = [](int blockDepth, int maxHeight)
+		{
+			int lowNoiseDepth = ComputeTerrainDepth(0.0, maxHeight);
+			int highNoiseDepth = ComputeTerrainDepth(1.0, maxHeight);
+			int minTerrainDepth = std::min(lowNoiseDepth, highNoiseDepth);
+			int maxTerrainDepth = std::max(lowNoiseDepth, highNoiseDepth);
+
+			return blockDepth >= minTerrainDepth && blockDepth < maxTerrainDepth + int(ChunkSize);
+		};
+
+		bounds.surfaceFaces[Direction::Back] = CanReachSurface(maxHeight.z - firstBlock.z + 1, maxHeight.z);
+		bounds.surfaceFaces[Direction::Down] = CanReachSurface(maxHeight.y + lastBlock.y + 1, maxHeight.y);
+		bounds.surfaceFaces[Direction::Front] = CanReachSurface(maxHeight.z + lastBlock.z + 1, maxHeight.z);
+		bounds.surfaceFaces[Direction::Left] = CanReachSurface(maxHeight.x + lastBlock.x + 1, maxHeight.x);
+		bounds.surfaceFaces[Direction::Right] = CanReachSurface(maxHeight.x - firstBlock.x + 1, maxHeight.x);
+		bounds.surfaceFaces[Direction::Up] = CanReachSurface(maxHeight.y - firstBlock.y + 1, maxHeight.y);
+
+		return bounds;
+	}
+
+	// Depth at which the surface pass of a face starts carving, from the heightmap noise
+	int Planet::ComputeTerrainDepth(double noise, int maxHeight)
+	{
+		constexpr std::size_t freeSpace = TerrainFreeSpace;
+
+		// Planets smaller than twice the free space wrap the difference around (as unsigned), clamping the depth to half the planet height
+		double height = noise * TerrainHeightScale;
+		return std::round(std::min<double>(height * (maxHeight / 2 - freeSpace) + freeSpace, maxHeight / 2));
+	}
+
+	// Chunks of the column going through the surface pass of a face, which all acquire its heightmap
+	unsigned int Planet::CountSurfaceChunks(const ChunkIndices& chunkIndices, Direction face, const Nz::Vector3ui& chunkCount) const
+	{
+		std::size_t axis;
+		switch (face)
+		{
+			case Direction::Left:
+			case Direction::Right:
+				axis = 0;
+				break;
+
+			case Direction::Down:
+			case Direction::Up:
+				axis = 1;
+				break;
+
+			case Direction::Back:
+			case Direction::Front:
+			default:
+				axis = 2;
+				break;
+		}
+
+		ChunkIndices layerIndices = chunkIndices;
+
+		unsigned int surfaceChunkCount = 0;
+		for (unsigned int i = 0; i < chunkCount[axis]; ++i)
+		{
+			layerIndices[axis] = int(i) - int(chunkCount[axis] / 2);
+
+			ChunkGenerationBounds bounds = ComputeGenerationBounds(layerIndices, chunkCount);
+			if (!bounds.empty && bounds.surfaceFaces[face])
+				surfaceChunkCount++;
+		}
+
+		return surfaceChunkCount;
+	}
+
+	// Permutation tables only depend on the seed, build them once instead of for each chunk
+	auto Planet::GetTerrainNoise(Nz::UInt32 seed) -> std::shared_ptr<const TerrainNoise>
+	{
+		std::scoped_lock lock(m_terrainNoiseMutex);
+		if (!m_terrainNoise || m_terrainNoise->seed != seed)
+		{
+			std::shared_ptr<TerrainNoise> terrainNoise = std::make_shared<TerrainNoise>();
+			for (auto&& [dir, noise] : terrainNoise->faceNoises.iter_kv())
+				noise.Reseed(seed + static_cast<unsigned int>(dir));
+
+			terrainNoise->seed = seed;
+			m_terrainNoise = std::move(terrainNoise);
+
+			// Cached heightmaps come from the previous seed
+			m_heightmapCache.Clear();
+		}
+
+		return m_terrainNoise;
+	}
+
+	void Planet::NotifyNeighborUpdate(Chunk* chunk, Direction direction)
+	{
+		if (Chunk* neighbor = chunk->GetNeighborChunk(direction))
+			OnChunkNeighborUpdated(this, neighbor, OppositeDirection(direction));
 	}
 
 	void Planet::RemoveChunk(const ChunkIndices& indices)
@@ -440,7 +735,32 @@ namespace tsom
 		auto it = m_chunks.find(indices);
 		assert(it != m_chunks.end());
 
-		OnChunkRemove(this, it->second.chunk.get());
+		Chunk* chunk = it->second.chunk.get();
+		OnChunkRemove(this, chunk);
+
+		// Unlink neighbors one lock at a time, snapshots keep a chunk locked while grabbing its neighbors so they are not destroyed under them
+		Nz::EnumArray<Direction, Chunk*> neighbors;
+
+		chunk->LockWrite();
+		for (auto&& [direction, neighbor] : neighbors.iter_kv())
+		{
+			neighbor = chunk->GetNeighborChunk(direction);
+			chunk->SetNeighborChunk(direction, nullptr);
+		}
+		chunk->UnlockWrite();
+
+		for (auto&& [direction, neighbor] : neighbors.iter_kv())
+		{
+			if (!neighbor)
+				continue;
+
+			neighbor->LockWrite();
+			neighbor->SetNeighborChunk(OppositeDirection(direction), nullptr);
+			neighbor->UnlockWrite();
+
+			OnChunkNeighborUpdated(this, neighbor, OppositeDirection(direction));
+		}
+
 		m_chunks.erase(it);
 	}
 }
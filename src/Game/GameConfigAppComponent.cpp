@@ -23,6 +23,18 @@ namespace tsom
 		});
 
 		RegisterStringOption("Menu.ServerAddress", "tsom.digitalpulse.software");
+		RegisterBoolOption("Physics.SurfaceColliders", false);
+		RegisterBoolOption("Physics.ColliderResidency", false);
+		RegisterFloatOption("Physics.ColliderResidencyRadius", 8.0, 512.0, 48.0);
+		RegisterFloatOption("Physics.ColliderResidencyLookAhead", 0.0, 10.0, 1.0);
+		RegisterFloatOption("Physics.ColliderReleaseDelay", 0.0, 10.0 * 60.0, 5.0);
+		RegisterIntegerOption("Physics.ColliderShellThickness", 1, 8, 2);
+		RegisterFloatOption("Rendering.ChunkApplyBudget", 0.0, 1000.0, 4.0);
+		RegisterBoolOption("Rendering.DirectionCulling", true);
+		RegisterBoolOption("Rendering.OcclusionCulling", true);
+		RegisterBoolOption("Rendering.GreedyMeshing", true);
+		RegisterBoolOption("Rendering.LevelOfDetail", true);
+		RegisterFloatOption("Rendering.LevelOfDetailDistance", 32.0, 2048.0, 128.0);
 		RegisterIntegerOption("Server.Port", 1, 0xFFFF, 29536);
 	}
 
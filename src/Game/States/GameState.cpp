@@ -14,6 +14,7 @@
 #include <CommonLib/PlayerInputs.hpp>
 #include <CommonLib/Utils.hpp>
 #include <CommonLib/Components/PlanetGravityComponent.hpp>
+#include <Game/GameConfigAppComponent.hpp>
 #include <Game/States/ConnectionState.hpp>
 #include <Game/States/StateData.hpp>
 #include <Nazara/Core/ApplicationBase.hpp>
@@ -67,7 +68,7 @@ namespace tsom
 
 			auto& cameraComponent = m_cameraEntity.emplace<Nz::CameraComponent>(stateData.renderTarget, std::move(passList));
 			cameraComponent.UpdateClearColor(Nz::Color::Gray());
-			cameraComponent.UpdateRenderMask(tsom::Constants::RenderMask3D & ~tsom::Constants::RenderMaskLocalPlayer);
+			cameraComponent.UpdateRenderMask(tsom::Constants::RenderMask3D & ~(tsom::Constants::RenderMaskLocalPlayer | tsom::Constants::RenderMaskBackFacingChunk));
 			cameraComponent.UpdateZNear(0.1f);
 		}
 
@@ -172,11 +173,15 @@ namespace tsom
 		m_onChunkUpdate.Connect(stateData.sessionHandler->OnChunkUpdate, [&](const Packets::ChunkUpdate& chunkUpdate)
 		{
 			Chunk* chunk = m_planet->GetChunkByNetworkIndex(chunkUpdate.chunkId);
-			chunk->LockWrite();
+
+			std::vector<Chunk::BlockUpdate> blockUpdates;
+			blockUpdates.reserve(chunkUpdate.updates.size());
 
 			for (auto&& [blockPos, blockIndex] : chunkUpdate.updates)
-				chunk->UpdateBlock({ blockPos.x, blockPos.y, blockPos.z }, Nz::SafeCast<BlockIndex>(blockIndex));
+				blockUpdates.push_back({ Nz::Vector3ui(blockPos.x, blockPos.y, blockPos.z), Nz::SafeCast<BlockIndex>(blockIndex) });
 
+			chunk->LockWrite();
+			chunk->UpdateBlocks(blockUpdates);
 			chunk->UnlockWrite();
 		});
 
@@ -373,9 +378,9 @@ namespace tsom
 
 					auto& cameraComponent = m_cameraEntity.get<Nz::CameraComponent>();
 					if (m_isCameraThirdPerson)
-						cameraComponent.UpdateRenderMask(tsom::Constants::RenderMask3D);
+						cameraComponent.UpdateRenderMask(tsom::Constants::RenderMask3D & ~tsom::Constants::RenderMaskBackFacingChunk);
 					else
-						cameraComponent.UpdateRenderMask(tsom::Constants::RenderMask3D & ~tsom::Constants::RenderMaskLocalPlayer);
+						cameraComponent.UpdateRenderMask(tsom::Constants::RenderMask3D & ~(tsom::Constants::RenderMaskLocalPlayer | tsom::Constants::RenderMaskBackFacingChunk));
 					break;
 				}
 
@@ -460,7 +465,36 @@ namespace tsom
 
 		auto& stateData = GetStateData();
 
+		auto& gameConfig = stateData.app->GetComponent<GameConfigAppComponent>().GetConfig();
+
 		m_planetEntities = std::make_unique<ClientChunkEntities>(*stateData.app, *stateData.world, *m_planet, *stateData.blockLibrary);
+		m_planetEntities->EnableDirectionCulling(gameConfig.GetBoolValue("Rendering.DirectionCulling"));
+		m_planetEntities->EnableOcclusionCulling(gameConfig.GetBoolValue("Rendering.OcclusionCulling"));
+		m_planetEntities->EnableGreedyMeshing(gameConfig.GetBoolValue("Rendering.GreedyMeshing"));
+
+		ClientChunkEntities::LevelOfDetailSettings lodSettings;
+		lodSettings.enabled = gameConfig.GetBoolValue("Rendering.LevelOfDetail");
+		lodSettings.distance = gameConfig.GetFloatValue<float>("Rendering.LevelOfDetailDistance");
+		m_planetEntities->SetLevelOfDetailSettings(lodSettings);
+
+		Chunk::ColliderSettings colliderSettings;
+		colliderSettings.surfaceOnly = gameConfig.GetBoolValue("Physics.SurfaceColliders");
+		colliderSettings.shellThickness = gameConfig.GetIntegerValue<unsigned int>("Physics.ColliderShellThickness");
+		m_planetEntities->SetColliderSettings(colliderSettings);
+
+		ChunkEntities::ColliderResidencySettings colliderResidency;
+		colliderResidency.enabled = gameConfig.GetBoolValue("Physics.ColliderResidency");
+		colliderResidency.radius = gameConfig.GetFloatValue<float>("Physics.ColliderResidencyRadius");
+		colliderResidency.lookAhead = Nz::Time::Seconds(gameConfig.GetFloatValue<float>("Physics.ColliderResidencyLookAhead"));
+		colliderResidency.releaseDelay = Nz::Time::Seconds(gameConfig.GetFloatValue<float>("Physics.ColliderReleaseDelay"));
+		m_planetEntities->SetColliderResidencySettings(colliderResidency);
+
+		float chunkApplyBudget = gameConfig.GetFloatValue<float>("Rendering.ChunkApplyBudget"); //< milliseconds, zero for no budget
+
+		ChunkEntities::JobApplySettings jobApplySettings;
+		jobApplySettings.enabled = chunkApplyBudget > 0.f;
+		jobApplySettings.budget = Nz::Time::Seconds(chunkApplyBudget / 1000.f);
+		m_planetEntities->SetJobApplySettings(jobApplySettings);
 
 		m_remainingCameraRotation = Nz::EulerAnglesf(0.f, 0.f, 0.f);
 		m_predictedCameraRotation = m_remainingCameraRotation;
@@ -577,7 +611,9 @@ namespace tsom
 		if (m_debugOverlay)
 			m_debugOverlay->textDrawer.Clear();
 
-		m_planetEntities->Update();
+		Nz::Vector3f viewerPosition = m_cameraEntity.get<Nz::NodeComponent>().GetPosition();
+		m_planetEntities->UpdateLevelsOfDetail(viewerPosition);
+		m_planetEntities->Update({ &viewerPosition, 1 });
 
 		m_tickAccumulator += elapsedTime;
 		while (m_tickAccumulator >= m_tickDuration)
@@ -670,6 +706,22 @@ namespace tsom
 			}
 		}
 
+		// Camera is in place for this frame, skip buried chunks and chunk faces it can't see
+		m_planetEntities->UpdateOcclusionCulling(cameraNode.GetPosition());
+		m_planetEntities->UpdateDirectionCulling(cameraNode.GetPosition());
+
+		// Chunk stats
+		if (m_debugOverlay && m_debugOverlay->mode >= 3 && m_planetEntities)
+		{
+			m_debugOverlay->textDrawer.AppendText(fmt::format("{0:-^{1}}\n", "Chunks", 20));
+			m_debugOverlay->textDrawer.AppendText(fmt::format("Colliders: {0} hits / {1} misses\n", m_planetEntities->GetColliderCacheHitCount(), m_planetEntities->GetColliderCacheMissCount()));
+			m_debugOverlay->textDrawer.AppendText(fmt::format("Meshes: {0} hits / {1} misses\n", m_planetEntities->GetMeshCacheHitCount(), m_planetEntities->GetMeshCacheMissCount()));
+			m_debugOverlay->textDrawer.AppendText(fmt::format("Occluded chunks: {0}\n", m_planetEntities->GetOccludedChunkCount()));
+
+			const ChunkEntities::JobApplyStats& jobApplyStats = m_planetEntities->GetJobApplyStats();
+			m_debugOverlay->textDrawer.AppendText(fmt::format("Chunk jobs: {0} applied in {1:.2f}ms, {2} pending, {3} running ({4} tasks queued)\n", jobApplyStats.appliedJobCount, jobApplyStats.applyTime.AsSeconds<float>() * 1000.f, jobApplyStats.pendingJobCount, jobApplyStats.runningJobCount, jobApplyStats.queuedTaskCount));
+		}
+
 		// Raycast
 		{
 			auto& physSystem = stateData.world->GetSystem<Nz::Physics3DSystem>();
@@ -13,6 +13,16 @@ namespace tsom
 	{
 		RegisterIntegerOption("Server.Port", 1, 0xFFFF, 29536);
 		RegisterBoolOption("Server.SleepWhenEmpty", true);
+		RegisterBoolOption("Physics.SurfaceColliders", false);
+		RegisterBoolOption("Physics.ColliderResidency", false);
+		RegisterFloatOption("Physics.ColliderResidencyRadius", 8.0, 512.0, 48.0);
+		RegisterFloatOption("Physics.ColliderResidencyLookAhead", 0.0, 10.0, 1.0);
+		RegisterFloatOption("Physics.ColliderReleaseDelay", 0.0, 10.0 * 60.0, 5.0);
+		RegisterIntegerOption("Physics.ColliderShellThickness", 1, 8, 2);
+		RegisterFloatOption("Physics.ChunkApplyBudget", 0.0, 1000.0, 4.0);
+		RegisterBoolOption("Planet.StreamChunks", false);
+		RegisterFloatOption("Planet.StreamingRadius", 32.0, 4096.0, 160.0);
+		RegisterIntegerOption("Planet.StreamingRate", 1, 256, 4);
 		RegisterStringOption("Save.Directory", "saves/chunks");
 		RegisterIntegerOption("Save.Interval", 0, 60 * 60, 30);
 	}
@@ -33,6 +33,20 @@ int ServerMain(int argc, char* argv[])
 	instanceConfig.pauseWhenEmpty = config.GetBoolValue("Server.SleepWhenEmpty");
 	instanceConfig.saveDirectory = Nz::Utf8Path(config.GetStringValue("Save.Directory"));
 	instanceConfig.saveInterval = Nz::Time::Seconds(config.GetIntegerValue<long long>("Save.Interval"));
+	instanceConfig.chunkColliderSettings.surfaceOnly = config.GetBoolValue("Physics.SurfaceColliders");
+	instanceConfig.chunkColliderSettings.shellThickness = config.GetIntegerValue<unsigned int>("Physics.ColliderShellThickness");
+	instanceConfig.chunkColliderResidency.enabled = config.GetBoolValue("Physics.ColliderResidency");
+	instanceConfig.chunkColliderResidency.radius = config.GetFloatValue<float>("Physics.ColliderResidencyRadius");
+	instanceConfig.chunkColliderResidency.lookAhead = Nz::Time::Seconds(config.GetFloatValue<float>("Physics.ColliderResidencyLookAhead"));
+	instanceConfig.chunkColliderResidency.releaseDelay = Nz::Time::Seconds(config.GetFloatValue<float>("Physics.ColliderReleaseDelay"));
+
+	float chunkApplyBudget = config.GetFloatValue<float>("Physics.ChunkApplyBudget"); //< milliseconds, zero for no budget
+	instanceConfig.chunkJobApply.enabled = chunkApplyBudget > 0.f;
+	instanceConfig.chunkJobApply.budget = Nz::Time::Seconds(chunkApplyBudget / 1000.f);
+
+	instanceConfig.streamChunks = config.GetBoolValue("Planet.StreamChunks");
+	instanceConfig.chunkStreaming.viewRadius = config.GetFloatValue<float>("Planet.StreamingRadius");
+	instanceConfig.chunkStreaming.maxStartedChunks = config.GetIntegerValue<unsigned int>("Planet.StreamingRate"); //< chunks per tick
 
 	auto& instance = worldAppComponent.AddInstance(std::move(instanceConfig));
 	auto& sessionManager = instance.AddSessionManager(serverPort);
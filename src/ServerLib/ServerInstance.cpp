@@ -9,21 +9,25 @@
 #include <Nazara/Core/ApplicationBase.hpp>
 #include <Nazara/Core/File.hpp>
 #include <Nazara/Core/TaskSchedulerAppComponent.hpp>
+#include <Nazara/Core/Components/NodeComponent.hpp>
 #include <Nazara/Physics3D/Systems/Physics3DSystem.hpp>
 #include <NazaraUtils/PathUtils.hpp>
 #include <fmt/color.h>
 #include <fmt/format.h>
 #include <fmt/std.h>
+#include <array>
 #include <charconv>
 #include <cstdio>
 #include <memory>
 
 namespace tsom
 {
-	constexpr unsigned int chunkSaveVersion = 1;
+	// 2: chunks past the planet height are generated as free space (generator version 2)
+	constexpr unsigned int chunkSaveVersion = 2;
 
 	ServerInstance::ServerInstance(Nz::ApplicationBase& application, Config config) :
 	m_tickIndex(0),
+	m_saveVersion(chunkSaveVersion),
 	m_saveDirectory(std::move(config.saveDirectory)),
 	m_players(256),
 	m_tickAccumulator(Nz::Time::Zero()),
@@ -42,13 +46,57 @@ namespace tsom
 
 		auto& taskScheduler = m_application.GetComponent<Nz::TaskSchedulerAppComponent>();
 
+		constexpr std::array<std::pair<Direction, BlockIndices>, 4> platforms = {
+			std::pair{ Direction::Right, BlockIndices(65, -18, -39) },
+			std::pair{ Direction::Back,  BlockIndices(-34, 2, 53) },
+			std::pair{ Direction::Front, BlockIndices(22, -35, -59) },
+			std::pair{ Direction::Down,  BlockIndices(23, -62, 26) }
+		};
+
+		bool hasSave = UpgradeSave();
+
 		m_planet = std::make_unique<Planet>(1.f, 16.f, 9.81f);
-		m_planet->GenerateChunks(m_blockLibrary, taskScheduler, config.planetSeed, config.planetChunkCount);
-		LoadChunks();
-		m_planet->GeneratePlatform(m_blockLibrary, tsom::Direction::Right, { 65, -18, -39 });
-		m_planet->GeneratePlatform(m_blockLibrary, tsom::Direction::Back, { -34, 2, 53 });
-		m_planet->GeneratePlatform(m_blockLibrary, tsom::Direction::Front, { 22, -35, -59 });
-		m_planet->GeneratePlatform(m_blockLibrary, tsom::Direction::Down, { 23, -62, 26 });
+
+		// Chunks which were never saved are generated again on each startup, older saves keep the generator they were created with
+		m_planet->SetGeneratorVersion((m_saveVersion >= 2) ? 2 : 1);
+
+		if (config.streamChunks)
+		{
+			m_chunkStreamer = std::make_unique<ChunkStreamer>(*m_planet, m_blockLibrary, taskScheduler, config.planetSeed, config.planetChunkCount);
+			m_chunkStreamer->SetSettings(config.chunkStreaming);
+
+			if (hasSave)
+				m_chunkStreamer->SetLoadCallback([this](Chunk& chunk) { return LoadChunk(chunk); });
+
+			// Platforms are built on the terrain, which has to exist around them first
+			std::vector<ChunkIndices> platformChunks;
+			for (auto&& [upDirection, platformCenter] : platforms)
+			{
+				ChunkIndices centerChunkIndices = m_planet->GetChunkIndicesByBlockIndices(platformCenter);
+				for (int z = -1; z <= 1; ++z)
+				{
+					for (int y = -1; y <= 1; ++y)
+					{
+						for (int x = -1; x <= 1; ++x)
+							platformChunks.push_back(centerChunkIndices + ChunkIndices(x, y, z));
+					}
+				}
+			}
+
+			m_chunkStreamer->GenerateChunks(platformChunks);
+			fmt::print("streaming planet chunks: {0} generated around platforms\n", m_planet->GetChunkCount());
+		}
+		else
+		{
+			Planet::GenerationStats generationStats = m_planet->GenerateChunks(m_blockLibrary, taskScheduler, config.planetSeed, config.planetChunkCount);
+			fmt::print("generated planet chunks: {0} with surface, {1} layers only, {2} empty\n", generationStats.surfaceChunkCount, generationStats.layersOnlyChunkCount, generationStats.emptyChunkCount);
+
+			if (hasSave)
+				LoadChunks();
+		}
+
+		for (auto&& [upDirection, platformCenter] : platforms)
+			m_planet->GeneratePlatform(m_blockLibrary, upDirection, platformCenter);
 
 		m_planet->OnChunkUpdated.Connect([this](ChunkContainer* /*planet*/, Chunk* chunk)
 		{
@@ -56,10 +104,16 @@ namespace tsom
 		});
 
 		m_planetEntities = std::make_unique<ChunkEntities>(m_application, m_world, *m_planet, m_blockLibrary);
+		m_planetEntities->SetColliderSettings(config.chunkColliderSettings);
+		m_planetEntities->SetColliderResidencySettings(config.chunkColliderResidency);
+		m_planetEntities->SetJobApplySettings(config.chunkJobApply);
 	}
 
 	ServerInstance::~ServerInstance()
 	{
+		// Chunks being generated use the planet and the block library
+		m_chunkStreamer.reset();
+
 		OnSave();
 
 		m_sessionManagers.clear();
@@ -89,12 +143,15 @@ namespace tsom
 
 		m_newPlayers.UnboundedSet(playerIndex);
 
-		// Send all chunks
-		auto& playerVisibility = player->GetVisibilityHandler();
-		m_planet->ForEachChunk([&](const ChunkIndices& chunkIndices, const Chunk& chunk)
+		// Send all chunks, streamed chunks are sent as they come into the player view radius (see UpdateChunkVisibility)
+		if (!m_chunkStreamer)
 		{
-			playerVisibility.CreateChunk(chunk);
-		});
+			auto& playerVisibility = player->GetVisibilityHandler();
+			m_planet->ForEachChunk([&](const ChunkIndices& chunkIndices, const Chunk& chunk)
+			{
+				playerVisibility.CreateChunk(chunk);
+			});
+		}
 
 		return player;
 	}
@@ -133,12 +190,43 @@ namespace tsom
 		return m_tickDuration - m_tickAccumulator;
 	}
 
+	// Called from worker threads when streaming chunks
+	bool ServerInstance::LoadChunk(Chunk& chunk)
+	{
+		const ChunkIndices& chunkIndices = chunk.GetIndices();
+
+		Nz::File chunkFile(m_saveDirectory / Nz::Utf8Path(fmt::format("{0:+}_{1:+}_{2:+}.chunk", chunkIndices.x, chunkIndices.y, chunkIndices.z)), Nz::OpenMode::Read);
+		if (!chunkFile.IsOpen())
+			return false;
+
+		try
+		{
+			Nz::ByteStream fileStream(&chunkFile);
+			chunk.Unserialize(m_blockLibrary, fileStream);
+		}
+		catch (const std::exception& e)
+		{
+			fmt::print(stderr, fg(fmt::color::red), "failed to load chunk {}: {}\n", fmt::streamed(chunkIndices), e.what());
+			return false;
+		}
+
+		return true;
+	}
+
 	void ServerInstance::LoadChunks()
+	{
+		m_planet->ForEachChunk([&](const ChunkIndices& /*chunkIndices*/, Chunk& chunk)
+		{
+			LoadChunk(chunk);
+		});
+	}
+
+	bool ServerInstance::UpgradeSave()
 	{
 		if (!std::filesystem::is_directory(m_saveDirectory))
 		{
 			fmt::print("save directory {0} doesn't exist, not loading chunks\n", m_saveDirectory);
-			return;
+			return false;
 		}
 
 		// Handle conversion
@@ -152,13 +240,13 @@ namespace tsom
 				if (auto err = std::from_chars(ptr, ptr + contentOpt->size(), saveVersion); err.ec != std::errc{})
 				{
 					fmt::print(stderr, fg(fmt::color::red), "failed to load planet: invalid version file (not a number)\n");
-					return;
+					return false;
 				}
 
 				if (saveVersion > chunkSaveVersion)
 				{
 					fmt::print(stderr, fg(fmt::color::red), "failed to load planet: unknown save version {0}\n", saveVersion);
-					return;
+					return false;
 				}
 			}
 			else
@@ -206,22 +294,10 @@ namespace tsom
 			Nz::File::WriteWhole(m_saveDirectory / Nz::Utf8Path("version.txt"), version.data(), version.size());
 		}
 
-		m_planet->ForEachChunk([&](const ChunkIndices& chunkIndices, Chunk& chunk)
-		{
-			Nz::File chunkFile(m_saveDirectory / Nz::Utf8Path(fmt::format("{0:+}_{1:+}_{2:+}.chunk", chunkIndices.x, chunkIndices.y, chunkIndices.z)), Nz::OpenMode::Read);
-			if (!chunkFile.IsOpen())
-				return;
+		// Version 2 only changed how chunks are generated, older saves can't be converted and stay at their version
+		m_saveVersion = saveVersion;
 
-			try
-			{
-				Nz::ByteStream fileStream(&chunkFile);
-				chunk.Unserialize(m_blockLibrary, fileStream);
-			}
-			catch (const std::exception& e)
-			{
-				fmt::print(stderr, fg(fmt::color::red), "failed to load chunk {}: {}\n", fmt::streamed(chunkIndices), e.what());
-			}
-		});
+		return true;
 	}
 
 	void ServerInstance::OnNetworkTick()
@@ -293,7 +369,21 @@ namespace tsom
 			serverPlayer.Tick();
 		});
 
-		m_planetEntities->Update();
+		// Chunks closest to players are generated and get their collider first
+		std::vector<Nz::Vector3f> playerPositions;
+		ForEachPlayer([&](ServerPlayer& serverPlayer)
+		{
+			if (entt::handle controlledEntity = serverPlayer.GetControlledEntity())
+				playerPositions.push_back(controlledEntity.get<Nz::NodeComponent>().GetPosition());
+		});
+
+		if (m_chunkStreamer)
+		{
+			m_chunkStreamer->Update(playerPositions);
+			UpdateChunkVisibility();
+		}
+
+		m_planetEntities->Update(playerPositions);
 
 		m_world.Update(elapsedTime);
 
@@ -323,7 +413,35 @@ namespace tsom
 		}
 		m_dirtyChunks.clear();
 
-		std::string version = std::to_string(chunkSaveVersion);
+		std::string version = std::to_string(m_saveVersion);
 		Nz::File::WriteWhole(m_saveDirectory / Nz::Utf8Path("version.txt"), version.data(), version.size());
 	}
+
+	void ServerInstance::UpdateChunkVisibility()
+	{
+		// Players only know about streamed chunks within the view radius the streamer generates chunks for,
+		// chunks are hidden a chunk further away so that players moving along the border don't keep receiving them
+		float hideMargin = Planet::ChunkSize * m_planet->GetTileSize();
+
+		ForEachPlayer([&](ServerPlayer& serverPlayer)
+		{
+			entt::handle controlledEntity = serverPlayer.GetControlledEntity();
+			if (!controlledEntity)
+				return;
+
+			Nz::Vector3f playerPosition = controlledEntity.get<Nz::NodeComponent>().GetPosition();
+
+			auto& playerVisibility = serverPlayer.GetVisibilityHandler();
+			m_planet->ForEachChunk([&](const ChunkIndices& chunkIndices, const Chunk& chunk)
+			{
+				if (playerVisibility.IsChunkVisible(chunk))
+				{
+					if (!m_chunkStreamer->IsInViewRadius(chunkIndices, playerPosition, hideMargin))
+						playerVisibility.DestroyChunk(chunk);
+				}
+				else if (m_chunkStreamer->IsInViewRadius(chunkIndices, playerPosition))
+					playerVisibility.CreateChunk(chunk);
+			});
+		});
+	}
 }
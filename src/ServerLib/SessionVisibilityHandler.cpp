@@ -49,8 +49,15 @@ namespace tsom
 		std::size_t chunkIndex = Nz::Retrieve(m_chunkIndices, &chunk);
 
 		// Is this a newly visible chunk not sent to the client?
-		if (m_newlyVisibleChunk.Test(chunkIndex))
-			m_newlyVisibleChunk.Reset(chunkIndex); //< dismiss it
+		if (m_newlyVisibleChunk.UnboundedTest(chunkIndex))
+		{
+			// dismiss it, client never heard of it
+			m_newlyVisibleChunk.Reset(chunkIndex);
+			m_freeChunkIds.Set(chunkIndex);
+			m_chunkIndices.erase(&chunk);
+			m_visibleChunks[chunkIndex].chunk = nullptr;
+			return;
+		}
 
 		m_newlyHiddenChunk.UnboundedSet(chunkIndex);
 	}
@@ -84,6 +91,16 @@ namespace tsom
 		return m_visibleChunks[chunkIndex].chunk;
 	}
 
+	bool SessionVisibilityHandler::IsChunkVisible(const Chunk& chunk) const
+	{
+		auto it = m_chunkIndices.find(&chunk);
+		if (it == m_chunkIndices.end())
+			return false;
+
+		// Chunks marked for destruction can still be resurrected by CreateChunk
+		return !m_newlyHiddenChunk.UnboundedTest(it->second);
+	}
+
 	void SessionVisibilityHandler::DispatchChunks()
 	{
 		for (std::size_t chunkIndex = m_newlyHiddenChunk.FindFirst(); chunkIndex != m_newlyHiddenChunk.npos; chunkIndex = m_newlyHiddenChunk.FindNext(chunkIndex))
@@ -94,8 +111,10 @@ namespace tsom
 			m_updatedChunk.UnboundedReset(chunkIndex);
 
 			VisibleChunk& visibleChunk = m_visibleChunks[chunkIndex];
+			m_chunkIndices.erase(visibleChunk.chunk);
 			visibleChunk.chunk = nullptr;
-			visibleChunk.onBlockUpdatedSlot.Disconnect();
+			visibleChunk.onBlocksUpdatedSlot.Disconnect();
+			visibleChunk.onResetSlot.Disconnect();
 
 			Packets::ChunkDestroy chunkDestroyPacket;
 			chunkDestroyPacket.chunkId = Nz::SafeCast<Packets::Helper::ChunkId>(chunkIndex);
@@ -126,7 +145,7 @@ namespace tsom
 			VisibleChunk& visibleChunk = m_visibleChunks[chunkIndex];
 
 			// Connect update signal on dispatch to prevent updates made during the same tick to be sent as update
-			visibleChunk.onBlockUpdatedSlot.Connect(visibleChunk.chunk->OnBlockUpdated, [this, chunkIndex]([[maybe_unused]] Chunk* chunk, const Nz::Vector3ui& indices, BlockIndex newBlock)
+			visibleChunk.onBlocksUpdatedSlot.Connect(visibleChunk.chunk->OnBlocksUpdated, [this, chunkIndex]([[maybe_unused]] Chunk* chunk, std::span<const Chunk::BlockUpdate> updates)
 			{
 				m_updatedChunk.UnboundedSet(chunkIndex);
 
@@ -142,16 +161,21 @@ namespace tsom
 					return Nz::Vector3ui(blockUpdate.voxelLoc.x, blockUpdate.voxelLoc.y, blockUpdate.voxelLoc.z) < indices;
 				};
 
-				auto it = std::lower_bound(visibleChunk.chunkUpdatePacket.updates.begin(), visibleChunk.chunkUpdatePacket.updates.end(), indices, comp);
-				if (it == visibleChunk.chunkUpdatePacket.updates.end() || Nz::Vector3ui(it->voxelLoc.x, it->voxelLoc.y, it->voxelLoc.z) != indices)
+				for (const Chunk::BlockUpdate& update : updates)
 				{
-					visibleChunk.chunkUpdatePacket.updates.insert(it, {
-						Packets::Helper::VoxelLocation{ Nz::SafeCast<Nz::UInt8>(indices.x), Nz::SafeCast<Nz::UInt8>(indices.y), Nz::SafeCast<Nz::UInt8>(indices.z) },
-						Nz::SafeCast<Nz::UInt8>(newBlock)
-					});
+					const Nz::Vector3ui& indices = update.indices;
+
+					auto it = std::lower_bound(visibleChunk.chunkUpdatePacket.updates.begin(), visibleChunk.chunkUpdatePacket.updates.end(), indices, comp);
+					if (it == visibleChunk.chunkUpdatePacket.updates.end() || Nz::Vector3ui(it->voxelLoc.x, it->voxelLoc.y, it->voxelLoc.z) != indices)
+					{
+						visibleChunk.chunkUpdatePacket.updates.insert(it, {
+							Packets::Helper::VoxelLocation{ Nz::SafeCast<Nz::UInt8>(indices.x), Nz::SafeCast<Nz::UInt8>(indices.y), Nz::SafeCast<Nz::UInt8>(indices.z) },
+							Nz::SafeCast<Nz::UInt8>(update.newBlock)
+						});
+					}
+					else
+						it->newContent = Nz::SafeCast<Nz::UInt8>(update.newBlock);
 				}
-				else
-					it->newContent = Nz::SafeCast<Nz::UInt8>(newBlock);
 			});
 
 			visibleChunk.onResetSlot.Connect(visibleChunk.chunk->OnReset, [this, chunkIndex](Chunk*)
@@ -217,8 +241,7 @@ namespace tsom
 			unsigned int blockCount = chunkSize.x * chunkSize.y * chunkSize.z;
 			chunkResetPacket.content.resize(blockCount);
 
-			const BlockIndex* chunkContent = visibleChunk.chunk->GetContent();
-			std::memcpy(chunkResetPacket.content.data(), chunkContent, blockCount * sizeof(BlockIndex));
+			visibleChunk.chunk->CopyContent(chunkResetPacket.content.data());
 
 			(*m_activeChunkUpdates)++;
 			m_networkSession->SendPacket(chunkResetPacket, [chunkLocation, chunkUpdateCount = m_activeChunkUpdates]
@@ -0,0 +1,44 @@
+#include <CommonLib/BatchPerlinNoise.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <PerlinNoise.hpp>
+#include <vector>
+
+using namespace tsom;
+
+TEST_CASE("Batch Perlin noise", "[Generation]")
+{
+	// Existing worlds have to generate the same terrain, results have to match siv::PerlinNoise exactly
+	for (Nz::UInt32 seed : { 0u, 42u, 0xDEADBEEFu })
+	{
+		siv::PerlinNoise referenceNoise(seed);
+		BatchPerlinNoise batchNoise(seed);
+		CHECK(batchNoise.GetPermutation() == referenceNoise.serialize());
+
+		// Row width not being a multiple of the lane count, with negative coordinates and coordinates past the 256 cells period
+		std::vector<double> xValues;
+		for (int x = -150; x < -150 + 37; ++x)
+			xValues.push_back(x * 0.02);
+
+		std::vector<double> yValues;
+		for (int y = 12790; y < 12790 + 11; ++y)
+			yValues.push_back(y * 0.02);
+
+		for (Nz::UInt32 octaves : { 1u, 4u })
+		{
+			std::vector<double> results(xValues.size() * yValues.size());
+			batchNoise.ComputeNormalizedOctave2D(xValues, yValues, octaves, results.data());
+
+			std::size_t mismatchCount = 0;
+			for (std::size_t y = 0; y < yValues.size(); ++y)
+			{
+				for (std::size_t x = 0; x < xValues.size(); ++x)
+				{
+					if (results[y * xValues.size() + x] != referenceNoise.normalizedOctave2D_01(xValues[x], yValues[y], octaves))
+						mismatchCount++;
+				}
+			}
+
+			CHECK(mismatchCount == 0);
+		}
+	}
+}
@@ -0,0 +1,141 @@
+#include <CommonLib/BlockStorage.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+
+using namespace tsom;
+
+TEST_CASE("Block storage", "[Chunks]")
+{
+	constexpr std::size_t BlockCount = 32 * 32 * 32;
+
+	BlockStorage storage(BlockCount);
+	CHECK(storage.IsUniform());
+	CHECK(storage.GetBitsPerBlock() == 0);
+	CHECK(storage.GetBlock(BlockCount - 1) == EmptyBlockIndex);
+	CHECK(storage.GetBlockTypeCount(EmptyBlockIndex) == BlockCount);
+
+	SECTION("Palette grows and shrinks with block types")
+	{
+		std::vector<BlockIndex> expectedBlocks(BlockCount, EmptyBlockIndex);
+
+		auto CheckContent = [&]
+		{
+			for (std::size_t i = 0; i < BlockCount; ++i)
+			{
+				if (storage.GetBlock(i) != expectedBlocks[i])
+				{
+					INFO("block #" << i);
+					CHECK(storage.GetBlock(i) == expectedBlocks[i]);
+					break;
+				}
+			}
+		};
+
+		for (BlockIndex i = 1; i < 4; ++i)
+		{
+			storage.UpdateBlock(i, i);
+			expectedBlocks[i] = i;
+		}
+		CHECK(storage.GetBitsPerBlock() == 2);
+		CheckContent();
+
+		std::minstd_rand rand(42);
+		for (std::size_t i = 0; i < 10'000; ++i)
+		{
+			std::size_t blockIndex = rand() % BlockCount;
+			BlockIndex blockType = static_cast<BlockIndex>(rand() % 200);
+
+			storage.UpdateBlock(blockIndex, blockType);
+			expectedBlocks[blockIndex] = blockType;
+		}
+		CHECK(storage.GetBitsPerBlock() == 8);
+		CheckContent();
+
+		for (std::size_t i = 0; i < BlockCount; ++i)
+		{
+			if (expectedBlocks[i] > 1)
+			{
+				storage.UpdateBlock(i, 1);
+				expectedBlocks[i] = 1;
+			}
+		}
+		CHECK(storage.GetBitsPerBlock() == 1);
+		CHECK(storage.GetUsedPaletteEntryCount() == 2);
+		CheckContent();
+
+		for (std::size_t i = 0; i < BlockCount; ++i)
+		{
+			storage.UpdateBlock(i, 1);
+			expectedBlocks[i] = 1;
+		}
+		CHECK(storage.IsUniform());
+		CHECK(storage.GetUsedPaletteEntryCount() == 1);
+		CheckContent();
+
+		storage.UpdateBlock(42, 3);
+		expectedBlocks[42] = 3;
+		CHECK_FALSE(storage.IsUniform());
+		CHECK(storage.GetBitsPerBlock() == 1);
+		CheckContent();
+	}
+
+	SECTION("Loading and storing content")
+	{
+		std::vector<BlockIndex> blocks(BlockCount);
+		for (std::size_t i = 0; i < BlockCount; ++i)
+			blocks[i] = static_cast<BlockIndex>(i % 300);
+
+		storage.Load(blocks.data());
+		CHECK(storage.GetBitsPerBlock() == 16);
+		CHECK(storage.GetUsedPaletteEntryCount() == 300);
+
+		std::vector<BlockIndex> storedBlocks(BlockCount);
+		storage.Store(storedBlocks.data());
+		CHECK(storedBlocks == blocks);
+
+		storage.Fill(7);
+		CHECK(storage.IsUniform());
+		CHECK(storage.GetBlock(BlockCount - 1) == 7);
+		CHECK(storage.GetBlockTypeCount(7) == BlockCount);
+
+		std::vector<BlockIndex> uniformBlocks(BlockCount, 5);
+		storage.Load(uniformBlocks.data());
+		CHECK(storage.IsUniform());
+
+		storage.Store(storedBlocks.data());
+		CHECK(storedBlocks == uniformBlocks);
+	}
+
+	SECTION("Content hash only depends on blocks")
+	{
+		Nz::UInt64 emptyHash = storage.ComputeContentHash();
+
+		// Placing then removing blocks gets back to the same hash
+		storage.UpdateBlock(42, 3);
+		Nz::UInt64 hash = storage.ComputeContentHash();
+		CHECK(hash != emptyHash);
+
+		storage.UpdateBlock(43, 4);
+		CHECK(storage.ComputeContentHash() != hash);
+
+		storage.UpdateBlock(43, EmptyBlockIndex);
+		CHECK(storage.ComputeContentHash() == hash);
+
+		storage.UpdateBlock(42, EmptyBlockIndex);
+		CHECK(storage.ComputeContentHash() == emptyHash);
+
+		// Same blocks, different palette order
+		std::vector<BlockIndex> blocks(BlockCount, 1);
+		blocks[0] = 2;
+
+		BlockStorage loadedStorage(BlockCount);
+		loadedStorage.Load(blocks.data());
+
+		BlockStorage updatedStorage(BlockCount, 2);
+		for (std::size_t i = 1; i < BlockCount; ++i)
+			updatedStorage.UpdateBlock(i, 1);
+
+		CHECK(loadedStorage.ComputeContentHash() == updatedStorage.ComputeContentHash());
+		CHECK(BlockStorage(BlockCount / 2, 1).ComputeContentHash() != BlockStorage(BlockCount, 1).ComputeContentHash());
+	}
+}
@@ -0,0 +1,136 @@
+#include "GroundChunk.hpp"
+#include <CommonLib/BlockLibrary.hpp>
+#include <CommonLib/ChunkColliderCache.hpp>
+#include <CommonLib/Planet.hpp>
+#include <Nazara/Physics3D/Collider3D.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+using namespace tsom;
+
+TEST_CASE("Chunk collider cache", "[Chunks]")
+{
+	BlockLibrary blockLibrary;
+	BlockIndex dirtBlock = blockLibrary.GetBlockIndex("dirt");
+
+	Planet planet(1.f, 0.f, 9.81f);
+
+	Chunk& chunk = AddGroundChunk(planet, { 0, 0, 0 }, dirtBlock);
+
+	using Box = std::tuple<float, float, float, float, float, float>;
+
+	auto CollectBoxes = [](const std::shared_ptr<Nz::Collider3D>& collider)
+	{
+		std::vector<Box> boxes;
+		auto AddBox = [&](const Nz::Collider3D& boxCollider, const Nz::Vector3f& offset)
+		{
+			const auto* box = dynamic_cast<const Nz::BoxCollider3D*>(&boxCollider);
+			REQUIRE(box);
+
+			Nz::Vector3f lengths = box->GetLengths();
+			boxes.emplace_back(offset.x, offset.y, offset.z, lengths.x, lengths.y, lengths.z);
+		};
+
+		REQUIRE(collider);
+		if (const auto* compound = dynamic_cast<const Nz::CompoundCollider3D*>(collider.get()))
+		{
+			// Brick colliders are flattened into a single compound
+			for (const auto& childCollider : compound->GetGeoms())
+			{
+				CHECK_FALSE(dynamic_cast<const Nz::CompoundCollider3D*>(childCollider.collider.get()));
+				AddBox(*childCollider.collider, childCollider.offset);
+			}
+		}
+		else
+			AddBox(*collider, Nz::Vector3f::Zero());
+
+		std::sort(boxes.begin(), boxes.end());
+		return boxes;
+	};
+
+	auto TestEdit = [&](const Chunk::ColliderSettings& settings, std::size_t expectedRebuiltBrickCount)
+	{
+		ChunkColliderCache previousCache(settings);
+		std::shared_ptr<Nz::Collider3D> previousCollider = previousCache.Build(blockLibrary, chunk, chunk.TakeSnapshot(), nullptr);
+		CHECK(previousCache.GetRebuiltBrickCount() == previousCache.GetBricks().size());
+
+		// Dig a block on the surface, in brick (0, 0, 1)
+		chunk.LockWrite();
+		chunk.UpdateBlock({ 3, 3, GroundHeight - 1 }, EmptyBlockIndex);
+		chunk.UnlockWrite();
+
+		ChunkSnapshot snapshot = chunk.TakeSnapshot();
+
+		ChunkColliderCache colliderCache(settings);
+		std::shared_ptr<Nz::Collider3D> collider = colliderCache.Build(blockLibrary, chunk, snapshot, &previousCache);
+		CHECK(colliderCache.GetRebuiltBrickCount() == expectedRebuiltBrickCount);
+
+		// Bricks which weren't rebuilt share their shapes with the previous collider
+		const auto& previousBricks = previousCache.GetBricks();
+		const auto& bricks = colliderCache.GetBricks();
+		REQUIRE(bricks.size() == previousBricks.size());
+
+		std::size_t sharedBrickCount = 0;
+		std::size_t newBrickCount = 0;
+		for (std::size_t i = 0; i < bricks.size(); ++i)
+		{
+			if (bricks[i].childColliders.empty())
+				continue;
+
+			if (!previousBricks[i].childColliders.empty() && bricks[i].childColliders.front().collider == previousBricks[i].childColliders.front().collider)
+				sharedBrickCount++;
+			else
+				newBrickCount++;
+		}
+		CHECK(sharedBrickCount > 0);
+		CHECK(newBrickCount > 0);
+		CHECK(newBrickCount <= expectedRebuiltBrickCount);
+
+		// Incremental collider is the same as a full rebuild
+		ChunkColliderCache fullCache(settings);
+		std::shared_ptr<Nz::Collider3D> fullCollider = fullCache.Build(blockLibrary, chunk, snapshot, nullptr);
+		CHECK(CollectBoxes(collider) == CollectBoxes(fullCollider));
+
+		// Restore the block for the next test
+		chunk.LockWrite();
+		chunk.UpdateBlock({ 3, 3, GroundHeight - 1 }, dirtBlock);
+		chunk.UnlockWrite();
+	};
+
+	SECTION("Only the edited brick is rebuilt when colliders cover every block")
+	{
+		Chunk::ColliderSettings settings;
+		settings.surfaceOnly = false;
+
+		TestEdit(settings, 1);
+	}
+
+	SECTION("Surface-only colliders rebuild bricks exposed to the edited brick")
+	{
+		Chunk::ColliderSettings settings;
+		settings.surfaceOnly = true;
+
+		// Edited brick and its direct neighbors
+		settings.shellThickness = 1;
+		TestEdit(settings, 5);
+
+		// Thicker shells reach diagonal neighbors too
+		settings.shellThickness = 2;
+		TestEdit(settings, 12);
+	}
+
+	SECTION("Uniform chunks are covered by a single box")
+	{
+		chunk.Fill(dirtBlock);
+
+		ChunkColliderCache colliderCache(Chunk::ColliderSettings{});
+		std::shared_ptr<Nz::Collider3D> collider = colliderCache.Build(blockLibrary, chunk, chunk.TakeSnapshot(), nullptr);
+		CHECK(colliderCache.IsEmpty());
+
+		const auto* box = dynamic_cast<const Nz::BoxCollider3D*>(collider.get());
+		REQUIRE(box);
+		CHECK(box->GetLengths() == Nz::Vector3f(Planet::ChunkSize));
+	}
+}
@@ -0,0 +1,109 @@
+#include <CommonLib/ChunkColliderResidency.hpp>
+#include <CommonLib/Planet.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <vector>
+
+using namespace tsom;
+
+TEST_CASE("Chunk collider residency", "[Physics]")
+{
+	// Chunks are 32 units wide, chunk (0, 0, 0) spans from -16 to 16
+	Planet planet(1.f, 0.f, 9.81f);
+	for (int x = -1; x <= 2; ++x)
+		planet.AddChunk({ x, 0, 0 });
+
+	ChunkColliderResidency::Settings settings;
+	settings.enabled = true;
+	settings.lookAhead = Nz::Time::Second();
+	settings.radius = 8.f;
+	settings.releaseDelay = Nz::Time::Seconds(5);
+
+	auto RequestedChunks = [&](const Nz::Vector3f& position, const Nz::Vector3f& linearVelocity)
+	{
+		std::vector<ChunkIndices> chunks;
+		ChunkColliderResidency::ForEachRequestedChunk(planet, settings, position, linearVelocity, [&](const ChunkIndices& chunkIndices)
+		{
+			chunks.push_back(chunkIndices);
+		});
+
+		std::sort(chunks.begin(), chunks.end(), [](const ChunkIndices& lhs, const ChunkIndices& rhs) { return lhs.x < rhs.x; });
+		return chunks;
+	};
+
+	SECTION("Chunks are selected by distance and look-ahead")
+	{
+		// Chunks are only requested when their bounds are within the radius
+		CHECK((RequestedChunks({ 0.f, 0.f, 0.f }, Nz::Vector3f::Zero()) == std::vector<ChunkIndices>{ { 0, 0, 0 } }));
+		CHECK((RequestedChunks({ 10.f, 0.f, 0.f }, Nz::Vector3f::Zero()) == std::vector<ChunkIndices>{ { 0, 0, 0 }, { 1, 0, 0 } }));
+
+		// Chunks around where the body will be are also requested
+		CHECK((RequestedChunks({ 0.f, 0.f, 0.f }, Nz::Vector3f(64.f, 0.f, 0.f)) == std::vector<ChunkIndices>{ { 0, 0, 0 }, { 2, 0, 0 } }));
+
+		// Slow bodies don't look ahead
+		CHECK((RequestedChunks({ 0.f, 0.f, 0.f }, Nz::Vector3f(4.f, 0.f, 0.f)) == std::vector<ChunkIndices>{ { 0, 0, 0 } }));
+
+		// Look-ahead can be disabled
+		settings.lookAhead = Nz::Time::Zero();
+		CHECK((RequestedChunks({ 0.f, 0.f, 0.f }, Nz::Vector3f(64.f, 0.f, 0.f)) == std::vector<ChunkIndices>{ { 0, 0, 0 } }));
+
+		// Missing chunks are never requested
+		CHECK(RequestedChunks({ 0.f, 40.f, 0.f }, Nz::Vector3f::Zero()).empty());
+	}
+
+	SECTION("Chunks acquire their collider once and release it after a delay")
+	{
+		ChunkColliderResidency residency;
+		residency.SetSettings(settings);
+
+		std::vector<ChunkIndices> acquiredChunks;
+		auto Acquire = [&](const ChunkIndices& chunkIndices)
+		{
+			acquiredChunks.push_back(chunkIndices);
+		};
+
+		std::vector<ChunkIndices> releasedChunks;
+		auto Release = [&](const ChunkIndices& chunkIndices)
+		{
+			releasedChunks.push_back(chunkIndices);
+		};
+
+		CHECK_FALSE(residency.IsResident({ 0, 0, 0 }));
+
+		residency.RequestChunks(planet, { 0.f, 0.f, 0.f }, Nz::Vector3f::Zero(), Nz::Time::Zero(), Acquire);
+		CHECK((acquiredChunks == std::vector<ChunkIndices>{ { 0, 0, 0 } }));
+		CHECK(residency.IsResident({ 0, 0, 0 }));
+
+		// Requesting a resident chunk again only refreshes it
+		residency.RequestChunks(planet, { 0.f, 0.f, 0.f }, Nz::Vector3f::Zero(), Nz::Time::Second(), Acquire);
+		CHECK(acquiredChunks.size() == 1);
+
+		// Body moves to the next chunk, the previous chunk is kept until the release delay is over
+		residency.RequestChunks(planet, { 32.f, 0.f, 0.f }, Nz::Vector3f::Zero(), Nz::Time::Seconds(2), Acquire);
+		CHECK((acquiredChunks == std::vector<ChunkIndices>{ { 0, 0, 0 }, { 1, 0, 0 } }));
+
+		residency.ReleaseExpiredChunks(Nz::Time::Seconds(5), Release);
+		CHECK(releasedChunks.empty());
+		CHECK(residency.GetResidentChunkCount() == 2);
+
+		residency.ReleaseExpiredChunks(Nz::Time::Seconds(6), Release);
+		CHECK((releasedChunks == std::vector<ChunkIndices>{ { 0, 0, 0 } }));
+		CHECK_FALSE(residency.IsResident({ 0, 0, 0 }));
+		CHECK(residency.IsResident({ 1, 0, 0 }));
+
+		// Coming back acquires the collider again
+		residency.RequestChunks(planet, { 0.f, 0.f, 0.f }, Nz::Vector3f::Zero(), Nz::Time::Seconds(7), Acquire);
+		CHECK((acquiredChunks == std::vector<ChunkIndices>{ { 0, 0, 0 }, { 1, 0, 0 }, { 0, 0, 0 } }));
+
+		residency.ReleaseExpiredChunks(Nz::Time::Seconds(100), Release);
+		CHECK(releasedChunks.size() == 3);
+		CHECK(residency.GetResidentChunkCount() == 0);
+	}
+
+	SECTION("Every chunk is resident when residency is disabled")
+	{
+		ChunkColliderResidency residency;
+		CHECK(residency.IsResident({ 0, 0, 0 }));
+		CHECK(residency.IsResident({ 42, 0, 0 }));
+	}
+}
@@ -0,0 +1,140 @@
+#include <CommonLib/BlockStorage.hpp>
+#include <CommonLib/ChunkConnectivity.hpp>
+#include <CommonLib/ChunkOccupancy.hpp>
+#include <CommonLib/ChunkVisibility.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <tsl/hopscotch_map.h>
+
+using namespace tsom;
+
+TEST_CASE("Chunk connectivity", "[Chunks]")
+{
+	Nz::Vector3ui size(32, 32, 32);
+	ChunkOccupancy occupancy(size);
+
+	ChunkConnectivity connectivity;
+	CHECK(connectivity.IsSealed());
+
+	connectivity.Reset(occupancy);
+	CHECK(connectivity.IsFullyConnected());
+
+	SECTION("Solid slab")
+	{
+		// Block (x, y, z) is positioned at (x, z, y), the slab splits the chunk between up and down
+		for (unsigned int z = 10; z < 12; ++z)
+		{
+			for (unsigned int y = 0; y < size.y; ++y)
+			{
+				for (unsigned int x = 0; x < size.x; ++x)
+					occupancy.Set({ x, y, z }, true);
+			}
+		}
+
+		connectivity.Reset(occupancy);
+		CHECK_FALSE(connectivity.AreConnected(Direction::Up, Direction::Down));
+		CHECK(connectivity.AreConnected(Direction::Up, Direction::Left));
+		CHECK(connectivity.AreConnected(Direction::Down, Direction::Front));
+		CHECK(connectivity.AreConnected(Direction::Left, Direction::Right));
+		CHECK(connectivity.AreConnected(Direction::Right, Direction::Left));
+
+		// A single hole is enough to connect both sides
+		occupancy.Set({ 5, 7, 10 }, false);
+		occupancy.Set({ 5, 7, 11 }, false);
+
+		connectivity.Reset(occupancy);
+		CHECK(connectivity.AreConnected(Direction::Up, Direction::Down));
+	}
+
+	SECTION("Solid chunk")
+	{
+		BlockStorage blocks(size.x * size.y * size.z, 1);
+		occupancy.Reset(blocks);
+
+		connectivity.Reset(occupancy);
+		CHECK(connectivity.IsSealed());
+
+		// Enclosed caves don't connect anything
+		for (unsigned int i = 8; i < 24; ++i)
+			occupancy.Set({ i, 16, 16 }, false);
+
+		connectivity.Reset(occupancy);
+		CHECK(connectivity.IsSealed());
+
+		// Tunnel going through the chunk along X
+		for (unsigned int x = 0; x < size.x; ++x)
+			occupancy.Set({ x, 3, 3 }, false);
+
+		connectivity.Reset(occupancy);
+		CHECK(connectivity.AreConnected(Direction::Left, Direction::Right));
+		CHECK_FALSE(connectivity.AreConnected(Direction::Left, Direction::Up));
+		CHECK_FALSE(connectivity.AreConnected(Direction::Front, Direction::Back));
+
+		// Bending tunnel
+		for (unsigned int z = 3; z < size.z; ++z)
+			occupancy.Set({ 20, 3, z }, false);
+
+		connectivity.Reset(occupancy);
+		CHECK(connectivity.AreConnected(Direction::Left, Direction::Up));
+		CHECK(connectivity.AreConnected(Direction::Up, Direction::Right));
+		CHECK_FALSE(connectivity.AreConnected(Direction::Up, Direction::Down));
+	}
+}
+
+TEST_CASE("Chunk visibility", "[Chunks]")
+{
+	// Chunks of the Y = 2 layer are solid, chunks without connectivity are considered empty
+	tsl::hopscotch_map<ChunkIndices, ChunkConnectivity> connectivities;
+	for (int z = 0; z < 5; ++z)
+	{
+		for (int x = 0; x < 5; ++x)
+			connectivities.emplace(ChunkIndices(x, 2, z), ChunkConnectivity(false));
+	}
+
+	auto GetConnectivity = [&](const ChunkIndices& chunkIndices) -> const ChunkConnectivity*
+	{
+		auto it = connectivities.find(chunkIndices);
+		if (it == connectivities.end())
+			return nullptr;
+
+		return &it->second;
+	};
+
+	ChunkVisibility visibility;
+	visibility.Compute({ 2, 4, 2 }, Nz::Boxi(0, 0, 0, 5, 5, 5), GetConnectivity);
+
+	CHECK(visibility.IsVisible({ 2, 4, 2 }));
+	CHECK(visibility.IsVisible({ 0, 3, 4 }));
+	CHECK(visibility.IsVisible({ 2, 2, 2 }));
+	CHECK_FALSE(visibility.IsVisible({ 2, 1, 2 }));
+	CHECK_FALSE(visibility.IsVisible({ 0, 0, 0 }));
+	CHECK_FALSE(visibility.IsVisible({ 5, 4, 2 }));
+	CHECK(visibility.GetVisibleChunkCount() == 5 * 5 * 3);
+
+	SECTION("Shaft through the solid layer")
+	{
+		ChunkConnectivity shaftConnectivity;
+		shaftConnectivity.Connect(Direction::Up, Direction::Down);
+		connectivities.insert_or_assign(ChunkIndices(2, 2, 2), shaftConnectivity);
+
+		visibility.Compute({ 2, 4, 2 }, Nz::Boxi(0, 0, 0, 5, 5, 5), GetConnectivity);
+		CHECK(visibility.IsVisible({ 2, 1, 2 }));
+		CHECK(visibility.IsVisible({ 0, 0, 0 }));
+
+		// The shaft doesn't lead sideways
+		shaftConnectivity = ChunkConnectivity(false);
+		shaftConnectivity.Connect(Direction::Up, Direction::Left);
+		connectivities.insert_or_assign(ChunkIndices(2, 2, 2), shaftConnectivity);
+
+		visibility.Compute({ 2, 4, 2 }, Nz::Boxi(0, 0, 0, 5, 5, 5), GetConnectivity);
+		CHECK_FALSE(visibility.IsVisible({ 2, 1, 2 }));
+	}
+
+	SECTION("Sight doesn't go back toward the viewer")
+	{
+		// Going down past the end of the solid layer and coming back under it would require to go back left
+		visibility.Compute({ 2, 4, 2 }, Nz::Boxi(0, 0, 0, 6, 5, 5), GetConnectivity);
+		CHECK(visibility.IsVisible({ 5, 1, 2 }));
+		CHECK_FALSE(visibility.IsVisible({ 4, 1, 2 }));
+		CHECK_FALSE(visibility.IsVisible({ 2, 1, 2 }));
+	}
+}
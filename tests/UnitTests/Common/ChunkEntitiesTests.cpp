@@ -0,0 +1,101 @@
+#include <CommonLib/BlockLibrary.hpp>
+#include <CommonLib/ChunkEntities.hpp>
+#include <CommonLib/Planet.hpp>
+#include <Nazara/Core/Application.hpp>
+#include <Nazara/Core/Core.hpp>
+#include <Nazara/Core/EnttWorld.hpp>
+#include <Nazara/Core/TaskSchedulerAppComponent.hpp>
+#include <Nazara/Core/Components/NodeComponent.hpp>
+#include <Nazara/Physics3D/Physics3D.hpp>
+#include <Nazara/Physics3D/Collider3D.hpp>
+#include <Nazara/Physics3D/Components/RigidBody3DComponent.hpp>
+#include <Nazara/Physics3D/Systems/Physics3DSystem.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <thread>
+
+using namespace tsom;
+
+TEST_CASE("Chunk entities collider residency", "[Physics]")
+{
+	Nz::Application<Nz::Core, Nz::Physics3D> app;
+	app.AddComponent<Nz::TaskSchedulerAppComponent>();
+
+	Nz::EnttWorld world;
+	world.AddSystem<Nz::Physics3DSystem>();
+
+	BlockLibrary blockLibrary;
+	BlockIndex dirtBlock = blockLibrary.GetBlockIndex("dirt");
+
+	Planet planet(1.f, 0.f, 9.81f);
+	ChunkEntities chunkEntities(app, world, planet, blockLibrary);
+
+	ChunkEntities::ColliderResidencySettings residencySettings;
+	residencySettings.enabled = true;
+	residencySettings.lookAhead = Nz::Time::Zero();
+	residencySettings.radius = 8.f;
+	residencySettings.releaseDelay = Nz::Time::Milliseconds(1);
+	chunkEntities.SetColliderResidencySettings(residencySettings);
+
+	// Chunk is added once residency is enabled, so it only gets a rigid body when a body comes close
+	planet.AddChunk({ 0, 0, 0 }, [&](BlockIndex* blocks)
+	{
+		for (unsigned int i = 0; i < Planet::ChunkSize * Planet::ChunkSize * Planet::ChunkSize; ++i)
+			*blocks++ = dirtBlock;
+	});
+
+	auto CountChunkBodies = [&]
+	{
+		std::size_t bodyCount = 0;
+		for (auto&& [entity, rigidBody] : world.GetRegistry().view<Nz::RigidBody3DComponent>().each())
+		{
+			if (rigidBody.IsStatic())
+				bodyCount++;
+		}
+
+		return bodyCount;
+	};
+
+	// Jobs are built by the task scheduler, keep updating until they are applied
+	auto UpdateUntilBodyCount = [&](std::size_t expectedBodyCount)
+	{
+		for (unsigned int i = 0; i < 1000 && CountChunkBodies() != expectedBodyCount; ++i)
+		{
+			chunkEntities.Update();
+			std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		}
+
+		return CountChunkBodies() == expectedBodyCount;
+	};
+
+	auto CreateBody = [&]
+	{
+		entt::handle bodyEntity = world.CreateEntity();
+		bodyEntity.emplace<Nz::NodeComponent>(Nz::Vector3f::Zero());
+		bodyEntity.emplace<Nz::RigidBody3DComponent>(Nz::RigidBody3D::DynamicSettings(std::make_shared<Nz::SphereCollider3D>(0.5f), 1.f));
+
+		return bodyEntity;
+	};
+
+	for (unsigned int i = 0; i < 10; ++i)
+		chunkEntities.Update();
+
+	CHECK(CountChunkBodies() == 0);
+	CHECK_FALSE(chunkEntities.HasColliderResidency({ 0, 0, 0 }));
+
+	entt::handle bodyEntity = CreateBody();
+	CHECK(UpdateUntilBodyCount(1));
+	CHECK(chunkEntities.HasColliderResidency({ 0, 0, 0 }));
+
+	// Chunk releases its collider once the body is gone
+	bodyEntity.destroy();
+	CHECK(UpdateUntilBodyCount(0));
+	CHECK_FALSE(chunkEntities.HasColliderResidency({ 0, 0, 0 }));
+
+	// and gets it back when a body comes close again
+	bodyEntity = CreateBody();
+	CHECK(UpdateUntilBodyCount(1));
+	CHECK(chunkEntities.HasColliderResidency({ 0, 0, 0 }));
+
+	bodyEntity.destroy();
+}
@@ -0,0 +1,79 @@
+#include <CommonLib/ChunkJobScheduler.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+
+using namespace tsom;
+
+TEST_CASE("Chunk job scheduler", "[Chunks]")
+{
+	ChunkJobScheduler scheduler(32.f, 2);
+
+	std::vector<ChunkIndices> executedTasks;
+	auto ScheduleTask = [&](const ChunkIndices& chunkIndices)
+	{
+		scheduler.Schedule(chunkIndices, [&executedTasks, chunkIndices] { executedTasks.push_back(chunkIndices); });
+	};
+
+	// Submitted tasks are run later on, as they would be by worker threads
+	std::vector<ChunkJobScheduler::Task> submittedTasks;
+	auto SubmitTask = [&](ChunkJobScheduler::Task&& task)
+	{
+		submittedTasks.push_back(std::move(task));
+	};
+
+	auto RunSubmittedTasks = [&]
+	{
+		for (ChunkJobScheduler::Task& task : submittedTasks)
+			task();
+
+		submittedTasks.clear();
+	};
+
+	for (int x = 0; x < 8; ++x)
+		ScheduleTask({ x, 0, 0 });
+
+	CHECK(scheduler.GetPendingTaskCount() == 8);
+
+	// Closest chunks go first, and no more tasks than allowed run at once
+	Nz::Vector3f viewerPosition(32.f * 5.f, 0.f, 0.f);
+	scheduler.Dispatch({ &viewerPosition, 1 }, SubmitTask);
+	CHECK(submittedTasks.size() == 2);
+	CHECK(scheduler.GetRunningTaskCount() == 2);
+	CHECK(scheduler.GetPendingTaskCount() == 6);
+
+	scheduler.Dispatch({ &viewerPosition, 1 }, SubmitTask);
+	CHECK(submittedTasks.size() == 2);
+
+	RunSubmittedTasks();
+	CHECK(scheduler.GetRunningTaskCount() == 0);
+	REQUIRE(executedTasks.size() == 2);
+	CHECK(executedTasks[0] == ChunkIndices(5, 0, 0));
+	CHECK((executedTasks[1] == ChunkIndices(4, 0, 0) || executedTasks[1] == ChunkIndices(6, 0, 0)));
+
+	// Pending tasks of a chunk can be dropped before they run (when it changed again)
+	scheduler.Cancel({ 7, 0, 0 });
+	CHECK(scheduler.GetPendingTaskCount() == 5);
+
+	// Moving viewers change priorities of pending tasks
+	executedTasks.clear();
+	viewerPosition = Nz::Vector3f::Zero();
+	scheduler.Dispatch({ &viewerPosition, 1 }, SubmitTask);
+	RunSubmittedTasks();
+	REQUIRE(executedTasks.size() == 2);
+	CHECK(executedTasks[0] == ChunkIndices(0, 0, 0));
+	CHECK(executedTasks[1] == ChunkIndices(1, 0, 0));
+
+	// Tasks of the same chunk are dispatched together
+	ScheduleTask({ -1, 0, 0 });
+	ScheduleTask({ -1, 0, 0 });
+	ScheduleTask({ -1, 0, 0 });
+
+	executedTasks.clear();
+	scheduler.Dispatch({ &viewerPosition, 1 }, SubmitTask);
+	CHECK(submittedTasks.size() == 3);
+	RunSubmittedTasks();
+	CHECK(executedTasks == std::vector<ChunkIndices>(3, ChunkIndices(-1, 0, 0)));
+
+	scheduler.Clear();
+	CHECK(scheduler.GetPendingTaskCount() == 0);
+}
@@ -0,0 +1,103 @@
+#include "GroundChunk.hpp"
+#include <CommonLib/BlockLibrary.hpp>
+#include <CommonLib/ChunkMeshCache.hpp>
+#include <CommonLib/Planet.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+
+using namespace tsom;
+
+TEST_CASE("Chunk mesh cache", "[Chunks]")
+{
+	BlockLibrary blockLibrary;
+	BlockIndex dirtBlock = blockLibrary.GetBlockIndex("dirt");
+
+	Planet planet(1.f, 0.f, 9.81f);
+
+	Chunk& chunk = AddGroundChunk(planet, { 0, 0, 0 }, dirtBlock);
+
+	Nz::Vector3f gravityCenter = planet.GetCenter() - planet.GetChunkOffset(chunk.GetIndices());
+
+	auto CheckSameMesh = [](const ChunkMeshCache& lhs, const ChunkMeshCache& rhs)
+	{
+		for (Direction direction : { Direction::Back, Direction::Down, Direction::Front, Direction::Left, Direction::Right, Direction::Up })
+		{
+			const std::vector<ChunkMeshVertex>& lhsVertices = lhs.GetVertices(direction);
+			const std::vector<ChunkMeshVertex>& rhsVertices = rhs.GetVertices(direction);
+			REQUIRE(lhsVertices.size() == rhsVertices.size());
+
+			bool isSameMesh = true;
+			for (std::size_t i = 0; i < lhsVertices.size(); ++i)
+			{
+				if (lhsVertices[i].position != rhsVertices[i].position || lhsVertices[i].normal != rhsVertices[i].normal || lhsVertices[i].uvw != rhsVertices[i].uvw)
+				{
+					isSameMesh = false;
+					break;
+				}
+			}
+			CHECK(isSameMesh);
+
+			CHECK(lhs.GetDirectionBounds().GetBounds(direction).faceCount == rhs.GetDirectionBounds().GetBounds(direction).faceCount);
+		}
+	};
+
+	SECTION("Incremental builds match full builds and reuse recycled storage")
+	{
+		for (bool greedyMeshing : { false, true })
+		{
+			INFO("Greedy meshing: " << greedyMeshing);
+
+			ChunkMeshCache fullCache(greedyMeshing);
+			REQUIRE(fullCache.Build(blockLibrary, chunk, chunk.TakeSnapshot(), gravityCenter, nullptr));
+			CHECK(fullCache.GetRebuiltBrickCount() == fullCache.GetBricks().size());
+			CHECK(fullCache.GetDirectionBounds().GetBounds(Direction::Up).faceCount > 0);
+
+			// Digging a block only remeshes its brick and the four neighbor bricks inside the chunk
+			Nz::Vector3ui digIndices(4, 4, GroundHeight - 1);
+			chunk.UpdateBlock(digIndices, EmptyBlockIndex);
+			ChunkSnapshot digSnapshot = chunk.TakeSnapshot();
+
+			ChunkMeshCache incrementalCache(greedyMeshing);
+			REQUIRE(incrementalCache.Build(blockLibrary, chunk, digSnapshot, gravityCenter, &fullCache));
+			CHECK(incrementalCache.GetRebuiltBrickCount() == 5);
+
+			ChunkMeshCache rebuiltCache(greedyMeshing);
+			REQUIRE(rebuiltCache.Build(blockLibrary, chunk, digSnapshot, gravityCenter, nullptr));
+			CheckSameMesh(incrementalCache, rebuiltCache);
+
+			// Mesh of the same size can be built again in the storage of a recycled cache without growing it
+			chunk.UpdateBlock(digIndices, dirtBlock);
+			ChunkSnapshot fillSnapshot = chunk.TakeSnapshot();
+
+			rebuiltCache.Reset(greedyMeshing);
+			REQUIRE(rebuiltCache.Build(blockLibrary, chunk, fillSnapshot, gravityCenter, nullptr));
+
+			fullCache.Reset(greedyMeshing);
+			REQUIRE(fullCache.Build(blockLibrary, chunk, fillSnapshot, gravityCenter, &incrementalCache));
+			CHECK(fullCache.GetStorageGrowthCount() == 0);
+			CheckSameMesh(fullCache, rebuiltCache);
+
+			// Fresh caches size their storage exactly once, regardless of how many bricks are meshed
+			ChunkMeshCache freshCache(greedyMeshing);
+			REQUIRE(freshCache.Build(blockLibrary, chunk, fillSnapshot, gravityCenter, &incrementalCache));
+			CheckSameMesh(freshCache, rebuiltCache);
+
+			std::size_t usedDirectionCount = 0;
+			for (Direction direction : { Direction::Back, Direction::Down, Direction::Front, Direction::Left, Direction::Right, Direction::Up })
+			{
+				if (!freshCache.GetVertices(direction).empty())
+					usedDirectionCount++;
+			}
+			CHECK(freshCache.GetStorageGrowthCount() == 1 + usedDirectionCount); //< bricks and the storage of each direction
+		}
+	}
+
+	SECTION("Cancelled builds stop early")
+	{
+		std::atomic_bool cancelled = true;
+
+		ChunkMeshCache cache;
+		CHECK_FALSE(cache.Build(blockLibrary, chunk, chunk.TakeSnapshot(), gravityCenter, nullptr, &cancelled));
+		CHECK(cache.GetRebuiltBrickCount() == 0);
+	}
+}
@@ -0,0 +1,171 @@
+#include <CommonLib/BlockLibrary.hpp>
+#include <CommonLib/ChunkMesher.hpp>
+#include <CommonLib/FlatChunk.hpp>
+#include <CommonLib/Planet.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <map>
+#include <utility>
+#include <vector>
+
+using namespace tsom;
+
+namespace
+{
+	struct MeshVertex
+	{
+		Nz::Vector3f position;
+		Nz::Vector3f normal;
+		Nz::Vector3f tangent;
+		Nz::Vector3f uvw;
+	};
+
+	struct MeshData
+	{
+		std::vector<Nz::UInt32> indices;
+		std::vector<MeshVertex> vertices;
+	};
+
+	void AppendFace(const ChunkMeshFace& face, MeshData& meshData)
+	{
+		Nz::UInt32 firstIndex = Nz::SafeCast<Nz::UInt32>(meshData.vertices.size());
+		for (std::size_t i = 0; i < face.positions.size(); ++i)
+		{
+			MeshVertex& vertex = meshData.vertices.emplace_back();
+			vertex.position = face.positions[i];
+			vertex.normal = face.normal;
+			vertex.tangent = face.tangent;
+			vertex.uvw = Nz::Vector3f(face.uvs[i], face.textureIndex);
+		}
+
+		for (Nz::UInt32 index : ChunkMesherBase::s_faceIndices)
+			meshData.indices.push_back(firstIndex + index);
+	}
+
+	bool ApproxEqual(const Nz::Vector3f& lhs, const Nz::Vector3f& rhs)
+	{
+		return lhs.SquaredDistance(rhs) < 0.0001f;
+	}
+}
+
+TEST_CASE("Chunk mesher", "[Chunks]")
+{
+	constexpr Nz::UInt32 Seed = 42;
+	Nz::Vector3ui chunkCount(3, 3, 3);
+
+	BlockLibrary blockLibrary;
+	Planet planet(1.f, 16.f, 9.81f);
+
+	for (int z = 0; z < int(chunkCount.z); ++z)
+	{
+		for (int y = 0; y < int(chunkCount.y); ++y)
+		{
+			for (int x = 0; x < int(chunkCount.x); ++x)
+			{
+				Chunk& chunk = planet.AddChunk(ChunkIndices(x, y, z) - ChunkIndices(chunkCount / 2));
+				planet.GenerateChunk(blockLibrary, chunk, Seed, chunkCount);
+			}
+		}
+	}
+
+	std::size_t meshedChunkCount = 0;
+	planet.ForEachChunk([&](const ChunkIndices& chunkIndices, const Chunk& chunk)
+	{
+		if (chunk.IsEmpty())
+			return;
+
+		INFO("Chunk: " << chunkIndices);
+
+		const FlatChunk& flatChunk = static_cast<const FlatChunk&>(chunk);
+		ChunkSnapshot snapshot = chunk.TakeSnapshot();
+		Nz::Vector3f gravityCenter = planet.GetCenter() - planet.GetChunkOffset(chunkIndices);
+		Nz::Boxui chunkBlocks(0, 0, 0, chunk.GetSize().x, chunk.GetSize().y, chunk.GetSize().z);
+
+		MeshData callbackMesh;
+		chunk.BuildMesh(blockLibrary, snapshot, callbackMesh.indices, gravityCenter, [&](Nz::UInt32 count)
+		{
+			Chunk::VertexAttributes vertexAttributes;
+
+			vertexAttributes.firstIndex = Nz::SafeCast<Nz::UInt32>(callbackMesh.vertices.size());
+			callbackMesh.vertices.resize(callbackMesh.vertices.size() + count);
+			vertexAttributes.position = Nz::SparsePtr<Nz::Vector3f>(&callbackMesh.vertices[vertexAttributes.firstIndex].position, sizeof(MeshVertex));
+			vertexAttributes.normal = Nz::SparsePtr<Nz::Vector3f>(&callbackMesh.vertices[vertexAttributes.firstIndex].normal, sizeof(MeshVertex));
+			vertexAttributes.tangent = Nz::SparsePtr<Nz::Vector3f>(&callbackMesh.vertices[vertexAttributes.firstIndex].tangent, sizeof(MeshVertex));
+			vertexAttributes.uv = Nz::SparsePtr<Nz::Vector3f>(&callbackMesh.vertices[vertexAttributes.firstIndex].uvw, sizeof(MeshVertex));
+
+			return vertexAttributes;
+		});
+
+		// Specialized mesher must output the same faces as Chunk::BuildMesh, in the same order
+		{
+			MeshData mesherMesh;
+			auto AddFace = [&](const ChunkMeshFace& face) { AppendFace(face, mesherMesh); };
+			ChunkMesher(flatChunk, blockLibrary, AddFace).BuildMesh(snapshot, chunkBlocks, gravityCenter);
+
+			CHECK(mesherMesh.indices == callbackMesh.indices);
+			REQUIRE(mesherMesh.vertices.size() == callbackMesh.vertices.size());
+
+			for (std::size_t i = 0; i < mesherMesh.vertices.size(); ++i)
+			{
+				const MeshVertex& mesherVertex = mesherMesh.vertices[i];
+				const MeshVertex& callbackVertex = callbackMesh.vertices[i];
+
+				CHECK(ApproxEqual(mesherVertex.position, callbackVertex.position));
+				CHECK(ApproxEqual(mesherVertex.normal, callbackVertex.normal));
+				CHECK(ApproxEqual(mesherVertex.tangent, callbackVertex.tangent));
+				CHECK(ApproxEqual(mesherVertex.uvw, callbackVertex.uvw));
+			}
+
+			// Face count pass must match exactly what gets meshed
+			CHECK(ChunkMesherBase::CountVisibleFaces(snapshot, chunkBlocks) * 4 == mesherMesh.vertices.size());
+		}
+
+		// Greedy meshing covers the same surface with fewer faces
+		{
+			// Merged faces can't be compared one to one, compare the surface covered by each direction and texture instead
+			using SurfaceKey = std::pair<Direction, float>;
+			std::map<SurfaceKey, float> greedySurfaces;
+			std::size_t greedyFaceCount = 0;
+			auto AddFace = [&](const ChunkMeshFace& face)
+			{
+				greedySurfaces[{ face.direction, face.textureIndex }] += (face.positions[1] - face.positions[0]).CrossProduct(face.positions[2] - face.positions[0]).GetLength();
+				greedyFaceCount++;
+			};
+			ChunkMesher(flatChunk, blockLibrary, AddFace).BuildGreedyMesh(snapshot, chunkBlocks, gravityCenter);
+
+			std::map<SurfaceKey, float> surfaces;
+			for (std::size_t i = 0; i < callbackMesh.vertices.size(); i += 4)
+			{
+				const MeshVertex* face = &callbackMesh.vertices[i];
+				surfaces[{ DirectionFromNormal(face[0].normal), face[0].uvw.z }] += (face[1].position - face[0].position).CrossProduct(face[2].position - face[0].position).GetLength();
+			}
+
+			REQUIRE(greedySurfaces.size() == surfaces.size());
+			for (auto&& [key, surface] : surfaces)
+			{
+				INFO("Direction: " << static_cast<int>(key.first) << ", texture: " << key.second);
+				CHECK(std::abs(greedySurfaces[key] - surface) < 0.01f);
+			}
+
+			CHECK(greedyFaceCount <= callbackMesh.vertices.size() / 4);
+
+			// Virtual greedy meshing goes through the same mesher
+			MeshData virtualGreedyMesh;
+			flatChunk.BuildGreedyMesh(blockLibrary, snapshot, chunkBlocks, virtualGreedyMesh.indices, gravityCenter, [&](Nz::UInt32 count)
+			{
+				Chunk::VertexAttributes vertexAttributes;
+
+				vertexAttributes.firstIndex = Nz::SafeCast<Nz::UInt32>(virtualGreedyMesh.vertices.size());
+				virtualGreedyMesh.vertices.resize(virtualGreedyMesh.vertices.size() + count);
+				vertexAttributes.position = Nz::SparsePtr<Nz::Vector3f>(&virtualGreedyMesh.vertices[vertexAttributes.firstIndex].position, sizeof(MeshVertex));
+
+				return vertexAttributes;
+			});
+			CHECK(virtualGreedyMesh.vertices.size() == greedyFaceCount * 4);
+		}
+
+		meshedChunkCount++;
+	});
+
+	CHECK(meshedChunkCount > 0);
+}
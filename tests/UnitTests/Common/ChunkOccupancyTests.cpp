@@ -0,0 +1,82 @@
+#include <CommonLib/BlockStorage.hpp>
+#include <CommonLib/ChunkOccupancy.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+
+using namespace tsom;
+
+TEST_CASE("Chunk occupancy", "[Chunks]")
+{
+	Nz::Vector3ui size(32, 32, 32);
+	ChunkOccupancy occupancy(size);
+
+	CHECK(occupancy.IsUniform());
+	CHECK(occupancy.GetColumn(0, { 0, 0, 0 }) == 0);
+	CHECK_FALSE(occupancy.IsOccupied({ 1, 2, 3 }));
+
+	SECTION("Setting blocks updates columns of all axis")
+	{
+		occupancy.Set({ 1, 2, 3 }, true);
+		CHECK_FALSE(occupancy.IsUniform());
+		CHECK(occupancy.IsOccupied({ 1, 2, 3 }));
+		CHECK(occupancy.GetColumn(0, { 0, 2, 3 }) == (1u << 1));
+		CHECK(occupancy.GetColumn(1, { 1, 0, 3 }) == (1u << 2));
+		CHECK(occupancy.GetColumn(2, { 1, 2, 0 }) == (1u << 3));
+		CHECK(occupancy.GetColumn(0, { 0, 3, 2 }) == 0);
+
+		occupancy.Set({ 1, 2, 3 }, false);
+		CHECK_FALSE(occupancy.IsOccupied({ 1, 2, 3 }));
+		CHECK(occupancy.GetColumn(2, { 1, 2, 0 }) == 0);
+	}
+
+	SECTION("Resetting from block storage")
+	{
+		BlockStorage blocks(size.x * size.y * size.z, 1);
+		occupancy.Reset(blocks);
+		CHECK(occupancy.IsUniform());
+		CHECK(occupancy.GetColumn(1, { 5, 0, 5 }) == 0xFFFFFFFF);
+
+		// Uniform occupancy is expanded when a block changes
+		occupancy.Set({ 0, 0, 31 }, false);
+		CHECK_FALSE(occupancy.IsUniform());
+		CHECK(occupancy.GetColumn(2, { 0, 0, 0 }) == 0x7FFFFFFF);
+		CHECK(occupancy.GetColumn(2, { 1, 0, 0 }) == 0xFFFFFFFF);
+
+		blocks.UpdateBlock(size.x * (size.y * 4 + 5) + 6, EmptyBlockIndex);
+		occupancy.Reset(blocks);
+		CHECK_FALSE(occupancy.IsOccupied({ 6, 5, 4 }));
+		CHECK(occupancy.IsOccupied({ 0, 0, 31 }));
+		CHECK(occupancy.GetColumn(0, { 0, 5, 4 }) == ~(1u << 6));
+		CHECK(occupancy.GetColumn(1, { 6, 0, 4 }) == ~(1u << 5));
+		CHECK(occupancy.GetColumn(2, { 6, 5, 0 }) == ~(1u << 4));
+	}
+
+	SECTION("Boxes can be merged through other blocks")
+	{
+		// Two blocks separated by a gap of blocks which don't need a box
+		std::vector<Nz::UInt32> xColumns(size.y * size.z, 0);
+		xColumns[0] = (1u << 0) | (1u << 3);
+		occupancy.Reset(xColumns);
+		CHECK(occupancy.IsOccupied({ 3, 0, 0 }));
+		CHECK(occupancy.GetColumn(1, { 3, 0, 0 }) == 1u);
+
+		ChunkOccupancy mergeableOccupancy(size);
+		for (unsigned int x = 0; x < 4; ++x)
+			mergeableOccupancy.Set({ x, 0, 0 }, true);
+
+		std::vector<Nz::Boxui> boxes;
+		occupancy.ComputeBoxes([&](const Nz::Boxui& box) { boxes.push_back(box); });
+		CHECK(boxes.size() == 2);
+
+		boxes.clear();
+		occupancy.ComputeBoxes(Nz::Boxui(Nz::Vector3ui::Zero(), size), mergeableOccupancy, [&](const Nz::Boxui& box) { boxes.push_back(box); });
+		REQUIRE(boxes.size() == 1);
+		CHECK(boxes[0] == Nz::Boxui(0, 0, 0, 4, 1, 1));
+
+		// Boxes don't leave the requested region
+		boxes.clear();
+		occupancy.ComputeBoxes(Nz::Boxui(2, 0, 0, 8, 8, 8), mergeableOccupancy, [&](const Nz::Boxui& box) { boxes.push_back(box); });
+		REQUIRE(boxes.size() == 1);
+		CHECK(boxes[0] == Nz::Boxui(3, 0, 0, 1, 1, 1));
+	}
+}
@@ -0,0 +1,118 @@
+#include <CommonLib/BlockLibrary.hpp>
+#include <CommonLib/ChunkStreamer.hpp>
+#include <CommonLib/Planet.hpp>
+#include <Nazara/Core/TaskScheduler.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <array>
+#include <chrono>
+#include <span>
+#include <thread>
+#include <vector>
+
+using namespace tsom;
+
+TEST_CASE("Chunk streaming", "[Generation]")
+{
+	constexpr Nz::UInt32 Seed = 42;
+	const Nz::Vector3ui chunkCount(3, 3, 3);
+
+	BlockLibrary blockLibrary;
+	Nz::TaskScheduler taskScheduler;
+
+	Planet referencePlanet(1.f, 16.f, 9.81f);
+	referencePlanet.GenerateChunks(blockLibrary, taskScheduler, Seed, chunkCount);
+
+	Planet planet(1.f, 16.f, 9.81f);
+	ChunkStreamer streamer(planet, blockLibrary, taskScheduler, Seed, chunkCount);
+
+	auto CheckChunks = [&]
+	{
+		planet.ForEachChunk([&](const ChunkIndices& chunkIndices, const Chunk& chunk)
+		{
+			const Chunk* referenceChunk = referencePlanet.GetChunk(chunkIndices);
+			REQUIRE(referenceChunk);
+
+			for (unsigned int blockIndex = 0; blockIndex < chunk.GetBlockCount(); ++blockIndex)
+				REQUIRE(chunk.GetBlockContent(blockIndex) == referenceChunk->GetBlockContent(blockIndex));
+		});
+	};
+
+	auto UpdateUntilIdle = [&](std::span<const Nz::Vector3f> viewerPositions)
+	{
+		for (unsigned int i = 0; i < 10'000; ++i)
+		{
+			streamer.Update(viewerPositions);
+			if (streamer.GetRequestedChunkCount() == 0)
+				break;
+
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	};
+
+	CHECK(streamer.IsInsidePlanet({ -1, 0, 1 }));
+	CHECK_FALSE(streamer.IsInsidePlanet({ 2, 0, 0 }));
+	CHECK_FALSE(streamer.IsInsidePlanet({ 0, -2, 0 }));
+
+	SECTION("Chunks are generated around viewers, a few at a time")
+	{
+		ChunkStreamer::Settings settings;
+		settings.maxRunningChunks = 4;
+		settings.maxStartedChunks = 2;
+		settings.viewRadius = 40.f;
+		streamer.SetSettings(settings);
+
+		// Viewer on the surface of the planet, only close chunks get generated
+		std::array viewerPositions = { Nz::Vector3f(0.f, 48.f, 0.f) };
+
+		streamer.Update(viewerPositions);
+		CHECK(planet.GetChunkCount() == 0); //< chunks are only published on the next updates
+		CHECK(streamer.GetRequestedChunkCount() == 2);
+
+		UpdateUntilIdle(viewerPositions);
+
+		CHECK(streamer.GetRunningChunkCount() == 0);
+		CHECK(planet.GetChunkCount() > 0);
+		CHECK(planet.GetChunkCount() < 27);
+		CHECK(planet.GetChunk({ 0, 1, 0 }));
+		CHECK_FALSE(planet.GetChunk({ 0, -1, 0 }));
+		CheckChunks();
+
+		// Moving far enough reaches the whole planet
+		settings.viewRadius = 1000.f;
+		streamer.SetSettings(settings);
+
+		UpdateUntilIdle(viewerPositions);
+
+		CHECK(planet.GetChunkCount() == 27);
+		CheckChunks();
+	}
+
+	SECTION("Chunks can be generated right away")
+	{
+		std::vector<ChunkIndices> chunkIndices = { { 0, 0, 0 }, { 1, 1, 1 }, { 5, 0, 0 } };
+		streamer.GenerateChunks(chunkIndices);
+
+		CHECK(planet.GetChunkCount() == 2); //< chunks outside of the planet are ignored
+		CHECK(streamer.GetRequestedChunkCount() == 0);
+		CheckChunks();
+	}
+
+	SECTION("Saved chunks are loaded instead of being generated")
+	{
+		streamer.SetLoadCallback([&](Chunk& chunk)
+		{
+			if (chunk.GetIndices() != ChunkIndices(0, 0, 0))
+				return false;
+
+			chunk.Fill(blockLibrary.GetBlockIndex("dirt"));
+			return true;
+		});
+
+		std::vector<ChunkIndices> chunkIndices = { { 0, 0, 0 }, { 0, 1, 0 } };
+		streamer.GenerateChunks(chunkIndices);
+
+		REQUIRE(planet.GetChunkCount() == 2);
+		CHECK(planet.GetChunk({ 0, 0, 0 })->GetBlockContent(0) == blockLibrary.GetBlockIndex("dirt"));
+		CHECK(planet.GetChunk({ 0, 1, 0 })->GetBlockContent(0) == referencePlanet.GetChunk({ 0, 1, 0 })->GetBlockContent(0));
+	}
+}
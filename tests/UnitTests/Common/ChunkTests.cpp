@@ -1,7 +1,14 @@
+#include <CommonLib/BlockLibrary.hpp>
 #include <CommonLib/Chunk.hpp>
 #include <CommonLib/ChunkContainer.hpp>
+#include <CommonLib/ChunkDirectionBounds.hpp>
+#include <CommonLib/ChunkLod.hpp>
+#include <CommonLib/ChunkMesher.hpp>
+#include <CommonLib/DeformedChunk.hpp>
+#include <CommonLib/FlatChunk.hpp>
 #include <CommonLib/Planet.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <algorithm>
 
 using namespace tsom;
 
@@ -44,3 +51,441 @@ TEST_CASE("Block positions", "[Chunks]")
 		}
 	}
 }
+
+TEST_CASE("Batched block updates", "[Chunks]")
+{
+	Planet planet(1.f, 0.f, 9.81f);
+	Chunk& chunk = planet.AddChunk({ 0, 0, 0 });
+	Chunk& neighborChunk = planet.AddChunk({ 1, 0, 0 });
+
+	std::size_t chunkUpdateCount = 0;
+	std::size_t neighborUpdateCount = 0;
+
+	NazaraSlot(ChunkContainer, OnChunkUpdated, onChunkUpdated);
+	onChunkUpdated.Connect(planet.OnChunkUpdated, [&](ChunkContainer*, Chunk* updatedChunk)
+	{
+		CHECK(updatedChunk == &chunk);
+		chunkUpdateCount++;
+	});
+
+	NazaraSlot(ChunkContainer, OnChunkNeighborUpdated, onChunkNeighborUpdated);
+	onChunkNeighborUpdated.Connect(planet.OnChunkNeighborUpdated, [&](ChunkContainer*, Chunk* updatedChunk, Direction neighborDirection)
+	{
+		CHECK(updatedChunk == &neighborChunk);
+		CHECK(neighborDirection == Direction::Left);
+		neighborUpdateCount++;
+	});
+
+	std::vector<Chunk::BlockUpdate> updates;
+	for (unsigned int z = 0; z < Planet::ChunkSize; ++z)
+	{
+		for (unsigned int y = 0; y < Planet::ChunkSize; ++y)
+		{
+			for (unsigned int x = 0; x < Planet::ChunkSize; ++x)
+				updates.push_back({ Nz::Vector3ui(x, y, z), BlockIndex(1 + (x + y + z) % 3) });
+		}
+	}
+
+	chunk.LockWrite();
+	chunk.UpdateBlocks(updates);
+	chunk.UnlockWrite();
+
+	CHECK(chunkUpdateCount == 1);
+	CHECK(neighborUpdateCount == 1);
+	CHECK(chunk.GetBlockContent({ 0, 0, 0 }) == 1);
+	CHECK(chunk.GetBlockContent({ 1, 2, 3 }) == 1);
+	CHECK(chunk.GetBlockContent({ 1, 1, 0 }) == 3);
+
+	// All blocks are occupied
+	bool isFullyOccupied = true;
+	for (unsigned int z = 0; z < Planet::ChunkSize; ++z)
+	{
+		for (unsigned int y = 0; y < Planet::ChunkSize; ++y)
+		{
+			if (chunk.GetOccupancy().GetColumn(0, { 0, y, z }) != 0xFFFFFFFF)
+				isFullyOccupied = false;
+		}
+	}
+	CHECK(isFullyOccupied);
+
+	// Neighbor lookup crosses chunk borders
+	CHECK(neighborChunk.GetNeighborBlock({ 0, 0, 0 }, { -1, 0, 0 }) == chunk.GetBlockContent({ Planet::ChunkSize - 1, 0, 0 }));
+	CHECK_FALSE(neighborChunk.GetNeighborBlock({ 0, 0, 0 }, { 0, -1, 0 }).has_value());
+}
+
+TEST_CASE("Chunk snapshots", "[Chunks]")
+{
+	Planet planet(1.f, 0.f, 9.81f);
+	Chunk& chunk = planet.AddChunk({ 0, 0, 0 });
+
+	chunk.UpdateBlock({ 1, 2, 3 }, 1);
+
+	ChunkSnapshot snapshot = chunk.TakeSnapshot();
+	CHECK(snapshot.IsUpToDate(chunk));
+	CHECK(snapshot.GetVersion() == chunk.GetContentVersion());
+	CHECK(snapshot.GetBlockContent({ 1, 2, 3 }) == 1);
+
+	SECTION("Writers don't modify existing snapshots")
+	{
+		chunk.UpdateBlock({ 1, 2, 3 }, 2);
+		CHECK(chunk.GetBlockContent({ 1, 2, 3 }) == 2);
+		CHECK(snapshot.GetBlockContent({ 1, 2, 3 }) == 1);
+		CHECK_FALSE(snapshot.IsUpToDate(chunk));
+		CHECK(snapshot.GetVersion() != chunk.GetContentVersion());
+	}
+
+	SECTION("Neighbor changes outdate snapshots")
+	{
+		Chunk& neighborChunk = planet.AddChunk({ 0, 1, 0 });
+		CHECK_FALSE(snapshot.IsUpToDate(chunk));
+
+		neighborChunk.UpdateBlock({ 0, 0, 0 }, 3);
+
+		ChunkSnapshot newSnapshot = chunk.TakeSnapshot();
+		CHECK(newSnapshot.IsUpToDate(chunk));
+		CHECK(newSnapshot.GetNeighborBlock({ 0, 0, Planet::ChunkSize - 1 }, { 0, 0, 1 }) == 3);
+
+		neighborChunk.UpdateBlock({ 0, 0, 0 }, 1);
+		CHECK_FALSE(newSnapshot.IsUpToDate(chunk));
+	}
+}
+
+TEST_CASE("Brick versions", "[Chunks]")
+{
+	Planet planet(1.f, 0.f, 9.81f);
+	Chunk& chunk = planet.AddChunk({ 0, 0, 0 });
+	Chunk& neighborChunk = planet.AddChunk({ 1, 0, 0 });
+
+	ChunkSnapshot snapshot = chunk.TakeSnapshot();
+	CHECK(snapshot.GetBrickGridSize() == Nz::Vector3ui(Planet::ChunkSize / ChunkContent::BrickSize));
+	CHECK(snapshot.GetNeighborBrickVersion({ 0, 0, 0 }, Direction::Left) == 0);
+	CHECK(snapshot.GetNeighborBrickVersion({ 3, 0, 0 }, Direction::Right) == neighborChunk.TakeSnapshot().GetBrickVersion({ 0, 0, 0 }));
+
+	chunk.UpdateBlock({ 9, 1, 1 }, 1);
+
+	// Only the brick containing the modified block changes
+	ChunkSnapshot newSnapshot = chunk.TakeSnapshot();
+	CHECK(newSnapshot.GetBrickVersion({ 1, 0, 0 }) == newSnapshot.GetVersion());
+	CHECK(newSnapshot.GetBrickVersion({ 0, 0, 0 }) == snapshot.GetBrickVersion({ 0, 0, 0 }));
+	CHECK(newSnapshot.GetBrickVersion({ 2, 0, 0 }) == snapshot.GetBrickVersion({ 2, 0, 0 }));
+	CHECK(newSnapshot.GetNeighborBrickVersion({ 0, 0, 0 }, Direction::Right) == newSnapshot.GetVersion());
+
+	Nz::Boxui brickBlocks = newSnapshot.GetBrickBlocks({ 1, 0, 0 });
+	CHECK(brickBlocks.x == 8);
+	CHECK(brickBlocks.width == ChunkContent::BrickSize);
+}
+
+TEST_CASE("Visible faces", "[Chunks]")
+{
+	Planet planet(1.f, 0.f, 9.81f);
+	Chunk& chunk = planet.AddChunk({ 0, 0, 0 });
+
+	chunk.UpdateBlock({ 4, 5, 0 }, 1);
+	chunk.UpdateBlock({ 4, 5, 1 }, 1);
+	chunk.UpdateBlock({ 4, 5, Planet::ChunkSize - 1 }, 1);
+
+	ChunkSnapshot snapshot = chunk.TakeSnapshot();
+	CHECK(snapshot.ComputeVisibleFaces(Direction::Up, { 4, 5, 0 }) == ((1u << 1) | (1u << (Planet::ChunkSize - 1))));
+	CHECK(snapshot.ComputeVisibleFaces(Direction::Down, { 4, 5, 0 }) == ((1u << 0) | (1u << (Planet::ChunkSize - 1))));
+	CHECK(snapshot.ComputeVisibleFaces(Direction::Left, { 0, 5, 0 }) == (1u << 4));
+	CHECK(snapshot.ComputeVisibleFaces(Direction::Back, { 4, 0, 1 }) == (1u << 5));
+	CHECK(snapshot.ComputeVisibleFaces(Direction::Up, { 5, 5, 0 }) == 0);
+
+	// Neighbor chunk blocks hide border faces
+	Chunk& upChunk = planet.AddChunk({ 0, 1, 0 });
+	upChunk.UpdateBlock({ 4, 5, 0 }, 1);
+
+	snapshot = chunk.TakeSnapshot();
+	CHECK(snapshot.ComputeVisibleFaces(Direction::Up, { 4, 5, 0 }) == (1u << 1));
+	CHECK(upChunk.TakeSnapshot().ComputeVisibleFaces(Direction::Down, { 4, 5, 0 }) == 0);
+}
+
+TEST_CASE("Surface occupancy", "[Chunks]")
+{
+	Planet planet(1.f, 0.f, 9.81f);
+
+	auto FillChunk = [](Chunk& chunk)
+	{
+		chunk.Reset([&](BlockIndex* blocks)
+		{
+			std::fill_n(blocks, chunk.GetBlockCount(), BlockIndex(1));
+		});
+	};
+
+	Chunk& chunk = planet.AddChunk({ 0, 0, 0 });
+	FillChunk(chunk);
+
+	// Without neighbors, every border block is exposed
+	ChunkOccupancy surface = chunk.TakeSnapshot().ComputeSurfaceOccupancy(1);
+	CHECK_FALSE(surface.IsUniform());
+	CHECK(surface.IsOccupied({ 0, 5, 5 }));
+	CHECK(surface.IsOccupied({ 5, 5, Planet::ChunkSize - 1 }));
+	CHECK_FALSE(surface.IsOccupied({ 1, 5, 5 }));
+	CHECK_FALSE(surface.IsOccupied({ 5, 5, 5 }));
+
+	ChunkOccupancy shell = chunk.TakeSnapshot().ComputeSurfaceOccupancy(2);
+	CHECK(shell.IsOccupied({ 1, 5, 5 }));
+	CHECK_FALSE(shell.IsOccupied({ 2, 5, 5 }));
+
+	// Buried chunks have no surface at all
+	for (const Nz::Vector3i& offset : s_blockDirOffsets)
+		FillChunk(planet.AddChunk(ChunkIndices(offset.x, offset.z, offset.y)));
+
+	CHECK(chunk.TakeSnapshot().ComputeSurfaceOccupancy(2).IsUniform());
+	CHECK_FALSE(chunk.TakeSnapshot().ComputeSurfaceOccupancy(2).IsOccupied({ 0, 0, 0 }));
+
+	// Mining a block exposes its neighbors
+	chunk.UpdateBlock({ 5, 5, 5 }, EmptyBlockIndex);
+
+	surface = chunk.TakeSnapshot().ComputeSurfaceOccupancy(1);
+	CHECK(surface.IsOccupied({ 4, 5, 5 }));
+	CHECK(surface.IsOccupied({ 5, 5, 6 }));
+	CHECK_FALSE(surface.IsOccupied({ 5, 5, 5 }));
+	CHECK_FALSE(surface.IsOccupied({ 3, 5, 5 }));
+}
+
+TEST_CASE("Deformed chunk lattice", "[Chunks]")
+{
+	Planet planet(1.f, 0.f, 9.81f);
+
+	Nz::Vector3ui chunkSize(8, 8, 8);
+	Nz::Vector3f deformationCenter(4.f, 4.f, 4.f);
+	DeformedChunk chunk(planet, { 0, 0, 0 }, chunkSize, 1.f, deformationCenter, 2.f);
+
+	auto CheckCorners = [&](const Nz::Vector3ui& blockIndices)
+	{
+		Nz::Boxf box(float(blockIndices.x), float(blockIndices.z), float(blockIndices.y), 1.f, 1.f, 1.f);
+		Nz::EnumArray<Nz::BoxCorner, Nz::Vector3f> corners = chunk.ComputeVoxelCorners(blockIndices);
+		for (auto&& [corner, position] : corners.iter_kv())
+		{
+			INFO("Block indices: " << blockIndices);
+			CHECK(position.SquaredDistance(chunk.DeformPosition(box.GetCorner(corner))) < 0.0001f);
+		}
+	};
+
+	// Lattice positions are the same as deforming each corner
+	CheckCorners({ 0, 0, 0 });
+	CheckCorners({ 3, 5, 1 });
+	CheckCorners({ 7, 7, 7 });
+
+	CHECK(chunk.GetLatticePosition({ 0, 0, 0 }) == chunk.ComputeVoxelCorners({ 0, 0, 0 })[Nz::BoxCorner::FarLeftBottom]);
+
+	// Changing the deformation rebuilds the lattice
+	Nz::Vector3f cornerPosition = chunk.GetLatticePosition({ 8, 8, 8 });
+	chunk.UpdateDeformationRadius(4.f);
+	CHECK(chunk.GetLatticePosition({ 8, 8, 8 }) != cornerPosition);
+	CheckCorners({ 7, 7, 7 });
+}
+
+TEST_CASE("Chunk level of detail", "[Chunks]")
+{
+	BlockLibrary blockLibrary;
+	Planet planet(1.f, 0.f, 9.81f);
+	Chunk& chunk = planet.AddChunk({ 0, 0, 0 });
+
+	auto CountFaces = [&](const ChunkLod& chunkLod)
+	{
+		std::size_t faceCount = 0;
+		chunkLod.BuildMesh(chunk, blockLibrary, planet.GetCenter(), [&](const ChunkMeshFace& /*face*/) { faceCount++; });
+		return faceCount;
+	};
+
+	// Ground made of 11 layers of blocks, topped by a single block of another type
+	chunk.Reset([&](BlockIndex* blocks)
+	{
+		for (unsigned int z = 0; z < Planet::ChunkSize; ++z)
+		{
+			for (unsigned int y = 0; y < Planet::ChunkSize; ++y)
+			{
+				for (unsigned int x = 0; x < Planet::ChunkSize; ++x)
+					blocks[chunk.GetBlockLocalIndex({ x, y, z })] = (z < 11) ? 1 : 0;
+			}
+		}
+	});
+	chunk.UpdateBlock({ 4, 4, 10 }, 2);
+	chunk.UpdateBlock({ 4, 5, 10 }, 2);
+	chunk.UpdateBlock({ 5, 4, 10 }, 2);
+
+	ChunkSnapshot snapshot = chunk.TakeSnapshot();
+
+	ChunkLod chunkLod(snapshot, 2);
+	CHECK(chunkLod.GetCellGridSize() == Nz::Vector3ui(Planet::ChunkSize / 2));
+
+	// Cells are solid as soon as one of their blocks is, and take their most common block
+	CHECK(chunkLod.GetCellContent({ 0, 0, 4 }) == 1);
+	CHECK(chunkLod.GetCellContent({ 0, 0, 5 }) == 1);
+	CHECK(chunkLod.GetCellContent({ 0, 0, 6 }) == 0);
+	CHECK(chunkLod.GetCellContent({ 2, 2, 5 }) == 2);
+
+	// Without neighbors, every border face is visible: the ground top, bottom and sides
+	constexpr std::size_t CellRow = Planet::ChunkSize / 2;
+	CHECK(CountFaces(chunkLod) == CellRow * CellRow * 2 + CellRow * 6 * 4);
+
+	// Coarser levels divide face count by the square of the factor
+	ChunkLod coarseLod(snapshot, 8);
+	CHECK(coarseLod.GetCellContent({ 0, 0, 1 }) == 1);
+	CHECK(CountFaces(coarseLod) == (Planet::ChunkSize / 8) * (Planet::ChunkSize / 8) * 2 + (Planet::ChunkSize / 8) * 2 * 4);
+
+	// Buried border faces are hidden, except for those of surface cells and the skirt below them
+	for (const Nz::Vector3i& offset : s_blockDirOffsets)
+	{
+		if (offset.z > 0)
+			continue;
+
+		Chunk& neighborChunk = planet.AddChunk(ChunkIndices(offset.x, offset.z, offset.y));
+		neighborChunk.Reset([&](BlockIndex* blocks)
+		{
+			std::fill_n(blocks, neighborChunk.GetBlockCount(), BlockIndex(1));
+		});
+	}
+
+	ChunkLod buriedLod(chunk.TakeSnapshot(), 2);
+	CHECK(CountFaces(buriedLod) == CellRow * CellRow + CellRow * 4 * 2);
+
+	// Skirts hang one cell below the surface cells, on the chunk border plane
+	Nz::Vector3f borderCellCorner = chunk.ComputeVoxelCorners({ 0, 0, 8 })[Nz::BoxCorner::FarLeftBottom];
+	bool hasSkirt = false;
+	buriedLod.BuildMesh(chunk, blockLibrary, planet.GetCenter(), [&](const ChunkMeshFace& face)
+	{
+		if (face.direction != Direction::Left)
+			return;
+
+		if (std::find(face.positions.begin(), face.positions.end(), borderCellCorner) != face.positions.end())
+			hasSkirt = true;
+	});
+	CHECK(hasSkirt);
+
+	// Reused ChunkLod give the same cells as new ones
+	chunkLod.Reset(chunk.TakeSnapshot(), 2);
+	CHECK(CountFaces(chunkLod) == CountFaces(buriedLod));
+
+	chunkLod.Clear();
+	CHECK(chunkLod.IsEmpty());
+}
+
+TEST_CASE("Chunk direction culling", "[Chunks]")
+{
+	BlockLibrary blockLibrary;
+	Planet planet(1.f, 0.f, 9.81f);
+
+	SECTION("Flat chunk")
+	{
+		Chunk& chunk = planet.AddChunk({ 0, 0, 0 });
+
+		// Ground made of 11 layers of blocks (world Y goes from -16 to -5)
+		chunk.Reset([&](BlockIndex* blocks)
+		{
+			for (unsigned int z = 0; z < Planet::ChunkSize; ++z)
+			{
+				for (unsigned int y = 0; y < Planet::ChunkSize; ++y)
+				{
+					for (unsigned int x = 0; x < Planet::ChunkSize; ++x)
+						blocks[chunk.GetBlockLocalIndex({ x, y, z })] = (z < 11) ? 1 : 0;
+				}
+			}
+		});
+
+		ChunkDirectionBounds directionBounds;
+		auto AddFace = [&](const ChunkMeshFace& face)
+		{
+			directionBounds.AddFace(face.direction, face.positions, face.normal);
+		};
+
+		const FlatChunk& flatChunk = static_cast<const FlatChunk&>(chunk);
+		ChunkMesher(flatChunk, blockLibrary, AddFace).BuildMesh(chunk.TakeSnapshot(), Nz::Boxui(0, 0, 0, Planet::ChunkSize, Planet::ChunkSize, Planet::ChunkSize), planet.GetCenter());
+
+		CHECK(directionBounds.GetBounds(Direction::Up).faceCount == Planet::ChunkSize * Planet::ChunkSize);
+		CHECK(directionBounds.GetBounds(Direction::Right).faceCount == Planet::ChunkSize * 11);
+		CHECK(directionBounds.GetBounds(Direction::Up).normalDeviation == 0.f);
+
+		auto GetVisibleDirections = [&](const Nz::Vector3f& viewerPosition)
+		{
+			std::vector<Direction> visibleDirections;
+			for (auto&& [direction, normal] : s_dirNormals.iter_kv())
+			{
+				if (!directionBounds.IsBackFacing(direction, viewerPosition))
+					visibleDirections.push_back(direction);
+			}
+
+			return visibleDirections;
+		};
+
+		// Only the ground top is seen from above, sides are also seen from past the chunk borders
+		CHECK(GetVisibleDirections({ 0.f, 50.f, 0.f }) == std::vector<Direction>{ Direction::Up });
+		CHECK((GetVisibleDirections({ 40.f, 50.f, 0.f }) == std::vector<Direction>{ Direction::Right, Direction::Up }));
+		CHECK((GetVisibleDirections({ -40.f, -10.f, -40.f }) == std::vector<Direction>{ Direction::Front, Direction::Left }));
+		CHECK(GetVisibleDirections({ 0.f, -40.f, 0.f }) == std::vector<Direction>{ Direction::Down });
+
+		// Viewers inside the ground don't see its top
+		CHECK(directionBounds.IsBackFacing(Direction::Up, { 0.f, -5.5f, 0.f }));
+		CHECK_FALSE(directionBounds.IsBackFacing(Direction::Up, { 0.f, -4.5f, 0.f }));
+	}
+
+	SECTION("Deformed chunk")
+	{
+		// Chunk sitting on top of a rounded planet edge
+		Nz::Vector3ui chunkSize(16, 16, 16);
+		DeformedChunk chunk(planet, { 0, 0, 0 }, chunkSize, 1.f, Nz::Vector3f(8.f, -24.f, 8.f), 20.f);
+		chunk.Reset([&](BlockIndex* blocks)
+		{
+			for (unsigned int i = 0; i < chunk.GetBlockCount(); ++i)
+				blocks[i] = (i % 7 < 3) ? 1 : 0;
+		});
+
+		ChunkDirectionBounds directionBounds;
+		Nz::EnumArray<Direction, std::vector<ChunkMeshFace>> faces;
+		auto AddFace = [&](const ChunkMeshFace& face)
+		{
+			directionBounds.AddFace(face.direction, face.positions, face.normal);
+			faces[face.direction].push_back(face);
+		};
+
+		ChunkMesher(chunk, blockLibrary, AddFace).BuildMesh(chunk.TakeSnapshot(), Nz::Boxui(0, 0, 0, chunkSize.x, chunkSize.y, chunkSize.z), planet.GetCenter());
+
+		CHECK(directionBounds.GetBounds(Direction::Up).normalDeviation > 0.f);
+
+		// Culled directions must only hold faces facing away from the viewer
+		auto IsFaceBackFacing = [](const ChunkMeshFace& face, const Nz::Vector3f& viewerPosition)
+		{
+			for (std::size_t i = 0; i < ChunkMesherBase::s_faceIndices.size(); i += 3)
+			{
+				const Nz::Vector3f& a = face.positions[ChunkMesherBase::s_faceIndices[i + 0]];
+				const Nz::Vector3f& b = face.positions[ChunkMesherBase::s_faceIndices[i + 1]];
+				const Nz::Vector3f& c = face.positions[ChunkMesherBase::s_faceIndices[i + 2]];
+
+				Nz::Vector3f triangleNormal = (b - a).CrossProduct(c - a);
+				if (triangleNormal.DotProduct(face.normal) < 0.f)
+					triangleNormal = -triangleNormal;
+
+				if ((a - viewerPosition).DotProduct(triangleNormal) < -0.0001f)
+					return false;
+			}
+
+			return true;
+		};
+
+		std::size_t culledDirectionCount = 0;
+		for (float x = -100.f; x <= 100.f; x += 20.f)
+		{
+			for (float y = -100.f; y <= 100.f; y += 20.f)
+			{
+				for (float z = -100.f; z <= 100.f; z += 20.f)
+				{
+					Nz::Vector3f viewerPosition(x, y, z);
+					for (auto&& [direction, directionFaces] : faces.iter_kv())
+					{
+						if (!directionBounds.IsBackFacing(direction, viewerPosition))
+							continue;
+
+						culledDirectionCount++;
+
+						INFO("Viewer position: " << viewerPosition);
+						CHECK(std::all_of(directionFaces.begin(), directionFaces.end(), [&](const ChunkMeshFace& face) { return IsFaceBackFacing(face, viewerPosition); }));
+					}
+				}
+			}
+		}
+
+		CHECK(culledDirectionCount > 0);
+	}
+}
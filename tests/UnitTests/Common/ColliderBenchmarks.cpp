@@ -0,0 +1,183 @@
+#include <CommonLib/BlockLibrary.hpp>
+#include <CommonLib/Chunk.hpp>
+#include <CommonLib/ChunkOccupancy.hpp>
+#include <CommonLib/Planet.hpp>
+#include <NazaraUtils/Bitset.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <optional>
+#include <vector>
+
+using namespace tsom;
+
+namespace
+{
+	struct BoxStats
+	{
+		std::size_t boxCount = 0;
+		std::size_t blockCount = 0;
+	};
+
+	// Previous FlatChunk::BuildCollider box merging, growing boxes block per block on a cell bitset
+	BoxStats ComputeBoxesPerBlock(const Chunk& chunk)
+	{
+		const Nz::Vector3ui& size = chunk.GetSize();
+
+		Nz::Bitset<Nz::UInt64> availableBlocks(chunk.GetBlockCount(), false);
+		for (unsigned int z = 0; z < size.z; ++z)
+		{
+			for (unsigned int y = 0; y < size.y; ++y)
+			{
+				for (unsigned int x = 0; x < size.x; ++x)
+					availableBlocks[chunk.GetBlockLocalIndex({ x, y, z })] = (chunk.GetBlockContent({ x, y, z }) != EmptyBlockIndex);
+			}
+		}
+
+		BoxStats stats;
+
+		std::optional<Nz::Vector3ui> startPos;
+		auto CommitBox = [&](unsigned int endX)
+		{
+			if (!startPos)
+				return;
+
+			unsigned int endY = startPos->y;
+			unsigned int endZ = startPos->z;
+
+			for (endY += 1; endY < size.y; ++endY)
+			{
+				bool canGrow = true;
+				for (unsigned int x = startPos->x; x <= endX && canGrow; ++x)
+					canGrow = availableBlocks[chunk.GetBlockLocalIndex({ x, endY, endZ })];
+
+				if (!canGrow)
+					break;
+			}
+			endY--;
+
+			for (endZ += 1; endZ < size.z; ++endZ)
+			{
+				bool canGrow = true;
+				for (unsigned int y = startPos->y; y <= endY && canGrow; ++y)
+				{
+					for (unsigned int x = startPos->x; x <= endX && canGrow; ++x)
+						canGrow = availableBlocks[chunk.GetBlockLocalIndex({ x, y, endZ })];
+				}
+
+				if (!canGrow)
+					break;
+			}
+			endZ--;
+
+			for (unsigned int z = startPos->z; z <= endZ; ++z)
+			{
+				for (unsigned int y = startPos->y; y <= endY; ++y)
+				{
+					for (unsigned int x = startPos->x; x <= endX; ++x)
+						availableBlocks[chunk.GetBlockLocalIndex({ x, y, z })] = false;
+				}
+			}
+
+			stats.boxCount++;
+			stats.blockCount += (endX - startPos->x + 1) * (endY - startPos->y + 1) * (endZ - startPos->z + 1);
+
+			startPos.reset();
+		};
+
+		for (unsigned int z = 0; z < size.z; ++z)
+		{
+			for (unsigned int y = 0; y < size.y; ++y)
+			{
+				for (unsigned int x = 0; x < size.x; ++x)
+				{
+					if (!availableBlocks[chunk.GetBlockLocalIndex({ x, y, z })])
+					{
+						CommitBox(x - 1);
+						continue;
+					}
+
+					if (!startPos)
+						startPos = { x, y, z };
+				}
+				CommitBox(size.x - 1);
+			}
+		}
+
+		return stats;
+	}
+
+	BoxStats ComputeBoxesPerRow(const Chunk& chunk)
+	{
+		BoxStats stats;
+		chunk.GetOccupancy().ComputeBoxes([&](const Nz::Boxui& blocks)
+		{
+			stats.boxCount++;
+			stats.blockCount += blocks.width * blocks.height * blocks.depth;
+		});
+
+		return stats;
+	}
+}
+
+TEST_CASE("Collider box merging", "[!benchmark][Chunks]")
+{
+	constexpr Nz::UInt32 Seed = 42;
+	Nz::Vector3ui chunkCount(5, 5, 5);
+
+	BlockLibrary blockLibrary;
+	Planet planet(1.f, 16.f, 9.81f);
+
+	// Only keep chunks containing terrain surface, uniform chunks are handled separately
+	std::vector<const Chunk*> surfaceChunks;
+	for (int z = 0; z < int(chunkCount.z); ++z)
+	{
+		for (int y = 0; y < int(chunkCount.y); ++y)
+		{
+			for (int x = 0; x < int(chunkCount.x); ++x)
+			{
+				Chunk& chunk = planet.AddChunk(ChunkIndices(x, y, z) - ChunkIndices(chunkCount / 2));
+				planet.GenerateChunk(blockLibrary, chunk, Seed, chunkCount);
+
+				if (!chunk.GetOccupancy().IsUniform())
+					surfaceChunks.push_back(&chunk);
+			}
+		}
+	}
+
+	REQUIRE(!surfaceChunks.empty());
+
+	BoxStats perBlockStats;
+	BoxStats perRowStats;
+	for (const Chunk* chunk : surfaceChunks)
+	{
+		BoxStats chunkPerBlockStats = ComputeBoxesPerBlock(*chunk);
+		BoxStats chunkPerRowStats = ComputeBoxesPerRow(*chunk);
+
+		// Both must cover every solid block exactly once
+		CHECK(chunkPerRowStats.blockCount == chunkPerBlockStats.blockCount);
+
+		perBlockStats.boxCount += chunkPerBlockStats.boxCount;
+		perRowStats.boxCount += chunkPerRowStats.boxCount;
+	}
+
+	INFO("per-block boxes: " << perBlockStats.boxCount << ", per-row boxes: " << perRowStats.boxCount);
+	CHECK(perRowStats.boxCount <= perBlockStats.boxCount);
+
+	BENCHMARK("Per-block box merging")
+	{
+		std::size_t boxCount = 0;
+		for (const Chunk* chunk : surfaceChunks)
+			boxCount += ComputeBoxesPerBlock(*chunk).boxCount;
+
+		return boxCount;
+	};
+
+	BENCHMARK("Occupancy row box merging")
+	{
+		std::size_t boxCount = 0;
+		for (const Chunk* chunk : surfaceChunks)
+			boxCount += ComputeBoxesPerRow(*chunk).boxCount;
+
+		return boxCount;
+	};
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#ifndef TSOM_UNITTESTS_GROUNDCHUNK_HPP
+#define TSOM_UNITTESTS_GROUNDCHUNK_HPP
+
+#include <CommonLib/Planet.hpp>
+
+namespace tsom
+{
+	// Ground level is in the middle of the second layer of bricks
+	constexpr unsigned int GroundHeight = 12;
+
+	// Adds a chunk filled with groundBlock up to GroundHeight (excluded) and empty above it
+	inline Chunk& AddGroundChunk(Planet& planet, const ChunkIndices& chunkIndices, BlockIndex groundBlock)
+	{
+		return planet.AddChunk(chunkIndices, [&](BlockIndex* blocks)
+		{
+			for (unsigned int z = 0; z < Planet::ChunkSize; ++z)
+			{
+				for (unsigned int y = 0; y < Planet::ChunkSize; ++y)
+				{
+					for (unsigned int x = 0; x < Planet::ChunkSize; ++x)
+						*blocks++ = (z < GroundHeight) ? groundBlock : EmptyBlockIndex;
+				}
+			}
+		});
+	}
+}
+
+#endif // TSOM_UNITTESTS_GROUNDCHUNK_HPP
@@ -0,0 +1,90 @@
+#include <CommonLib/HeightmapCache.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace tsom;
+
+TEST_CASE("Heightmap cache", "[Generation]")
+{
+	HeightmapCache cache;
+
+	unsigned int computeCount = 0;
+	auto ComputeHeights = [&](std::vector<double>& heights)
+	{
+		heights.assign(4, double(computeCount++));
+	};
+
+	// Tiles are computed once for their whole column and evicted once all its chunks acquired them
+	auto first = cache.Acquire(Direction::Up, { 1, 2 }, 3, ComputeHeights);
+	CHECK(cache.GetTileCount() == 1);
+
+	auto second = cache.Acquire(Direction::Up, { 1, 2 }, 3, ComputeHeights);
+	CHECK(first == second);
+	CHECK(computeCount == 1);
+
+	// Opposite faces and other columns have their own tiles
+	auto other = cache.Acquire(Direction::Down, { 1, 2 }, 3, ComputeHeights);
+	CHECK(other != first);
+	CHECK(computeCount == 2);
+	CHECK(cache.GetTileCount() == 2);
+
+	auto last = cache.Acquire(Direction::Up, { 1, 2 }, 3, ComputeHeights);
+	CHECK(last == first);
+	CHECK(cache.GetTileCount() == 1);
+	CHECK((*last == std::vector<double>(4, 0.0)));
+
+	cache.Clear();
+	CHECK(cache.GetTileCount() == 0);
+
+	SECTION("Least recently used tiles are evicted past the capacity")
+	{
+		HeightmapCache boundedCache(2);
+		CHECK(boundedCache.GetCapacity() == 2);
+
+		// Columns whose chunks are never all generated (streaming) don't pile up
+		auto first = boundedCache.Acquire(Direction::Up, { 0, 0 }, 4, ComputeHeights);
+		boundedCache.Acquire(Direction::Up, { 1, 0 }, 4, ComputeHeights);
+		boundedCache.Acquire(Direction::Up, { 0, 0 }, 4, ComputeHeights);
+		boundedCache.Acquire(Direction::Up, { 2, 0 }, 4, ComputeHeights);
+		CHECK(boundedCache.GetTileCount() == 2);
+
+		unsigned int previousComputeCount = computeCount;
+		CHECK(boundedCache.Acquire(Direction::Up, { 0, 0 }, 4, ComputeHeights) == first);
+		CHECK(computeCount == previousComputeCount);
+
+		// Evicted tiles are computed again
+		boundedCache.Acquire(Direction::Up, { 1, 0 }, 4, ComputeHeights);
+		CHECK(computeCount == previousComputeCount + 1);
+		CHECK(boundedCache.GetTileCount() == 2);
+	}
+
+	SECTION("Concurrent acquisitions")
+	{
+		constexpr unsigned int threadCount = 8;
+
+		std::atomic_uint concurrentComputeCount = 0;
+		std::vector<std::thread> threads;
+		for (unsigned int i = 0; i < threadCount; ++i)
+		{
+			threads.emplace_back([&]
+			{
+				auto heights = cache.Acquire(Direction::Left, { -3, 5 }, threadCount, [&](std::vector<double>& heights)
+				{
+					concurrentComputeCount++;
+					heights.assign(1024, 1.0);
+				});
+
+				// Each thread sees the tile fully computed
+				CHECK(heights->size() == 1024);
+			});
+		}
+
+		for (std::thread& thread : threads)
+			thread.join();
+
+		CHECK(concurrentComputeCount == 1);
+		CHECK(cache.GetTileCount() == 0);
+	}
+}
@@ -0,0 +1,45 @@
+#include <CommonLib/Utility/LruCache.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+
+using namespace tsom;
+
+TEST_CASE("LRU cache", "[Utility]")
+{
+	LruCache<int, std::string> cache(2);
+	CHECK(cache.Find(1) == nullptr);
+
+	cache.Insert(1, "one");
+	cache.Insert(2, "two");
+	REQUIRE(cache.Find(1));
+	CHECK(*cache.Find(1) == "one");
+
+	// 2 is now the least recently used entry
+	cache.Insert(3, "three");
+	CHECK(cache.GetSize() == 2);
+	CHECK(cache.Find(2) == nullptr);
+	REQUIRE(cache.Find(3));
+	CHECK(*cache.Find(3) == "three");
+
+	cache.Insert(1, "uno");
+	REQUIRE(cache.Find(1));
+	CHECK(*cache.Find(1) == "uno");
+
+	CHECK(cache.GetHitCount() == 6);
+	CHECK(cache.GetMissCount() == 2);
+
+	cache.SetCapacity(1);
+	CHECK(cache.GetSize() == 1);
+	CHECK(cache.Find(3) == nullptr);
+	CHECK(cache.Find(1) != nullptr);
+
+	cache.Erase(1);
+	cache.Erase(2); //< not in the cache
+	CHECK(cache.GetSize() == 0);
+	CHECK(cache.Find(1) == nullptr);
+
+	cache.Insert(1, "one");
+	cache.Clear();
+	CHECK(cache.GetSize() == 0);
+	CHECK(cache.Find(1) == nullptr);
+}
@@ -0,0 +1,152 @@
+#include <CommonLib/BlockLibrary.hpp>
+#include <CommonLib/ChunkMesher.hpp>
+#include <CommonLib/FlatChunk.hpp>
+#include <CommonLib/Planet.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+
+using namespace tsom;
+
+namespace
+{
+	struct MeshVertex
+	{
+		Nz::Vector3f position;
+		Nz::Vector3f normal;
+		Nz::Vector3f tangent;
+		Nz::Vector3f uvw;
+	};
+
+	struct MeshData
+	{
+		std::vector<Nz::UInt32> indices;
+		std::vector<MeshVertex> vertices;
+	};
+
+	// Mesh through Chunk::BuildMesh, calling back for every face
+	void BuildMeshWithCallback(const BlockLibrary& blockLibrary, const Chunk& chunk, const ChunkSnapshot& snapshot, const Nz::Vector3f& gravityCenter, MeshData& meshData)
+	{
+		auto AddVertices = [&](Nz::UInt32 count)
+		{
+			Chunk::VertexAttributes vertexAttributes;
+
+			vertexAttributes.firstIndex = Nz::SafeCast<Nz::UInt32>(meshData.vertices.size());
+			meshData.vertices.resize(meshData.vertices.size() + count);
+			vertexAttributes.position = Nz::SparsePtr<Nz::Vector3f>(&meshData.vertices[vertexAttributes.firstIndex].position, sizeof(MeshVertex));
+			vertexAttributes.normal = Nz::SparsePtr<Nz::Vector3f>(&meshData.vertices[vertexAttributes.firstIndex].normal, sizeof(MeshVertex));
+			vertexAttributes.tangent = Nz::SparsePtr<Nz::Vector3f>(&meshData.vertices[vertexAttributes.firstIndex].tangent, sizeof(MeshVertex));
+			vertexAttributes.uv = Nz::SparsePtr<Nz::Vector3f>(&meshData.vertices[vertexAttributes.firstIndex].uvw, sizeof(MeshVertex));
+
+			return vertexAttributes;
+		};
+
+		chunk.BuildMesh(blockLibrary, snapshot, meshData.indices, gravityCenter, AddVertices);
+	}
+
+	// Mesh through ChunkMesher, specialized for FlatChunk
+	void BuildMeshWithMesher(const BlockLibrary& blockLibrary, const FlatChunk& chunk, const ChunkSnapshot& snapshot, const Nz::Vector3f& gravityCenter, MeshData& meshData)
+	{
+		auto AddFace = [&](const ChunkMeshFace& face)
+		{
+			Nz::UInt32 firstIndex = Nz::SafeCast<Nz::UInt32>(meshData.vertices.size());
+			for (std::size_t i = 0; i < face.positions.size(); ++i)
+			{
+				MeshVertex& vertex = meshData.vertices.emplace_back();
+				vertex.position = face.positions[i];
+				vertex.normal = face.normal;
+				vertex.tangent = face.tangent;
+				vertex.uvw = Nz::Vector3f(face.uvs[i], face.textureIndex);
+			}
+
+			for (Nz::UInt32 index : ChunkMesherBase::s_faceIndices)
+				meshData.indices.push_back(firstIndex + index);
+		};
+
+		ChunkMesher(chunk, blockLibrary, AddFace).BuildMesh(snapshot, Nz::Boxui(0, 0, 0, chunk.GetSize().x, chunk.GetSize().y, chunk.GetSize().z), gravityCenter);
+	}
+
+}
+
+TEST_CASE("Chunk meshing", "[!benchmark][Chunks]")
+{
+	constexpr Nz::UInt32 Seed = 42;
+	Nz::Vector3ui chunkCount(5, 5, 5);
+
+	BlockLibrary blockLibrary;
+	Planet planet(1.f, 16.f, 9.81f);
+
+	struct ChunkData
+	{
+		const FlatChunk* chunk;
+		ChunkSnapshot snapshot;
+		Nz::Vector3f gravityCenter;
+	};
+
+	// Only keep chunks with visible faces
+	std::vector<ChunkData> surfaceChunks;
+	for (int z = 0; z < int(chunkCount.z); ++z)
+	{
+		for (int y = 0; y < int(chunkCount.y); ++y)
+		{
+			for (int x = 0; x < int(chunkCount.x); ++x)
+			{
+				Chunk& chunk = planet.AddChunk(ChunkIndices(x, y, z) - ChunkIndices(chunkCount / 2));
+				planet.GenerateChunk(blockLibrary, chunk, Seed, chunkCount);
+			}
+		}
+	}
+
+	planet.ForEachChunk([&](const ChunkIndices& chunkIndices, const Chunk& chunk)
+	{
+		if (chunk.IsEmpty())
+			return;
+
+		auto& chunkData = surfaceChunks.emplace_back();
+		chunkData.chunk = static_cast<const FlatChunk*>(&chunk);
+		chunkData.snapshot = chunk.TakeSnapshot();
+		chunkData.gravityCenter = planet.GetCenter() - planet.GetChunkOffset(chunkIndices);
+	});
+
+	REQUIRE(!surfaceChunks.empty());
+
+	// Both paths are checked to output the same faces by the chunk mesher test
+
+	BENCHMARK("Chunk::BuildMesh with vertex callback")
+	{
+		std::size_t vertexCount = 0;
+		for (const ChunkData& chunkData : surfaceChunks)
+		{
+			MeshData meshData;
+			BuildMeshWithCallback(blockLibrary, *chunkData.chunk, chunkData.snapshot, chunkData.gravityCenter, meshData);
+			vertexCount += meshData.vertices.size();
+		}
+
+		return vertexCount;
+	};
+
+	BENCHMARK("ChunkMesher<FlatChunk> with vertex sink")
+	{
+		std::size_t vertexCount = 0;
+		for (const ChunkData& chunkData : surfaceChunks)
+		{
+			MeshData meshData;
+			BuildMeshWithMesher(blockLibrary, *chunkData.chunk, chunkData.snapshot, chunkData.gravityCenter, meshData);
+			vertexCount += meshData.vertices.size();
+		}
+
+		return vertexCount;
+	};
+
+	BENCHMARK("ChunkMesher<FlatChunk> greedy meshing")
+	{
+		std::size_t faceCount = 0;
+		for (const ChunkData& chunkData : surfaceChunks)
+		{
+			auto CountFace = [&](const ChunkMeshFace& /*face*/) { faceCount++; };
+			ChunkMesher(*chunkData.chunk, blockLibrary, CountFace).BuildGreedyMesh(chunkData.snapshot, Nz::Boxui(0, 0, 0, chunkData.chunk->GetSize().x, chunkData.chunk->GetSize().y, chunkData.chunk->GetSize().z), chunkData.gravityCenter);
+		}
+
+		return faceCount;
+	};
+}
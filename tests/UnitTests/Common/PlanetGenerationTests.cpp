@@ -0,0 +1,134 @@
+#include <CommonLib/BlockLibrary.hpp>
+#include <CommonLib/Planet.hpp>
+#include <Nazara/Core/TaskScheduler.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+using namespace tsom;
+
+TEST_CASE("Chunk classification", "[Generation]")
+{
+	constexpr Nz::UInt32 Seed = 42;
+
+	BlockLibrary blockLibrary;
+	Nz::TaskScheduler taskScheduler;
+
+	Planet::GenerationStats totalStats;
+	for (unsigned int count = 1; count <= 8; ++count)
+	{
+		INFO("Chunk count: " << count);
+		Nz::Vector3ui chunkCount(count);
+
+		// Empty and layers only chunks skip most of the generation, this must not change their content
+		Planet planet(1.f, 16.f, 9.81f);
+		Planet::GenerationStats stats = planet.GenerateChunks(blockLibrary, taskScheduler, Seed, chunkCount);
+		CHECK(stats.emptyChunkCount + stats.layersOnlyChunkCount + stats.surfaceChunkCount == planet.GetChunkCount());
+
+		totalStats.emptyChunkCount += stats.emptyChunkCount;
+		totalStats.layersOnlyChunkCount += stats.layersOnlyChunkCount;
+		totalStats.surfaceChunkCount += stats.surfaceChunkCount;
+
+		Planet referencePlanet(1.f, 16.f, 9.81f);
+		planet.ForEachChunk([&](const ChunkIndices& chunkIndices, const Chunk& chunk)
+		{
+			Chunk& referenceChunk = referencePlanet.AddChunk(chunkIndices);
+			CHECK(referencePlanet.GenerateChunk(blockLibrary, referenceChunk, Seed, chunkCount, false) == Planet::GenerationPath::Surface);
+
+			INFO("Chunk: " << chunkIndices);
+
+			bool isSameContent = true;
+			for (unsigned int blockIndex = 0; blockIndex < chunk.GetBlockCount(); ++blockIndex)
+			{
+				if (chunk.GetBlockContent(blockIndex) != referenceChunk.GetBlockContent(blockIndex))
+				{
+					isSameContent = false;
+					break;
+				}
+			}
+			CHECK(isSameContent);
+		});
+	}
+
+	// Outer chunks of even chunk counts reach past the planet height and are empty, every path must have been compared
+	CHECK(totalStats.emptyChunkCount > 0);
+	CHECK(totalStats.layersOnlyChunkCount > 0);
+	CHECK(totalStats.surfaceChunkCount > 0);
+}
+
+TEST_CASE("Chunks above the surface are skipped", "[Generation]")
+{
+	constexpr Nz::UInt32 Seed = 42;
+
+	BlockLibrary blockLibrary;
+
+	for (unsigned int count = 2; count <= 8; count += 2)
+	{
+		INFO("Chunk count: " << count);
+		Nz::Vector3ui chunkCount(count);
+
+		// First chunk along each axis only has blocks in the free space or past the planet height
+		for (const ChunkIndices& chunkIndices : { ChunkIndices(-int(count / 2), 0, 0), ChunkIndices(0, -int(count / 2), 0), ChunkIndices(0, 0, -int(count / 2)) })
+		{
+			INFO("Chunk: " << chunkIndices);
+
+			Planet planet(1.f, 16.f, 9.81f);
+			Chunk& chunk = planet.AddChunk(chunkIndices);
+			CHECK(planet.GenerateChunk(blockLibrary, chunk, Seed, chunkCount) == Planet::GenerationPath::Empty);
+
+			Planet referencePlanet(1.f, 16.f, 9.81f);
+			Chunk& referenceChunk = referencePlanet.AddChunk(chunkIndices);
+			CHECK(referencePlanet.GenerateChunk(blockLibrary, referenceChunk, Seed, chunkCount, false) == Planet::GenerationPath::Surface);
+
+			bool isEmpty = true;
+			for (unsigned int blockIndex = 0; blockIndex < chunk.GetBlockCount(); ++blockIndex)
+			{
+				if (chunk.GetBlockContent(blockIndex) != EmptyBlockIndex || referenceChunk.GetBlockContent(blockIndex) != EmptyBlockIndex)
+				{
+					isEmpty = false;
+					break;
+				}
+			}
+			CHECK(isEmpty);
+		}
+	}
+}
+
+TEST_CASE("First generator version", "[Generation]")
+{
+	constexpr Nz::UInt32 Seed = 42;
+
+	BlockLibrary blockLibrary;
+	BlockIndex stoneBlock = blockLibrary.GetBlockIndex("stone");
+	BlockIndex stoneMossyBlock = blockLibrary.GetBlockIndex("stone_mossy");
+
+	// Worlds saved with the first generator version filled blocks past the planet height as deep layers, they must keep doing so
+	// (on smaller planets the surface passes carve them anyway)
+	Nz::Vector3ui chunkCount(4);
+	ChunkIndices chunkIndices(-2, 0, 0);
+
+	Planet planet(1.f, 16.f, 9.81f);
+	planet.SetGeneratorVersion(1);
+
+	Chunk& chunk = planet.AddChunk(chunkIndices);
+	CHECK(planet.GenerateChunk(blockLibrary, chunk, Seed, chunkCount) == Planet::GenerationPath::LayersOnly);
+
+	Planet referencePlanet(1.f, 16.f, 9.81f);
+	referencePlanet.SetGeneratorVersion(1);
+
+	Chunk& referenceChunk = referencePlanet.AddChunk(chunkIndices);
+	CHECK(referencePlanet.GenerateChunk(blockLibrary, referenceChunk, Seed, chunkCount, false) == Planet::GenerationPath::Surface);
+
+	bool isSameContent = true;
+	for (unsigned int blockIndex = 0; blockIndex < chunk.GetBlockCount(); ++blockIndex)
+	{
+		if (chunk.GetBlockContent(blockIndex) != referenceChunk.GetBlockContent(blockIndex))
+		{
+			isSameContent = false;
+			break;
+		}
+	}
+	CHECK(isSameContent);
+
+	// First block of the chunk is 16 blocks past the planet height
+	BlockIndex firstBlock = chunk.GetBlockContent(0);
+	CHECK((firstBlock == stoneBlock || firstBlock == stoneMossyBlock));
+}
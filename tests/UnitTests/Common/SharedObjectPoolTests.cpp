@@ -0,0 +1,68 @@
+#include <CommonLib/Utility/SharedObjectPool.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+
+using namespace tsom;
+
+TEST_CASE("Shared object pool", "[Utility]")
+{
+	struct Job
+	{
+		std::string name;
+		int value = 0;
+	};
+
+	SharedObjectPool<Job> pool(1);
+	CHECK(pool.GetFreeCount() == 0);
+
+	std::shared_ptr<Job> job = pool.Acquire();
+	job->name = "first";
+	job->value = 42;
+
+	Job* firstJob = job.get();
+	pool.Release(std::move(job));
+	CHECK(pool.GetFreeCount() == 1);
+
+	// Released jobs are constructed again when reused
+	job = pool.Acquire();
+	CHECK(job.get() == firstJob);
+	CHECK(job->name.empty());
+	CHECK(job->value == 0);
+	CHECK(pool.GetFreeCount() == 0);
+
+	// Jobs still held somewhere else (by a task) aren't reused
+	std::shared_ptr<Job> taskJob = job;
+	pool.Release(std::move(job));
+
+	std::shared_ptr<Job> otherJob = pool.Acquire();
+	CHECK(otherJob.get() != firstJob);
+	CHECK(pool.GetFreeCount() == 1);
+
+	taskJob.reset();
+	CHECK(pool.Acquire().get() == firstJob);
+
+	// Pool doesn't keep more jobs than its capacity
+	pool.Release(std::make_shared<Job>());
+	pool.Release(std::make_shared<Job>());
+	CHECK(pool.GetFreeCount() == 1);
+
+	// Releasing the same job twice only keeps it once
+	SharedObjectPool<Job> sharedPool(2);
+	std::shared_ptr<Job> sharedJob = std::make_shared<Job>();
+	sharedPool.Release(sharedJob);
+	sharedPool.Release(sharedJob);
+	CHECK(sharedPool.GetFreeCount() == 1);
+
+	// Recycle callback replaces the reconstruction, so objects keep what they own
+	std::shared_ptr<Job> recycledJob = pool.Acquire();
+	recycledJob->name = "recycled";
+	recycledJob->value = 42;
+
+	Job* recycledJobPtr = recycledJob.get();
+	pool.Release(std::move(recycledJob));
+
+	recycledJob = pool.Acquire([](Job& job) { job.value = 0; });
+	CHECK(recycledJob.get() == recycledJobPtr);
+	CHECK(recycledJob->name == "recycled");
+	CHECK(recycledJob->value == 0);
+}
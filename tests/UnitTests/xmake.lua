@@ -7,6 +7,6 @@ target("UnitTests", function ()
     end
 
     add_deps("CommonLib")
-    add_packages("catch2")
+    add_packages("catch2", "perlinnoise")
     add_files("**.cpp")
 end)